@@ -4,12 +4,24 @@
 #include "Audio_Impl.hpp"
 #include "AudioOutput.hpp"
 #include "DSP.hpp"
+#include <Shared/Profiling.hpp>
+#include <Shared/AllocationTracker.hpp>
 
 Audio* g_audio = nullptr;
 Audio_Impl impl;
 
 void Audio_Impl::Mix(float* data, uint32& numSamples)
 {
+	// Called from the audio output thread, which is named the first time it mixes
+	static thread_local bool threadNamed = false;
+	if(!threadNamed)
+	{
+		Profiler::SetThreadName("Audio");
+		threadNamed = true;
+	}
+	ProfileZone("Audio Mix");
+	AllocationScope allocationScope(AllocationTag::Audio);
+
 #if _DEBUG
 	static const uint32 guardBand = 1024;
 #else
@@ -77,7 +77,7 @@ public:
 		File file;
 		if(!file.OpenRead(path))
 			return false;
-		FileReader stream = FileReader(file);
+		BufferedFileReader stream(file);
 
 		WavHeader riff;
 		stream << riff;
@@ -40,6 +40,28 @@ struct BeatmapSettings
 	EffectType laserEffectType = EffectType::PeakingFilter;
 };
 
+/* Statistics about the objects in a beatmap, used to show, sort and filter maps without loading them */
+struct BeatmapAnalytics
+{
+	// Number of bins in the density histogram
+	static const uint32 densityBins = 32;
+
+	// Number of chips, hold notes and laser segments that are not connected to a previous segment
+	uint32 numButtons = 0;
+	uint32 numHolds = 0;
+	uint32 numLasers = 0;
+	// Highest number of objects starting within a single second
+	uint32 maxNotesPerSecond = 0;
+	double minBPM = 0.0;
+	double maxBPM = 0.0;
+	// Time at which the last object ends
+	MapTime duration = 0;
+	// Number of objects starting in each of equally long parts of the map
+	uint16 density[densityBins] = { 0 };
+
+	uint32 GetNumNotes() const { return numButtons + numHolds + numLasers; }
+};
+
 /*
 	Generic beatmap format, Can either load it's own format or KShoot maps
 */
@@ -71,6 +93,10 @@ public:
 	// Can contain multiple objects at the same time
 	const Vector<ZoomControlPoint*>& GetZoomControlPoints() const;
 
+	// Calculates statistics about the objects and timing points in the map
+	//	requires the map to be fully loaded
+	BeatmapAnalytics GetAnalytics() const;
+
 	// Retrieves audio effect settings for a given button id
 	AudioEffect GetEffect(EffectType type) const;
 	// Retrieves audio effect settings for a given filter effect id
@@ -10,7 +10,8 @@ public:
 	BeatmapPlayback() = default;
 	BeatmapPlayback(Beatmap& beatmap);
 
-	// Resets the playback of the map
+	// Resets the playback of the map and seeks to the given start time
+	// objects that started before the start time but are still active are entered again on the next update
 	// Must be called before any other function is called on this object
 	// returns false if the map contains no objects or timing or otherwise invalid
 	bool Reset(MapTime startTime = 0);
@@ -21,7 +22,7 @@ public:
 	void Update(MapTime newTime);
 
 	// Modifyable array of all hittable objects, within -+'hittableObjectTreshold' of current time
-	Set<ObjectState*>& GetHittableObjects();
+	FlatHashSet<ObjectState*>& GetHittableObjects();
 	MapTime hittableObjectTreshold = 100;
 
 	// Gets all linear objects that fall within the given time range:
@@ -93,6 +94,20 @@ private:
 	ObjectState** m_SelectHitObject(MapTime time, bool allowReset = false);
 	ZoomControlPoint** m_SelectZoomObject(MapTime time);
 
+	// Builds the cumulative view distance table for the current timing points
+	void m_BuildViewDistanceTable();
+	// Builds the index used to find objects that are still active at a given time
+	void m_BuildObjectIntervalIndex();
+	// Adds all objects before 'endIndex' that have not ended yet at the given time to 'out'
+	void m_GetObjectsActiveAt(MapTime time, size_t endIndex, Vector<ObjectState*>& out) const;
+	// Adds an object to the hittable objects and notifies listeners
+	void m_EnterObject(ObjectState* obj);
+	// Index of the timing point that is active at the given time
+	// times before the first timing point map to the first timing point
+	size_t m_FindTimingPointIndex(MapTime time) const;
+	// View distance from the first timing point to the given time
+	double m_TimeToAbsoluteViewDistance(MapTime time) const;
+
 	// End object pointer, this is not a valid pointer, but points to the element after the last element
 	bool IsEndTiming(TimingPoint** obj);
 	bool IsEndObject(ObjectState** obj);
@@ -105,6 +120,21 @@ private:
 	Vector<ZoomControlPoint*> m_zoomPoints;
 	bool m_initialEffectStateSent = false;
 
+	// View distance at the start of every timing point, relative to the first timing point
+	Vector<double> m_timingViewDistance;
+	// View distance of the current playback time, updated along with it
+	double m_playbackViewDistance = 0.0;
+
+	// Highest end time of the objects up to and including the object at the same index
+	// since objects are sorted by start time this is used to limit the search for objects that span over a given time
+	Vector<MapTime> m_objectEndTimes;
+	// Event objects sorted by time, per event key
+	Map<EventKey, Vector<EventObjectState*>> m_eventObjects;
+	// Objects that were still active at the time passed to Reset, these are entered on the next update
+	Vector<ObjectState*> m_seekObjects;
+	// Timing point index found by the last lookup, checked first since lookups are usually close together
+	mutable size_t m_timingPointHint = 0;
+
 	TimingPoint** m_currentTiming = nullptr;
 	ObjectState** m_currentObj = nullptr;
 	ZoomControlPoint** m_currentZoomPoint = nullptr;
@@ -114,11 +144,13 @@ private:
 	ZoomControlPoint* m_zoomEndPoints[2] = { nullptr };
 
 	// Contains all the objects that are in the current valid timing area
-	Set<ObjectState*> m_hittableObjects;
+	FlatHashSet<ObjectState*> m_hittableObjects;
 	// Hold objects to render even when their start time is not in the current visibility range
-	Set<ObjectState*> m_holdObjects;
+	FlatHashSet<ObjectState*> m_holdObjects;
 	// Hold buttons with effects that are active
-	Set<ObjectState*> m_effectObjects;
+	FlatHashSet<ObjectState*> m_effectObjects;
+	// Objects handled by the current update, sorted in chart order
+	Vector<ObjectState*> m_updateObjects;
 
 	// Current state of events
 	Map<EventKey, EventData> m_eventMapping;
@@ -14,10 +14,12 @@ public:
 	void Finish();
 	int32 IntColumn(int32 index = 0) const;
 	int64 Int64Column(int32 index = 0) const;
+	double DoubleColumn(int32 index = 0) const;
 	String StringColumn(int32 index = 0) const;
 	Buffer BlobColumn(int32 index = 0) const;
 	void BindInt(int32 index, const int32& value);
 	void BindInt64(int32 index, const int64& value);
+	void BindDouble(int32 index, const double& value);
 	void BindString(int32 index, const String& value);
 	void BindBlob(int32 index, const Buffer& value);
 	int32 ColumnCount() const;
@@ -45,6 +47,13 @@ public:
 	DBStatement Query(const String& queryString);
 	bool Exec(const String& queryString);
 	bool ExecDirect(const String& queryString);
+	// Returns a statement that stays compiled until the database is closed, for statements that are run often
+	//	the statement is rewound after it is used, bound values need to be set again before every use
+	DBStatement& GetCachedStatement(const String& queryString);
 
 	struct sqlite3* db = nullptr;
+
+private:
+	// Compiled statements by their query string
+	Map<String, DBStatement*> m_statementCache;
 };
@@ -1,6 +1,24 @@
 #pragma once
 #include "Beatmap.hpp"
 
+// Metadata of a difficulty that is used to display it
+//	the strings are stored in the string pool of the map database
+struct DifficultyMetadata
+{
+	const char* title;
+	const char* artist;
+	const char* effector;
+	const char* illustrator;
+	// Paths relative to the map folder
+	const char* jacketPath;
+	const char* audioNoFX;
+	MapTime previewOffset;
+	uint8 level;
+	uint8 difficulty;
+	// Statistics about the objects in the chart, these are also stored in indexed columns of the Difficulties table
+	BeatmapAnalytics analytics;
+};
+
 // Single difficulty of a map
 // a single map may contain multiple difficulties
 struct DifficultyIndex
@@ -9,12 +27,23 @@ struct DifficultyIndex
 	int32 id;
 	// Id of the map that contains this difficulty
 	int32 mapId;
-	// Full path to the difficulty
-	String path;
+	// Map that contains this difficulty
+	struct MapIndex* map;
+	// File name of the difficulty, relative to the map folder
+	const char* fileName;
 	// Last time the difficulty changed
 	uint64 lwt;
+	// Hash of the contents of the chart file
+	//	unlike the path or last write time this stays the same when the file is copied or touched, so it identifies the chart
+	uint64 hash;
 	// Map metadata
-	BeatmapSettings settings;
+	//	only available after MapDatabase::LoadMetadata for maps that were loaded from the database
+	DifficultyMetadata metadata;
+	// Set when metadata is available
+	bool metadataLoaded;
+
+	// Full path to the difficulty
+	String GetPath() const;
 };
 
 // Map located in database
@@ -24,7 +53,7 @@ struct MapIndex
 	// Id of this map
 	int32 id;
 	// Full path to the map root folder
-	String path;
+	const char* path;
 	// List of difficulties contained within the map
 	Vector<DifficultyIndex*> difficulties;
 };
@@ -32,21 +61,45 @@ struct MapIndex
 class MapDatabase : public Unique
 {
 public:
-	MapDatabase();
+	// Opens or creates the database at the given path
+	MapDatabase(const String& databasePath = "maps.db");
 	~MapDatabase();
 
 	// Checks the background scanning and actualized the current map database
+	// also adds the maps that are being loaded from the database, these are passed to OnMapsAdded in small pages
+	//	changes are written to the database on a separate thread, only a limited number of them is applied per call
 	void Update();
 
+	// Returns true until all maps are loaded from the database
+	bool IsLoading() const;
+	// Returns the total number of maps, including those that are still being loaded
+	size_t GetMapCount() const;
+	// Reads the metadata for all difficulties of a map, this is done lazily for maps loaded from the database
+	//	call this before accessing the metadata of difficulties, for example when a map is shown
+	void LoadMetadata(MapIndex* map);
+
+	// Returns true while searching or while the changes that were found are not passed to the delegates yet
 	bool IsSearching() const;
 	void StartSearching();
 	void StopSearching();
+	// Returns true if all maps have been scanned and changes to the search paths are being watched
+	//	Update then picks up changed files without having to search again
+	bool IsWatching() const;
+
+	// Sets the number of threads used to read map metadata while searching
+	//	0 uses one thread per hardware thread
+	void SetScanThreadCount(uint32 numThreads);
 
 	// Grab all the maps, with their id's
 	Map<int32, MapIndex*> GetMaps();
 	// Finds maps using the search query provided
-	// search artist/title/tags for maps for any space separated terms
+	// search artist/title/effector/tags for maps for any space separated terms
 	Map<int32, MapIndex*> FindMaps(const String& search);
+	// Same as FindMaps but runs on a separate thread, the result is passed to OnFoundMaps when calling Update
+	//	only the result of the latest search is passed, older searches are discarded
+	void FindMapsAsync(const String& search);
+	// Returns true if the result of the last call to FindMapsAsync has not been passed to OnFoundMaps yet
+	bool IsFindingMaps() const;
 	MapIndex* GetMap(int32 idx);
 
 	void AddSearchPath(const String& path);
@@ -58,6 +111,9 @@ public:
 	Delegate<Vector<MapIndex*>> OnMapsAdded;
 	// (mapId, mapIndex)
 	Delegate<Vector<MapIndex*>> OnMapsUpdated;
+	// Called with the result of FindMapsAsync
+	// (foundMaps)
+	Delegate<Map<int32, MapIndex*>> OnFoundMaps;
 	// Called when all maps are cleared
 	// (newMapList)
 	Delegate<Map<int32, MapIndex*>> OnMapsCleared;
@@ -3,6 +3,7 @@
 #include "Shared/Profiling.hpp"
 
 static const uint32 c_mapVersion = 1;
+static const uint32 c_mapMagic = *(uint32*)"FXMM";
 
 Beatmap::~Beatmap()
 {
@@ -40,10 +41,19 @@ bool Beatmap::Load(BinaryStream& input, bool metadataOnly)
 {
 	ProfilerScope $("Load Beatmap");
 
+	// Binary maps start with a magic number, the ksh parser could accept their data as an empty map
+	//	the stream does not have to be at its beginning, so it is returned to where the map starts
+	size_t start = input.Tell();
+	uint32 magic = 0;
+	input.SerializeBytes(&magic, sizeof(magic));
+	input.Seek(start);
+	if(magic == c_mapMagic)
+		return m_Serialize(input, metadataOnly);
+
 	if(!m_ProcessKShootMap(input, metadataOnly)) // Load KSH format first
 	{
 		// Load binary map format
-		input.Seek(0);
+		input.Seek(start);
 		if(!m_Serialize(input, metadataOnly))
 			return false;
 	}
@@ -74,6 +84,76 @@ const Vector<ZoomControlPoint*>& Beatmap::GetZoomControlPoints() const
 {
 	return m_zoomControlPoints;
 }
+BeatmapAnalytics Beatmap::GetAnalytics() const
+{
+	BeatmapAnalytics analytics;
+
+	// Start times of the objects that count as notes, these are already sorted
+	Vector<MapTime> noteTimes;
+	noteTimes.reserve(m_objectStates.size());
+	for(ObjectState* obj : m_objectStates)
+	{
+		MultiObjectState* mobj = (MultiObjectState*)obj;
+		MapTime endTime = mobj->time;
+		// Connected hold and laser segments only count once
+		bool isNote = true;
+		if(mobj->type == ObjectType::Single)
+		{
+			analytics.numButtons++;
+		}
+		else if(mobj->type == ObjectType::Hold)
+		{
+			endTime += mobj->hold.duration;
+			isNote = mobj->hold.prev == nullptr;
+			if(isNote)
+				analytics.numHolds++;
+		}
+		else if(mobj->type == ObjectType::Laser)
+		{
+			endTime += mobj->laser.duration;
+			isNote = mobj->laser.prev == nullptr;
+			if(isNote)
+				analytics.numLasers++;
+		}
+		else
+		{
+			continue;
+		}
+		analytics.duration = Math::Max(analytics.duration, endTime);
+		if(isNote)
+			noteTimes.Add(mobj->time);
+	}
+
+	// Notes per second, using a window that slides over the notes
+	size_t windowStart = 0;
+	for(size_t i = 0; i < noteTimes.size(); i++)
+	{
+		while(noteTimes[i] - noteTimes[windowStart] >= 1000)
+			windowStart++;
+		analytics.maxNotesPerSecond = Math::Max(analytics.maxNotesPerSecond, (uint32)(i - windowStart + 1));
+	}
+
+	// Downsampled density
+	if(analytics.duration > 0)
+	{
+		for(MapTime time : noteTimes)
+		{
+			uint32 bin = (uint32)((int64)Math::Max(time, 0) * BeatmapAnalytics::densityBins / (analytics.duration + 1));
+			uint16& count = analytics.density[Math::Min(bin, BeatmapAnalytics::densityBins - 1)];
+			if(count < UINT16_MAX)
+				count++;
+		}
+	}
+
+	for(size_t i = 0; i < m_timingPoints.size(); i++)
+	{
+		double bpm = m_timingPoints[i]->GetBPM();
+		analytics.minBPM = (i == 0) ? bpm : Math::Min(analytics.minBPM, bpm);
+		analytics.maxBPM = (i == 0) ? bpm : Math::Max(analytics.maxBPM, bpm);
+	}
+
+	return analytics;
+}
 
 AudioEffect Beatmap::GetEffect(EffectType type) const
 {
@@ -193,8 +273,7 @@ BinaryStream& operator<<(BinaryStream& stream, BeatmapSettings& settings)
 }
 bool Beatmap::m_Serialize(BinaryStream& stream, bool metadataOnly)
 {
-	static const uint32 c_magic = *(uint32*)"FXMM";
-	uint32 magic = c_magic;
+	uint32 magic = c_mapMagic;
 	uint32 version = c_mapVersion;
 	stream << magic;
 	stream << version;
@@ -202,7 +281,7 @@ bool Beatmap::m_Serialize(BinaryStream& stream, bool metadataOnly)
 	// Validate headers when reading
 	if(stream.IsReading())
 	{
-		if(magic != c_magic)
+		if(magic != c_mapMagic)
 		{
 			Log("Invalid map format", Logger::Warning);
 			return false;
@@ -2,15 +2,26 @@
 #include "BeatmapPlayback.hpp"
 #include "Shared/Profiling.hpp"
 
-BeatmapPlayback::BeatmapPlayback(Beatmap& beatmap) : m_beatmap(&beatmap)
+// Time at which an object stops being active
+static MapTime GetObjectEndTime(const MultiObjectState* obj)
 {
+	if(obj->type == ObjectType::Hold)
+		return obj->time + obj->hold.duration;
+	if(obj->type == ObjectType::Laser)
+		return obj->time + obj->laser.duration;
+	return obj->time;
 }
-bool BeatmapPlayback::Reset(MapTime startTime)
+
+BeatmapPlayback::BeatmapPlayback(Beatmap& beatmap) : m_beatmap(&beatmap)
 {
-	m_effectObjects.clear();
 	m_timingPoints = m_beatmap->GetLinearTimingPoints();
 	m_objects = m_beatmap->GetLinearObjects();
 	m_zoomPoints = m_beatmap->GetZoomControlPoints();
+	m_BuildViewDistanceTable();
+	m_BuildObjectIntervalIndex();
+}
+bool BeatmapPlayback::Reset(MapTime startTime)
+{
 	if(m_objects.size() == 0)
 		return false;
 	if(m_timingPoints.size() == 0)
@@ -18,12 +29,53 @@ bool BeatmapPlayback::Reset(MapTime startTime)
 
 	Logf("Reseting BeatmapPlayback with StartTime = %d", Logger::Info, startTime);
 	m_playbackTime = startTime;
-	m_currentObj = &m_objects.front();
-	m_currentTiming = &m_timingPoints.front();
-	m_currentZoomPoint = m_zoomPoints.empty() ? nullptr : &m_zoomPoints.front();
+	m_playbackViewDistance = m_TimeToAbsoluteViewDistance(m_playbackTime);
+	m_currentTiming = &m_timingPoints[m_FindTimingPointIndex(startTime)];
 
+	m_effectObjects.clear();
 	m_hittableObjects.clear();
 	m_holdObjects.clear();
+	m_seekObjects.clear();
+
+	// Skip all objects that would have already passed at the start time
+	MapTime objectPassTime = startTime - hittableObjectTreshold;
+	size_t firstObject = std::lower_bound(m_objects.begin(), m_objects.end(), objectPassTime,
+		[](const ObjectState* obj, MapTime t) { return obj->time < t; }) - m_objects.begin();
+	m_currentObj = &m_objects.front() + firstObject;
+	m_GetObjectsActiveAt(objectPassTime, firstObject, m_seekObjects);
+
+	// Restore the values set by events that were skipped
+	m_eventMapping.clear();
+	for(auto& events : m_eventObjects)
+	{
+		auto it = std::lower_bound(events.second.begin(), events.second.end(), objectPassTime,
+			[](const EventObjectState* evt, MapTime t) { return evt->time < t; });
+		if(it != events.second.begin())
+			m_eventMapping[events.first] = (*(it - 1))->data;
+	}
+
+	// Select the last passed and next zoom point for both the top and bottom zoom
+	m_zoomStartPoints[0] = m_zoomStartPoints[1] = nullptr;
+	m_zoomEndPoints[0] = m_zoomEndPoints[1] = nullptr;
+	m_currentZoomPoint = nullptr;
+	if(!m_zoomPoints.empty())
+	{
+		size_t firstZoomPoint = std::lower_bound(m_zoomPoints.begin(), m_zoomPoints.end(), startTime,
+			[](const ZoomControlPoint* point, MapTime t) { return point->time < t; }) - m_zoomPoints.begin();
+		m_currentZoomPoint = &m_zoomPoints.front() + firstZoomPoint;
+		for(size_t i = firstZoomPoint; i > 0 && !(m_zoomStartPoints[0] && m_zoomStartPoints[1]); i--)
+		{
+			ZoomControlPoint*& start = m_zoomStartPoints[m_zoomPoints[i - 1]->index];
+			if(!start)
+				start = m_zoomPoints[i - 1];
+		}
+		for(size_t i = firstZoomPoint; i < m_zoomPoints.size(); i++)
+		{
+			uint32 index = m_zoomPoints[i]->index;
+			if(m_zoomStartPoints[index] && !m_zoomEndPoints[index])
+				m_zoomEndPoints[index] = m_zoomPoints[i];
+		}
+	}
 
 	m_barTime = 0;
 	m_initialEffectStateSent = false;
@@ -47,6 +99,9 @@ void BeatmapPlayback::Update(MapTime newTime)
 		OnEventChanged.Call(EventKey::LaserEffectMix, settings.laserEffectMix);
 		OnEventChanged.Call(EventKey::LaserEffectType, settings.laserEffectType);
 		OnEventChanged.Call(EventKey::SlamVolume, settings.slamVolume);
+		// Events that were skipped by starting later in the map
+		for(auto& evt : m_eventMapping)
+			OnEventChanged.Call(evt.first, evt.second);
 		m_initialEffectStateSent = true;
 	}
 
@@ -59,6 +114,7 @@ void BeatmapPlayback::Update(MapTime newTime)
 
 	// Set new time
 	m_playbackTime = newTime;
+	m_playbackViewDistance = m_TimeToAbsoluteViewDistance(m_playbackTime);
 
 	// Advance timing
 	TimingPoint** timingEnd = m_SelectTimingPoint(m_playbackTime);
@@ -68,19 +124,20 @@ void BeatmapPlayback::Update(MapTime newTime)
 		OnTimingPointChanged.Call(*m_currentTiming);
 	}
 
+	// Enter objects that were still active at the time the playback was reset to
+	for(ObjectState* obj : m_seekObjects)
+	{
+		m_EnterObject(obj);
+	}
+	m_seekObjects.clear();
+
 	// Advance objects
 	ObjectState** objEnd = m_SelectHitObject(m_playbackTime+hittableObjectTreshold);
 	if(objEnd != nullptr && objEnd != m_currentObj)
 	{
 		for(auto it = m_currentObj; it < objEnd; it++)
 		{
-			MultiObjectState* obj = **it;
-			if(obj->type == ObjectType::Hold || obj->type == ObjectType::Laser || obj->type == ObjectType::Single)
-			{
-				m_holdObjects.Add(*obj);
-			}
-			m_hittableObjects.Add(*it);
-			OnObjectEntered.Call(*it);
+			m_EnterObject(*it);
 		}
 		m_currentObj = objEnd;
 	}
@@ -112,26 +169,35 @@ void BeatmapPlayback::Update(MapTime newTime)
 	}
 
 	// Check passed hittable objects
+	//	objects that can pass or start this update are handled in chart order, since the sets don't keep the order in which objects are added
 	MapTime objectPassTime = m_playbackTime - hittableObjectTreshold;
-	for(auto it = m_hittableObjects.begin(); it != m_hittableObjects.end();)
+	m_updateObjects.clear();
+	for(ObjectState* obj : m_hittableObjects)
 	{
-		MultiObjectState* obj = **it;
+		// Tiny offset to make sure events are triggered before they are needed
+		if(obj->time < (m_playbackTime+2))
+			m_updateObjects.Add(obj);
+	}
+	ObjectState::SortArray(m_updateObjects);
+	for(ObjectState* it : m_updateObjects)
+	{
+		MultiObjectState* obj = *it;
 		if(obj->type == ObjectType::Hold)
 		{
 			MapTime endTime = obj->hold.duration + obj->time;
 			if(endTime < objectPassTime)
 			{
-				OnObjectLeaved.Call(*it);
-				it = m_hittableObjects.erase(it);
+				OnObjectLeaved.Call(it);
+				m_hittableObjects.erase(it);
 				continue;
 			}
 			if(obj->hold.effectType != EffectType::None && // Hold button with effect
 				obj->time <= m_playbackTime && endTime > m_playbackTime) // Hold button in active range
 			{
-				if(!m_effectObjects.Contains(*obj))
+				if(!m_effectObjects.Contains(it))
 				{
-					OnFXBegin.Call((HoldObjectState*)*it);
-					m_effectObjects.Add(*obj);
+					OnFXBegin.Call((HoldObjectState*)it);
+					m_effectObjects.Add(it);
 				}
 			}
 		}
@@ -139,8 +205,8 @@ void BeatmapPlayback::Update(MapTime newTime)
 		{
 			if((obj->laser.duration + obj->time) < objectPassTime)
 			{
-				OnObjectLeaved.Call(*it);
-				it = m_hittableObjects.erase(it);
+				OnObjectLeaved.Call(it);
+				m_hittableObjects.erase(it);
 				continue;
 			}
 		}
@@ -148,44 +214,46 @@ void BeatmapPlayback::Update(MapTime newTime)
 		{
 			if(obj->time < objectPassTime)
 			{
-				OnObjectLeaved.Call(*it);
-				it = m_hittableObjects.erase(it);
+				OnObjectLeaved.Call(it);
+				m_hittableObjects.erase(it);
 				continue;
 			}
 		}
 		else if(obj->type == ObjectType::Event)
 		{
+			// Trigger event, all events collected above are due
 			EventObjectState* evt = (EventObjectState*)obj;
-			if(obj->time < (m_playbackTime+2)) // Tiny offset to make sure events are triggered before they are needed
-			{
-				// Trigger event
-				OnEventChanged.Call(evt->key, evt->data);
-				m_eventMapping[evt->key] = evt->data;
-				it = m_hittableObjects.erase(it);
-				continue;
-			}
+			OnEventChanged.Call(evt->key, evt->data);
+			m_eventMapping[evt->key] = evt->data;
+			m_hittableObjects.erase(it);
 		}
-		it++;
 	}
 
 	// Remove passed hold objects
-	for(auto it = m_holdObjects.begin(); it != m_holdObjects.end();)
+	m_updateObjects.clear();
+	for(ObjectState* obj : m_holdObjects)
+	{
+		if(obj->time < m_playbackTime)
+			m_updateObjects.Add(obj);
+	}
+	ObjectState::SortArray(m_updateObjects);
+	for(ObjectState* it : m_updateObjects)
 	{
-		MultiObjectState* obj = **it;
+		MultiObjectState* obj = *it;
 		if(obj->type == ObjectType::Hold)
 		{
 			MapTime endTime = obj->hold.duration + obj->time;
 			if(endTime < objectPassTime)
 			{
-				it = m_holdObjects.erase(it);
+				m_holdObjects.erase(it);
 				continue;
 			}
 			if(endTime < m_playbackTime)
 			{
-				if(m_effectObjects.Contains(*it))
+				if(m_effectObjects.Contains(it))
 				{
-					OnFXEnd.Call((HoldObjectState*)*it);
-					m_effectObjects.erase(*it);
+					OnFXEnd.Call((HoldObjectState*)it);
+					m_effectObjects.erase(it);
 				}
 			}
 		}
@@ -193,7 +261,7 @@ void BeatmapPlayback::Update(MapTime newTime)
 		{
 			if((obj->laser.duration + obj->time) < objectPassTime)
 			{
-				it = m_holdObjects.erase(it);
+				m_holdObjects.erase(it);
 				continue;
 			}
 		}
@@ -201,15 +269,14 @@ void BeatmapPlayback::Update(MapTime newTime)
 		{
 			if(obj->time < objectPassTime)
 			{
-				it = m_holdObjects.erase(it);
+				m_holdObjects.erase(it);
 				continue;
 			}
 		}
-		it++;
 	}
 }
 
-Set<ObjectState*>& BeatmapPlayback::GetHittableObjects()
+FlatHashSet<ObjectState*>& BeatmapPlayback::GetHittableObjects()
 {
 	return m_hittableObjects;
 }
@@ -251,7 +318,7 @@ const TimingPoint& BeatmapPlayback::GetCurrentTimingPoint() const
 }
 const TimingPoint* BeatmapPlayback::GetTimingPointAt(MapTime time) const
 {
-	return *const_cast<BeatmapPlayback*>(this)->m_SelectTimingPoint(time);
+	return m_timingPoints[m_FindTimingPointIndex(time)];
 }
 
 uint32 BeatmapPlayback::CountBeats(MapTime start, MapTime range, int32& startIndex, uint32 multiplier /*= 1*/) const
@@ -266,70 +333,29 @@ uint32 BeatmapPlayback::CountBeats(MapTime start, MapTime range, int32& startInd
 }
 MapTime BeatmapPlayback::ViewDistanceToDuration(float distance)
 {
-	TimingPoint** tp = m_SelectTimingPoint(m_playbackTime, true);
+	double targetDistance = m_playbackViewDistance + distance;
 
-	double time = 0;
+	// Find the last timing point that starts before the target distance
+	auto it = std::upper_bound(m_timingViewDistance.begin(), m_timingViewDistance.end(), targetDistance);
+	size_t index = (it == m_timingViewDistance.begin()) ? 0 : (it - m_timingViewDistance.begin() - 1);
 
-	MapTime currentTime = m_playbackTime;
-	while(true)
-	{
-		if(!IsEndTiming(tp + 1))
-		{
-			double maxDist = (tp[1]->time - (double)currentTime) / tp[0]->beatDuration;
-			if(maxDist < distance)
-			{
-				// Split up
-				time += maxDist * tp[0]->beatDuration;
-				distance -= (float)maxDist;
-				tp++;
-				continue;
-			}
-		}
-		time += distance * tp[0]->beatDuration;
-		break;
-	}
-	return (MapTime)time;
+	const TimingPoint* tp = m_timingPoints[index];
+	double time = tp->time + (targetDistance - m_timingViewDistance[index]) * tp->beatDuration;
+	return (MapTime)(time - m_playbackTime);
 }
 float BeatmapPlayback::DurationToViewDistance(MapTime duration)
 {
-	return DurationToViewDistanceAtTime(m_playbackTime, duration);
+	return (float)(m_TimeToAbsoluteViewDistance(m_playbackTime + duration) - m_playbackViewDistance);
 }
 
 float BeatmapPlayback::DurationToViewDistanceAtTime(MapTime time, MapTime duration)
 {
-	MapTime endTime = time + duration;
-
-	// Accumulated value
-	double barTime = 0.0f;
-
-	// Split up to see if passing other timing points on the way
-	TimingPoint** tp = m_SelectTimingPoint(time, true);
-	while(true)
-	{
-		if(!IsEndTiming(tp + 1))
-		{
-			if(tp[1]->time < endTime)
-			{
-				// Split up
-				MapTime myDuration = tp[1]->time - time;
-				barTime += (double)myDuration / tp[0]->beatDuration;
-				duration -= myDuration;
-				time = tp[1]->time;
-				tp++;
-				continue;
-			}
-		}
-		// Whole
-		barTime += (double)duration / tp[0]->beatDuration;
-		break;
-	}
-
- 	return (float)barTime;
+	return (float)(m_TimeToAbsoluteViewDistance(time + duration) - m_TimeToAbsoluteViewDistance(time));
 }
 
 float BeatmapPlayback::TimeToViewDistance(MapTime time)
 {
-	return DurationToViewDistanceAtTime(m_playbackTime, time - m_playbackTime);
+	return (float)(m_TimeToAbsoluteViewDistance(time) - m_playbackViewDistance);
 }
 
 float BeatmapPlayback::GetBarTime() const
@@ -363,22 +389,12 @@ TimingPoint** BeatmapPlayback::m_SelectTimingPoint(MapTime time, bool allowReset
 	if(IsEndTiming(objStart))
 		return objStart;
 
-	// Start at front of array if current object lies ahead of given input time
-	if(objStart[0]->time > time && allowReset)
-		objStart = &m_timingPoints.front();
+	TimingPoint** found = &m_timingPoints[m_FindTimingPointIndex(time)];
 
-	// Keep advancing the start pointer while the next object's starting time lies before the input time
-	while(true)
-	{
-		if(!IsEndTiming(objStart+1) && objStart[1]->time <= time)
-		{
-			objStart = objStart + 1;
-		}
-		else
-			break;
-	}
-
-	return objStart;
+	// Only move back if the current point lies ahead of given input time and resetting is allowed
+	if(found < objStart && !allowReset)
+		return objStart;
+	return found;
 }
 ObjectState** BeatmapPlayback::m_SelectHitObject(MapTime time, bool allowReset)
 {
@@ -435,3 +451,87 @@ bool BeatmapPlayback::IsEndZoomPoint(ZoomControlPoint** obj)
 {
 	return obj == (&m_zoomPoints.back() + 1);
 }
+
+void BeatmapPlayback::m_BuildViewDistanceTable()
+{
+	m_timingViewDistance.resize(m_timingPoints.size());
+	double distance = 0.0;
+	for(size_t i = 0; i < m_timingPoints.size(); i++)
+	{
+		if(i > 0)
+		{
+			const TimingPoint* prev = m_timingPoints[i - 1];
+			distance += (double)(m_timingPoints[i]->time - prev->time) / prev->beatDuration;
+		}
+		m_timingViewDistance[i] = distance;
+	}
+	m_timingPointHint = 0;
+}
+void BeatmapPlayback::m_BuildObjectIntervalIndex()
+{
+	m_objectEndTimes.resize(m_objects.size());
+	m_eventObjects.clear();
+	MapTime maxEndTime = 0;
+	for(size_t i = 0; i < m_objects.size(); i++)
+	{
+		MultiObjectState* obj = *m_objects[i];
+		MapTime endTime = GetObjectEndTime(obj);
+		maxEndTime = (i == 0) ? endTime : Math::Max(maxEndTime, endTime);
+		m_objectEndTimes[i] = maxEndTime;
+
+		if(obj->type == ObjectType::Event)
+			m_eventObjects.FindOrAdd(obj->event.key).Add((EventObjectState*)obj);
+	}
+}
+void BeatmapPlayback::m_GetObjectsActiveAt(MapTime time, size_t endIndex, Vector<ObjectState*>& out) const
+{
+	// Objects before this index all end before the given time
+	size_t beginIndex = std::lower_bound(m_objectEndTimes.begin(), m_objectEndTimes.begin() + endIndex, time) - m_objectEndTimes.begin();
+	for(size_t i = beginIndex; i < endIndex; i++)
+	{
+		MultiObjectState* obj = *m_objects[i];
+		if(GetObjectEndTime(obj) < time)
+			continue;
+
+		// Laser ticks are registered on the root segment, so it needs to be entered as well
+		if(obj->type == ObjectType::Laser && obj->laser.prev)
+			out.AddUnique(*obj->laser.GetRoot());
+		out.AddUnique(m_objects[i]);
+	}
+}
+void BeatmapPlayback::m_EnterObject(ObjectState* obj)
+{
+	if(obj->type == ObjectType::Hold || obj->type == ObjectType::Laser || obj->type == ObjectType::Single)
+	{
+		m_holdObjects.Add(obj);
+	}
+	m_hittableObjects.Add(obj);
+	OnObjectEntered.Call(obj);
+}
+size_t BeatmapPlayback::m_FindTimingPointIndex(MapTime time) const
+{
+	const size_t numTimingPoints = m_timingPoints.size();
+	assert(numTimingPoints > 0);
+
+	// Check the last used timing point and the one after it before searching
+	size_t hint = m_timingPointHint;
+	if(hint < numTimingPoints && m_timingPoints[hint]->time <= time)
+	{
+		if(hint + 1 == numTimingPoints || m_timingPoints[hint + 1]->time > time)
+			return hint;
+		if(hint + 2 == numTimingPoints || m_timingPoints[hint + 2]->time > time)
+			return m_timingPointHint = hint + 1;
+	}
+
+	// Find the last timing point that starts on or before the given time
+	auto it = std::upper_bound(m_timingPoints.begin(), m_timingPoints.end(), time,
+		[](MapTime t, const TimingPoint* tp) { return t < tp->time; });
+	size_t index = (it == m_timingPoints.begin()) ? 0 : (it - m_timingPoints.begin() - 1);
+	return m_timingPointHint = index;
+}
+double BeatmapPlayback::m_TimeToAbsoluteViewDistance(MapTime time) const
+{
+	size_t index = m_FindTimingPointIndex(time);
+	const TimingPoint* tp = m_timingPoints[index];
+	return m_timingViewDistance[index] + (double)(time - tp->time) / tp->beatDuration;
+}
@@ -66,6 +66,11 @@ int64 DBStatement::Int64Column(int32 index /*= 0*/) const
 	assert(m_stmt && m_queryResult == SQLITE_ROW);
 	return sqlite3_column_int64(m_stmt, index);
 }
+double DBStatement::DoubleColumn(int32 index /*= 0*/) const
+{
+	assert(m_stmt && m_queryResult == SQLITE_ROW);
+	return sqlite3_column_double(m_stmt, index);
+}
 String DBStatement::StringColumn(int32 index /*= 0*/) const
 {
 	assert(m_stmt && m_queryResult == SQLITE_ROW);
@@ -88,6 +93,11 @@ void DBStatement::BindInt64(int32 index, const int64& value)
 	assert(m_stmt);
 	sqlite3_bind_int64(m_stmt, index, value);
 }
+void DBStatement::BindDouble(int32 index, const double& value)
+{
+	assert(m_stmt);
+	sqlite3_bind_double(m_stmt, index, value);
+}
 
 static void FreeData(char* data)
 {
@@ -123,6 +133,9 @@ Database::~Database()
 }
 void Database::Close()
 {
+	for(auto& statement : m_statementCache)
+		delete statement.second;
+	m_statementCache.clear();
 	if(db)
 	{
 		sqlite3_close(db);
@@ -162,3 +175,11 @@ bool Database::ExecDirect(const String& queryString)
 	}
 	return true;
 }
+
+DBStatement& Database::GetCachedStatement(const String& queryString)
+{
+	DBStatement*& statement = m_statementCache.FindOrAdd(queryString, nullptr);
+	if(!statement)
+		statement = new DBStatement(queryString, this);
+	return *statement;
+}
@@ -4,8 +4,13 @@
 #include "Beatmap.hpp"
 #include "Shared/Profiling.hpp"
 #include "Shared/Files.hpp"
+#include "Shared/FileWatcher.hpp"
+#include "Shared/StringPool.hpp"
+#include "Shared/Hash.hpp"
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <chrono>
 using std::thread;
 using std::mutex;
@@ -25,9 +30,8 @@ public:
 
 	Map<int32, MapIndex*> m_maps;
 	Map<int32, DifficultyIndex*> m_difficulties;
-	Map<String, MapIndex*> m_mapsByPath;
-	int32 m_nextMapId = 1;
-	int32 m_nextDiffId = 1;
+	// Stores the paths and metadata strings of the map index, most metadata like artists or file names is shared by many maps
+	StringPool m_strings;
 
 	struct SearchState
 	{
@@ -35,14 +39,26 @@ public:
 		{
 			int32 id;
 			uint64 lwt;
+			uint64 hash;
 		};
-		// Maps file paths to the id's and last write time's for difficulties already in the database
+		// Maps file paths to the id's, last write time's and hashes for difficulties already in the database
 		Map<String, ExistingDifficulty> difficulties;
+
+		// A difficulty that was added, updated or removed by Update after the state was created
+		struct Change
+		{
+			String path;
+			ExistingDifficulty difficulty;
+			bool removed;
+		};
+		// Applied to the difficulties before the next scan starts, since a running scan is still reading them
+		Vector<Change> changes;
 	} m_searchState;
 
 	// Represents an event produced from a scan
 	//	a difficulty can be removed/added/updated
 	//	a BeatmapSettings structure will be provided for added/updated events
+	//	updated events without one are files that were touched without changing their contents
 	struct Event
 	{
 		enum Action
@@ -55,25 +71,140 @@ public:
 		String path;
 		// Current lwt of file
 		uint64 lwt;
+		// Hash of the file contents
+		uint64 hash = 0;
 		// Id of the map
 		int32 id;
 		// Scanned map data, for added/updated maps
 		BeatmapSettings* mapData = nullptr;
+		BeatmapAnalytics analytics;
 	};
 	List<Event> m_pendingChanges;
 	mutex m_pendingChangesLock;
 
-	static const int32 m_version = 8;
+	// A change to the map index made by the writer thread, which Update applies to the map index
+	struct IndexChange
+	{
+		Event::Action action;
+		int32 diffId;
+		int32 mapId;
+		// Set when a difficulty was added to a new map or when the last difficulty of a map was removed
+		bool mapChanged = false;
+		// Path of the difficulty, for added difficulties
+		const char* mapPath;
+		const char* fileName;
+		uint64 lwt;
+		uint64 hash;
+		// Set when the contents of an updated difficulty did not change, only its lwt needs to be updated
+		bool touched = false;
+		// Scanned map data for added/updated difficulties
+		DifficultyMetadata metadata;
+	};
+	// Changes the writer thread applied to the database in a single transaction
+	typedef Vector<IndexChange> ChangeSet;
+
+	// Writes the events from m_pendingChanges to the database and turns them into change sets
+	thread m_writerThread;
+	condition_variable m_changesAdded;
+	bool m_exitWriter = false;
+	// Set while the writer thread is processing events
+	bool m_writingChanges = false;
+	// Change sets that still need to be applied to the map index, protected by m_pendingChangesLock
+	List<ChangeSet> m_changeSets;
+	// Change set currently being applied to the map index
+	ChangeSet m_applyingChanges;
+	size_t m_appliedChanges = 0;
+	// Maximum number of changes applied to the map index by a single call to Update
+	static const size_t m_maxChangesPerUpdate = 256;
+
+	// Map state used by the writer thread, separate from the map index so it can be used without locking
+	struct WriterState
+	{
+		struct MapState
+		{
+			const char* path;
+			uint32 numDifficulties = 0;
+		};
+		Map<int32, MapState> maps;
+		// Map id's by map folder, using the pooled folder paths
+		Map<const char*, int32> mapIds;
+		// Map id's by difficulty id
+		Map<int32, int32> difficultyMaps;
+		int32 nextMapId = 1;
+		int32 nextDiffId = 1;
+	} m_writerState;
+
+	// Number of threads used to read map metadata, 0 = one per hardware thread
+	//	set from the main thread while the update thread may be scanning
+	atomic<uint32> m_scanThreadCount = { 0 };
+	// Number of changes a scan thread collects before adding them to the change queue
+	static const size_t m_scanBatchSize = 64;
+
+	// Reports changed files in the search paths, so that only those need to be checked after the first scan
+	FileWatcher m_watcher;
+	// Set when a scan of all the search paths has finished
+	atomic<bool> m_scanComplete = { false };
+	// Changed paths reported by the watcher that have not been processed yet
+	Set<String> m_changedPaths;
+	// Set when the watcher lost changes and all search paths need to be scanned again
+	bool m_rescanPending = false;
+	// Time since the last scan, used to scan periodically when the search paths can't be watched
+	Timer m_pollTimer;
+	static constexpr float m_pollInterval = 30.0f;
+
+	String m_databasePath;
+
+	// Set if the full text search index is available, LIKE queries are used otherwise
+	bool m_hasSearchIndex = false;
+
+	// Runs searches requested with FindMapsAsync
+	thread m_searchThread;
+	mutex m_searchLock;
+	condition_variable m_searchRequested;
+	bool m_exitSearchThread = false;
+	String m_searchRequest;
+	// Incremented for every requested search, results of older searches are dropped
+	uint64 m_searchGeneration = 0;
+	// Results of the last finished search
+	Vector<int32> m_searchResult;
+	uint64 m_searchResultGeneration = 0;
+	bool m_hasSearchResult = false;
+
+	// Maps read by the load thread that still need to be added to the map index
+	struct LoadedPage
+	{
+		Vector<MapIndex*> maps;
+		Vector<DifficultyIndex*> difficulties;
+	};
+	thread m_loadThread;
+	mutex m_loadLock;
+	List<LoadedPage> m_loadedPages;
+	// Set while the map index is being loaded from the database
+	bool m_loading = false;
+	// Set by the load thread when all pages are added to m_loadedPages
+	bool m_loadFinished = false;
+	bool m_interruptLoad = false;
+	// Number of maps in the database, known shortly after loading started
+	atomic<size_t> m_loadMapCount;
+	// Set when searching was requested while loading or applying changes, the search starts once the map index is up to date
+	bool m_searchPending = false;
+	// Number of maps passed to OnMapsAdded at once while loading
+	static const size_t m_loadPageSize = 256;
+
+	static const int32 m_version = 10;
 
 public:
-	MapDatabase_Impl(MapDatabase& outer) : m_outer(outer)
+	MapDatabase_Impl(MapDatabase& outer, const String& databasePath) : m_outer(outer), m_databasePath(databasePath)
 	{
-		String databasePath = "maps.db";
 		if(!m_database.Open(databasePath))
 		{
 			Logf("Failed to open database [%s]", Logger::Warning, databasePath);
 			assert(false);
 		}
+		// The loading, searching and writing threads use their own connections to the same database
+		//	with a write ahead log these can read while changes are written
+		m_database.Exec("PRAGMA journal_mode=WAL");
+		m_database.Exec("PRAGMA busy_timeout=1000");
 
 		bool rebuild = false;
 		DBStatement versionQuery = m_database.Query("SELECT version FROM `Database`");
@@ -102,15 +233,48 @@ public:
 			// Update database version
 			m_database.Exec(Utility::Sprintf("UPDATE Database SET `version`=%d WHERE `rowid`=1", m_version));
 		}
-		else
+
+		m_InitSearchIndex();
+
+		if(!rebuild)
 		{
-			// Load initial folder tree
-			m_LoadInitialData();
+			// Load initial folder tree, the maps are added in pages when calling Update
+			m_StartLoading();
 		}
+
+		m_writerThread = thread(&MapDatabase_Impl::m_WriterThread, this);
 	}
 	~MapDatabase_Impl()
 	{
 		StopSearching();
+
+		if(m_loadThread.joinable())
+		{
+			m_loadLock.lock();
+			m_interruptLoad = true;
+			m_loadLock.unlock();
+			m_loadThread.join();
+		}
+		for(LoadedPage& page : m_loadedPages)
+			m_DeletePage(page);
+
+		m_pendingChangesLock.lock();
+		m_exitWriter = true;
+		m_pendingChangesLock.unlock();
+		m_changesAdded.notify_one();
+		m_writerThread.join();
+		for(Event& e : m_pendingChanges)
+			delete e.mapData;
+
+		if(m_searchThread.joinable())
+		{
+			m_searchLock.lock();
+			m_exitSearchThread = true;
+			m_searchLock.unlock();
+			m_searchRequested.notify_one();
+			m_searchThread.join();
+		}
+
 		m_CleanupMapIndex();
 	}
 
@@ -119,17 +283,34 @@ public:
 		if(m_searching)
 			return;
 
+		// Files are compared against the map index, so that needs to be up to date first
+		if(m_loading || m_IsChangePending())
+		{
+			m_searchPending = true;
+			return;
+		}
+		m_searchPending = false;
+
 		if(m_thread.joinable())
 			m_thread.join();
 
 		// Create initial data set to compare to when evaluating if a file is added/removed/updated
-		m_LoadInitialData();
-		m_interruptSearch = false;
-		m_searching = true;
-		m_thread = thread(&MapDatabase_Impl::m_SearchThread, this);
+		m_ResetSearchState();
+		m_changedPaths.clear();
+		m_rescanPending = false;
+		m_StartThread(&MapDatabase_Impl::m_SearchThread);
+	}
+	bool IsWatching() const
+	{
+		return m_scanComplete && m_watcher.IsWatching();
+	}
+	bool IsSearching()
+	{
+		return m_searching || m_searchPending || m_IsChangePending();
 	}
 	void StopSearching()
 	{
+		m_searchPending = false;
 		m_interruptSearch = true;
 		m_searching = false;
 		if(m_thread.joinable())
@@ -161,204 +342,172 @@ public:
 		m_pendingChangesLock.lock();
 		m_pendingChanges.emplace_back(change);
 		m_pendingChangesLock.unlock();
+		m_changesAdded.notify_one();
 	}
-	// Removes changes from the queue and returns them
-	//	additionally you can specify the maximum amount of changes to remove from the queue
-	List<Event> FlushChanges(size_t maxChanges = -1)
+	// Adds multiple changes to the change queue at once
+	void AddChanges(List<Event>& changes)
 	{
-		List<Event> changes;
 		m_pendingChangesLock.lock();
-		if(maxChanges == -1)
-		{
-			changes = std::move(m_pendingChanges); // All changes
-		}
-		else
-		{
-			for(size_t i = 0; i < maxChanges && !m_pendingChanges.empty(); i++)
-			{
-				changes.AddFront(m_pendingChanges.front());
-				m_pendingChanges.pop_front();
-			}
-		}
+		m_pendingChanges.splice(m_pendingChanges.end(), changes);
 		m_pendingChangesLock.unlock();
-		return std::move(changes);
+		m_changesAdded.notify_one();
 	}
-	
+
 	Map<int32, MapIndex*> FindMaps(const String& searchString)
 	{
-		WString test = Utility::ConvertToWString(searchString);
-		String stmt = "SELECT rowid FROM Maps WHERE";
+		Vector<int32> mapIds = m_QueryMapIds(m_database, searchString);
+		return m_GetMapsById(mapIds);
+	}
+	// Starts a search on the search thread, the results are passed to OnFoundMaps by Update
+	//	results of a previous search that has not finished yet are dropped
+	void FindMapsAsync(const String& searchString)
+	{
+		if(!m_searchThread.joinable())
+			m_searchThread = thread(&MapDatabase_Impl::m_SearchMapsThread, this);
+
+		m_searchLock.lock();
+		m_searchRequest = searchString;
+		m_searchGeneration++;
+		m_searchLock.unlock();
+		m_searchRequested.notify_one();
+	}
+	bool IsFindingMaps()
+	{
+		lock_guard<mutex> lock(m_searchLock);
+		return m_searchResultGeneration != m_searchGeneration || m_hasSearchResult;
+	}
 
-		//search.spl
-		Vector<String> terms = searchString.Explode(" ");
-		int32 i = 0;
-		for(auto term : terms)
+	// Reads the metadata of maps added while loading, which is skipped to load the map index faster
+	void LoadMetadata(MapIndex* map)
+	{
+		bool loaded = false;
+		for(DifficultyIndex* diff : map->difficulties)
 		{
-			if(i > 0)
-				stmt += " AND";
-			stmt += " (artist LIKE \"%" + term + "%\"" + 
-				" OR title LIKE \"%" + term + "%\"" +
-				" OR path LIKE \"%" + term + "%\"" +
-				" OR tags LIKE \"%" + term + "%\")";
-			i++;
-		}
+			if(diff->metadataLoaded)
+				continue;
 
-		Map<int32, MapIndex*> res;
-		DBStatement search = m_database.Query(stmt);
-		while(search.StepRow())
-		{
-			int32 id = search.IntColumn(0);
-			MapIndex** map = m_maps.Find(id);
-			if(map)
+			DBStatement& metadataQuery = m_database.GetCachedStatement(
+				"SELECT metadata," + String(m_analyticsColumns) + " FROM Difficulties WHERE rowid=?");
+			metadataQuery.BindInt(1, diff->id);
+			BeatmapSettings settings;
+			BeatmapAnalytics analytics;
+			if(metadataQuery.StepRow())
 			{
-				res.Add(id, *map);
+				Buffer metadata = metadataQuery.BlobColumn(0);
+				MemoryReader metadataReader(metadata);
+				metadataReader.SerializeObject(settings);
+				analytics = m_ReadAnalytics(metadataQuery, 1);
 			}
+			diff->metadata = m_CreateMetadata(settings, analytics);
+			metadataQuery.Rewind();
+			diff->metadataLoaded = true;
+			loaded = true;
 		}
 
-
-		return res;
+		// Difficulties are sorted using their metadata
+		if(loaded)
+			m_SortDifficulties(map);
+	}
+	bool IsLoading() const
+	{
+		return m_loading;
+	}
+	size_t GetMapCount() const
+	{
+		return m_loading ? Math::Max(m_loadMapCount.load(), m_maps.size()) : m_maps.size();
 	}
 
-	// Processes pending database changes
+	// Applies changes written by the writer thread to the map index
 	void Update()
 	{
-		List<Event> changes = FlushChanges();
-		if(changes.empty())
-			return;
-
-		DBStatement addDiff = m_database.Query("INSERT INTO Difficulties(path,lwt,metadata,rowid,mapid) VALUES(?,?,?,?,?)");
-		DBStatement addMap = m_database.Query("INSERT INTO Maps(path,artist,title,tags,rowid) VALUES(?,?,?,?,?)");
-		DBStatement update = m_database.Query("UPDATE Difficulties SET lwt=?,metadata=? WHERE rowid=?");
-		DBStatement removeDiff = m_database.Query("DELETE FROM Difficulties WHERE rowid=?");
-		DBStatement removeMap = m_database.Query("DELETE FROM Maps WHERE rowid=?");
+		m_AddLoadedPages();
+		m_DispatchSearchResults();
+		m_CheckChangedFiles();
 
 		Set<MapIndex*> addedEvents;
 		Set<MapIndex*> removeEvents;
 		Set<MapIndex*> updatedEvents;
 
-		m_database.Exec("BEGIN");
-		for(Event& e : changes)
+		// Limit the time spent per call when a lot of maps changed
+		for(size_t numApplied = 0; numApplied < m_maxChangesPerUpdate; numApplied++)
 		{
-			if(e.action == Event::Added)
+			if(m_appliedChanges == m_applyingChanges.size())
 			{
-				Buffer metadata;
-				MemoryWriter metadataWriter(metadata);
-				metadataWriter.SerializeObject(*e.mapData);
+				lock_guard<mutex> lock(m_pendingChangesLock);
+				if(m_changeSets.empty())
+					break;
+				m_applyingChanges = std::move(m_changeSets.front());
+				m_changeSets.pop_front();
+				m_appliedChanges = 0;
+				if(m_applyingChanges.empty())
+					continue;
+			}
 
-				String mapPath = Path::RemoveLast(e.path, nullptr);
-				bool existingUpdated;
+			IndexChange& change = m_applyingChanges[m_appliedChanges++];
+			if(change.action == Event::Added)
+			{
 				MapIndex* map;
-
-				// Add or get map
-				auto mapIt = m_mapsByPath.find(mapPath);
-				if(mapIt == m_mapsByPath.end())
+				if(change.mapChanged)
 				{
 					// Add map
 					map = new MapIndex();
-					map->id = m_nextMapId++;
-					map->path = mapPath;
-
+					map->id = change.mapId;
+					map->path = change.mapPath;
 					m_maps.Add(map->id, map);
-					m_mapsByPath.Add(map->path, map);
-
-					addMap.BindString(1, map->path);
-					addMap.BindString(2, e.mapData->artist);
-					addMap.BindString(3, e.mapData->title);
-					addMap.BindString(4, e.mapData->tags);
-					addMap.BindInt(5, map->id);
-					addMap.Step();
-					addMap.Rewind();
-
-					existingUpdated = false; // New map
+					addedEvents.Add(map);
 				}
 				else
 				{
-					map = mapIt->second;
-					existingUpdated = true; // Existing map
+					map = m_maps[change.mapId];
+					LoadMetadata(map);
+					updatedEvents.Add(map);
 				}
 
 				DifficultyIndex* diff = new DifficultyIndex();
-				diff->id = m_nextDiffId++;
-				diff->lwt = e.lwt;
+				diff->id = change.diffId;
+				diff->lwt = change.lwt;
+				diff->hash = change.hash;
 				diff->mapId = map->id;
-				diff->path = e.path;
-				diff->settings = *e.mapData;
+				diff->map = map;
+				diff->fileName = change.fileName;
+				diff->metadata = change.metadata;
+				diff->metadataLoaded = true;
 				m_difficulties.Add(diff->id, diff);
 
 				// Add diff to map and resort
 				map->difficulties.Add(diff);
 				m_SortDifficulties(map);
-
-				// Add Diff
-				addDiff.BindString(1, diff->path);
-				addDiff.BindInt64(2, diff->lwt);
-				addDiff.BindBlob(3, metadata);
-				addDiff.BindInt64(4, diff->id); // rowid
-				addDiff.BindInt64(5, diff->mapId); // mapid
-				addDiff.Step();
-				addDiff.Rewind();
-
-				// Send appropriate notification
-				if(existingUpdated)
-				{
-					updatedEvents.Add(map);
-				}
-				else
-				{
-					addedEvents.Add(map);
-				}
+				m_AddSearchStateChange(diff, false);
 			}
-			else if(e.action == Event::Updated)
+			else if(change.action == Event::Updated)
 			{
-				Buffer metadata;
-				MemoryWriter metadataWriter(metadata);
-				metadataWriter.SerializeObject(*e.mapData);
-
-				update.BindInt64(1, e.lwt);
-				update.BindBlob(2, metadata);
-				update.BindInt(3, e.id);
-				update.Step();
-				update.Rewind();
-				
-				auto itDiff = m_difficulties.find(e.id);
-				assert(itDiff != m_difficulties.end());
-
-				itDiff->second->lwt = e.lwt;
-				itDiff->second->settings = *e.mapData;
-
-				auto itMap = m_maps.find(itDiff->second->mapId);
-				assert(itMap != m_maps.end());
-
-				// Send notification
-				updatedEvents.Add(itMap->second);
+				DifficultyIndex* diff = m_difficulties[change.diffId];
+				diff->lwt = change.lwt;
+				if(change.touched)
+				{
+					m_AddSearchStateChange(diff, false);
+					continue;
+				}
+				diff->hash = change.hash;
+				m_AddSearchStateChange(diff, false);
+				diff->metadata = change.metadata;
+				diff->metadataLoaded = true;
+				updatedEvents.Add(m_maps[change.mapId]);
 			}
-			else if(e.action == Event::Removed)
+			else if(change.action == Event::Removed)
 			{
-				auto itDiff = m_difficulties.find(e.id);
-				assert(itDiff != m_difficulties.end());
-
-				auto itMap = m_maps.find(itDiff->second->mapId);
-				assert(itMap != m_maps.end());
+				auto itDiff = m_difficulties.find(change.diffId);
+				auto itMap = m_maps.find(change.mapId);
+				assert(itDiff != m_difficulties.end() && itMap != m_maps.end());
 
+				m_AddSearchStateChange(itDiff->second, true);
 				itMap->second->difficulties.Remove(itDiff->second);
-
 				delete itDiff->second;
-				m_difficulties.erase(e.id);
-
-				// Remove diff in db
-				removeDiff.BindInt(1, e.id);
-				removeDiff.Step();
-				removeDiff.Rewind();
+				m_difficulties.erase(itDiff);
 
-				if(itMap->second->difficulties.empty()) // Remove map as well
+				if(change.mapChanged) // Remove map as well
 				{
 					removeEvents.Add(itMap->second);
-
-					removeMap.BindInt(1, itMap->first);
-					removeMap.Step();
-					removeMap.Rewind();
-
-					m_mapsByPath.erase(itMap->second->path);
 					m_maps.erase(itMap);
 				}
 				else
@@ -366,10 +515,7 @@ public:
 					updatedEvents.Add(itMap->second);
 				}
 			}
-			if(e.mapData)
-				delete e.mapData;
 		}
-		m_database.Exec("END");
 
 		// Fire events
 		if(!removeEvents.empty())
@@ -406,6 +552,8 @@ public:
 			Vector<MapIndex*> eventsArray;
 			for(auto i : updatedEvents)
 			{
+				// Other difficulties of the map might not have been loaded yet
+				LoadMetadata(i);
 				eventsArray.Add(i);
 			}
 
@@ -414,6 +562,460 @@ public:
 	}
 
 private:
+	void m_StartThread(void (MapDatabase_Impl::*function)())
+	{
+		m_interruptSearch = false;
+		m_searching = true;
+		m_pollTimer.Restart();
+		m_thread = thread(function, this);
+	}
+
+	// Returns true if there are changes that have not been applied to the map index yet
+	bool m_IsChangePending()
+	{
+		lock_guard<mutex> lock(m_pendingChangesLock);
+		return !m_pendingChanges.empty() || m_writingChanges || !m_changeSets.empty() ||
+			m_appliedChanges < m_applyingChanges.size();
+	}
+
+	// Writes all queued events to the database and passes the resulting change sets to Update
+	void m_WriterThread()
+	{
+		Database database;
+		if(!database.Open(m_databasePath))
+		{
+			Logf("Failed to open database for writing [%s]", Logger::Warning, m_databasePath);
+			return;
+		}
+		database.Exec("PRAGMA busy_timeout=1000");
+		// A write ahead log doesn't need to be synced on every commit to stay consistent
+		database.Exec("PRAGMA synchronous=NORMAL");
+
+		unique_lock<mutex> lock(m_pendingChangesLock);
+		while(true)
+		{
+			m_changesAdded.wait(lock, [&]() { return m_exitWriter || !m_pendingChanges.empty(); });
+			if(m_exitWriter)
+				break;
+
+			List<Event> events = std::move(m_pendingChanges);
+			m_pendingChanges.clear();
+			m_writingChanges = true;
+			lock.unlock();
+
+			ChangeSet changeSet = m_WriteChanges(database, events);
+
+			lock.lock();
+			m_changeSets.emplace_back(std::move(changeSet));
+			m_writingChanges = false;
+		}
+	}
+	ChangeSet m_WriteChanges(Database& database, List<Event>& events)
+	{
+		ProfilerScope $("Map Database - Write Changes");
+
+		DBStatement& addDiff = database.GetCachedStatement("INSERT INTO Difficulties(path,lwt,hash,metadata,rowid,mapid,"
+			+ String(m_analyticsColumns) + ") VALUES(?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)");
+		DBStatement& addMap = database.GetCachedStatement("INSERT INTO Maps(path,artist,title,tags,rowid) VALUES(?,?,?,?,?)");
+		DBStatement& update = database.GetCachedStatement("UPDATE Difficulties SET lwt=?,hash=?,metadata=?,"
+			"numNotes=?,numButtons=?,numHolds=?,numLasers=?,maxNotesPerSecond=?,minBPM=?,maxBPM=?,duration=?,density=? WHERE rowid=?");
+		DBStatement& touch = database.GetCachedStatement("UPDATE Difficulties SET lwt=? WHERE rowid=?");
+		DBStatement& removeDiff = database.GetCachedStatement("DELETE FROM Difficulties WHERE rowid=?");
+		DBStatement& removeMap = database.GetCachedStatement("DELETE FROM Maps WHERE rowid=?");
+
+		ChangeSet changeSet;
+		changeSet.reserve(events.size());
+
+		database.Exec("BEGIN");
+		for(Event& e : events)
+		{
+			IndexChange change;
+			change.action = e.action;
+			change.lwt = e.lwt;
+			change.hash = e.hash;
+			BeatmapSettings* mapData = e.mapData;
+			e.mapData = nullptr;
+			if(mapData)
+				change.metadata = m_CreateMetadata(*mapData, e.analytics);
+
+			if(e.action == Event::Added)
+			{
+				Buffer metadata;
+				MemoryWriter metadataWriter(metadata);
+				metadataWriter.SerializeObject(*mapData);
+
+				// Add or get map
+				String fileName;
+				const char* mapPath = m_strings.Add(Path::RemoveLast(e.path, &fileName));
+				change.mapPath = mapPath;
+				change.fileName = m_strings.Add(fileName);
+				int32* mapId = m_writerState.mapIds.Find(mapPath);
+				if(mapId)
+				{
+					change.mapId = *mapId;
+				}
+				else
+				{
+					change.mapId = m_writerState.nextMapId++;
+					change.mapChanged = true;
+
+					addMap.BindString(1, mapPath);
+					addMap.BindString(2, mapData->artist);
+					addMap.BindString(3, mapData->title);
+					addMap.BindString(4, mapData->tags);
+					addMap.BindInt(5, change.mapId);
+					addMap.Step();
+					addMap.Rewind();
+
+					m_writerState.mapIds.Add(mapPath, change.mapId);
+					m_writerState.maps[change.mapId].path = mapPath;
+				}
+				change.diffId = m_writerState.nextDiffId++;
+				m_writerState.maps[change.mapId].numDifficulties++;
+				m_writerState.difficultyMaps.Add(change.diffId, change.mapId);
+
+				// Add Diff
+				addDiff.BindString(1, e.path);
+				addDiff.BindInt64(2, e.lwt);
+				addDiff.BindInt64(3, e.hash);
+				addDiff.BindBlob(4, metadata);
+				addDiff.BindInt64(5, change.diffId); // rowid
+				addDiff.BindInt64(6, change.mapId); // mapid
+				m_BindAnalytics(addDiff, 7, e.analytics);
+				addDiff.Step();
+				addDiff.Rewind();
+				m_AddSearchEntry(database, change.diffId, change.mapId, *mapData);
+			}
+			else if(e.action == Event::Updated)
+			{
+				int32* mapId = m_writerState.difficultyMaps.Find(e.id);
+				if(!mapId)
+				{
+					delete mapData;
+					continue;
+				}
+				change.diffId = e.id;
+				change.mapId = *mapId;
+
+				if(!mapData)
+				{
+					// Same contents, the chart doesn't need to be read again
+					change.touched = true;
+					touch.BindInt64(1, e.lwt);
+					touch.BindInt(2, e.id);
+					touch.Step();
+					touch.Rewind();
+					changeSet.emplace_back(change);
+					continue;
+				}
+
+				Buffer metadata;
+				MemoryWriter metadataWriter(metadata);
+				metadataWriter.SerializeObject(*mapData);
+
+				update.BindInt64(1, e.lwt);
+				update.BindInt64(2, e.hash);
+				update.BindBlob(3, metadata);
+				m_BindAnalytics(update, 4, e.analytics);
+				update.BindInt(13, e.id);
+				update.Step();
+				update.Rewind();
+				m_RemoveSearchEntry(database, e.id);
+				m_AddSearchEntry(database, change.diffId, change.mapId, *mapData);
+			}
+			else if(e.action == Event::Removed)
+			{
+				int32* mapId = m_writerState.difficultyMaps.Find(e.id);
+				if(!mapId)
+					continue;
+				change.diffId = e.id;
+				change.mapId = *mapId;
+				m_writerState.difficultyMaps.erase(e.id);
+
+				// Remove diff in db
+				removeDiff.BindInt(1, e.id);
+				removeDiff.Step();
+				removeDiff.Rewind();
+				m_RemoveSearchEntry(database, e.id);
+
+				auto itMap = m_writerState.maps.find(change.mapId);
+				if(--itMap->second.numDifficulties == 0) // Remove map as well
+				{
+					change.mapChanged = true;
+
+					removeMap.BindInt(1, change.mapId);
+					removeMap.Step();
+					removeMap.Rewind();
+
+					m_writerState.mapIds.erase(itMap->second.path);
+					m_writerState.maps.erase(itMap);
+				}
+			}
+			delete mapData;
+			changeSet.emplace_back(change);
+		}
+		database.Exec("END");
+
+		return changeSet;
+	}
+
+	// Processes the changes reported by the watcher, or periodically scans the search paths if they can't be watched
+	void m_CheckChangedFiles()
+	{
+		bool overflow = false;
+		Vector<String> changes = m_watcher.GetChanges(overflow);
+		for(String& path : changes)
+			m_changedPaths.Add(path);
+		if(overflow)
+		{
+			Logf("Missed changes to the map folders, scanning all maps again", Logger::Warning);
+			m_rescanPending = true;
+		}
+		if(m_scanComplete && !m_watcher.IsWatching() && m_pollTimer.SecondsAsFloat() > m_pollInterval)
+			m_rescanPending = true;
+
+		// Wait for the current scan and its changes to be processed first, they are compared against the current map index
+		if(m_searching || m_loading || m_IsChangePending())
+			return;
+		if(m_searchPending)
+		{
+			StartSearching();
+			return;
+		}
+		if(!m_rescanPending && m_changedPaths.empty())
+			return;
+
+		if(m_thread.joinable())
+			m_thread.join();
+
+		if(m_rescanPending)
+		{
+			m_ResetSearchState();
+			m_watcher.Clear();
+			m_changedPaths.clear();
+			m_rescanPending = false;
+			m_StartThread(&MapDatabase_Impl::m_SearchThread);
+			return;
+		}
+
+		// The changed paths are checked on the update thread against the difficulties currently in the map index
+		m_ApplySearchStateChanges();
+		m_updatePaths.clear();
+		for(const String& path : m_changedPaths)
+			m_updatePaths.Add(path);
+		m_changedPaths.clear();
+		m_StartThread(&MapDatabase_Impl::m_UpdateThread);
+	}
+	// Checks if a file or any of the folders containing it was removed
+	bool m_IsPathRemoved(String path, const Set<String>& removedPaths)
+	{
+		while(true)
+		{
+			if(removedPaths.Contains(path))
+				return true;
+			String parent = Path::RemoveLast(path);
+			if(parent == path)
+				return false;
+			path = parent;
+		}
+	}
+
+	// Creates the full text search index if it doesn't exist yet
+	//	FTS5 is an optional part of sqlite, so the linked library is checked for it first
+	void m_InitSearchIndex()
+	{
+		DBStatement fts5Query = m_database.Query("SELECT sqlite_compileoption_used('ENABLE_FTS5')");
+		bool hasFts5 = fts5Query && fts5Query.StepRow() && fts5Query.IntColumn(0) != 0;
+		fts5Query.Finish();
+		if(!hasFts5)
+		{
+			Logf("Full text search is not available, falling back to slower map searches", Logger::Warning);
+			return;
+		}
+
+		DBStatement tableQuery = m_database.Query("SELECT name FROM sqlite_master WHERE type='table' AND name='MapSearch'");
+		bool tableExists = tableQuery && tableQuery.StepRow();
+		tableQuery.Finish();
+
+		if(!tableExists)
+		{
+			if(!m_database.Exec("CREATE VIRTUAL TABLE MapSearch USING fts5(title, artist, effector, tags, mapid UNINDEXED)"))
+			{
+				Logf("Full text search is not available, falling back to slower map searches", Logger::Warning);
+				return;
+			}
+		}
+
+		m_hasSearchIndex = true;
+
+		// Index existing difficulties
+		if(!tableExists)
+		{
+			m_database.Exec("BEGIN");
+			DBStatement diffScan = m_database.Query("SELECT rowid,metadata,mapid FROM Difficulties");
+			while(diffScan.StepRow())
+			{
+				BeatmapSettings settings;
+				Buffer metadata = diffScan.BlobColumn(1);
+				MemoryReader metadataReader(metadata);
+				metadataReader.SerializeObject(settings);
+				m_AddSearchEntry(m_database, diffScan.IntColumn(0), diffScan.IntColumn(2), settings);
+			}
+			diffScan.Finish();
+			m_database.Exec("END");
+		}
+	}
+	void m_AddSearchEntry(Database& database, int32 diffId, int32 mapId, const BeatmapSettings& settings)
+	{
+		if(!m_hasSearchIndex)
+			return;
+		DBStatement& addSearchEntry = database.GetCachedStatement("INSERT INTO MapSearch(rowid,title,artist,effector,tags,mapid) VALUES(?,?,?,?,?,?)");
+		addSearchEntry.BindInt(1, diffId);
+		addSearchEntry.BindString(2, settings.title);
+		addSearchEntry.BindString(3, settings.artist);
+		addSearchEntry.BindString(4, settings.effector);
+		addSearchEntry.BindString(5, settings.tags);
+		addSearchEntry.BindInt(6, mapId);
+		addSearchEntry.Step();
+		addSearchEntry.Rewind();
+	}
+	void m_RemoveSearchEntry(Database& database, int32 diffId)
+	{
+		if(!m_hasSearchIndex)
+			return;
+		DBStatement& removeSearchEntry = database.GetCachedStatement("DELETE FROM MapSearch WHERE rowid=?");
+		removeSearchEntry.BindInt(1, diffId);
+		removeSearchEntry.Step();
+		removeSearchEntry.Rewind();
+	}
+
+	// Returns the id's of maps of which the artist, title, effector or tags match all space separated terms
+	Vector<int32> m_QueryMapIds(Database& database, const String& searchString)
+	{
+		Vector<String> terms;
+		for(String& term : searchString.Explode(" "))
+		{
+			if(!term.empty())
+				terms.Add(term);
+		}
+
+		Vector<int32> mapIds;
+		if(terms.empty())
+			return mapIds;
+
+		String query;
+		if(m_hasSearchIndex)
+		{
+			query = "SELECT DISTINCT mapid FROM MapSearch WHERE MapSearch MATCH ?";
+		}
+		else
+		{
+			query = "SELECT rowid FROM Maps WHERE";
+			for(size_t i = 0; i < terms.size(); i++)
+			{
+				if(i > 0)
+					query += " AND";
+				query += Utility::Sprintf(" (artist LIKE ?%d OR title LIKE ?%d OR path LIKE ?%d OR tags LIKE ?%d)", i + 1, i + 1, i + 1, i + 1);
+			}
+		}
+		DBStatement& search = database.GetCachedStatement(query);
+		if(!search)
+			return mapIds;
+
+		if(m_hasSearchIndex)
+		{
+			// Every term has to match the start of a word, terms are quoted so they are not parsed as query syntax
+			String match;
+			for(const String& term : terms)
+			{
+				String quoted;
+				for(char c : term)
+				{
+					if(c == '"')
+						quoted += '"';
+					quoted += c;
+				}
+				match += "\"" + quoted + "\"* ";
+			}
+			search.BindString(1, match);
+		}
+		else
+		{
+			for(size_t i = 0; i < terms.size(); i++)
+				search.BindString((int32)i + 1, "%" + terms[i] + "%");
+		}
+
+		while(search.StepRow())
+			mapIds.Add(search.IntColumn(0));
+		search.Rewind();
+		return mapIds;
+	}
+	Map<int32, MapIndex*> m_GetMapsById(const Vector<int32>& mapIds)
+	{
+		Map<int32, MapIndex*> res;
+		for(int32 id : mapIds)
+		{
+			MapIndex** map = m_maps.Find(id);
+			if(map)
+				res.Add(id, *map);
+		}
+		return res;
+	}
+
+	// Passes the results of the latest search to OnFoundMaps
+	void m_DispatchSearchResults()
+	{
+		Vector<int32> mapIds;
+		{
+			lock_guard<mutex> lock(m_searchLock);
+			if(!m_hasSearchResult)
+				return;
+			m_hasSearchResult = false;
+			// Drop results of outdated searches
+			if(m_searchResultGeneration != m_searchGeneration)
+				return;
+			mapIds = std::move(m_searchResult);
+		}
+		m_outer.OnFoundMaps.Call(m_GetMapsById(mapIds));
+	}
+	// Thread that runs requested searches on a separate database connection
+	void m_SearchMapsThread()
+	{
+		// Requests still get an empty result if the database can't be opened, so that searches don't stay pending
+		Database database;
+		bool opened = database.Open(m_databasePath);
+		if(opened)
+			database.Exec("PRAGMA busy_timeout=1000");
+		else
+			Logf("Failed to open database for searching [%s]", Logger::Warning, m_databasePath);
+
+		unique_lock<mutex> lock(m_searchLock);
+		uint64 processedGeneration = 0;
+		while(true)
+		{
+			m_searchRequested.wait(lock, [&]() { return m_exitSearchThread || m_searchGeneration != processedGeneration; });
+			if(m_exitSearchThread)
+				break;
+
+			// Only the latest request is processed
+			processedGeneration = m_searchGeneration;
+			String searchString = m_searchRequest;
+			lock.unlock();
+
+			Vector<int32> mapIds;
+			if(opened)
+				mapIds = m_QueryMapIds(database, searchString);
+
+			lock.lock();
+			if(processedGeneration == m_searchGeneration)
+			{
+				m_searchResult = std::move(mapIds);
+				m_searchResultGeneration = processedGeneration;
+				m_hasSearchResult = true;
+			}
+		}
+	}
+
 	void m_CleanupMapIndex()
 	{
 		for(auto m : m_maps)
@@ -431,83 +1033,326 @@ private:
 	{
 		m_database.Exec("DROP TABLE IF EXISTS Maps");
 		m_database.Exec("DROP TABLE IF EXISTS Difficulties");
+		m_database.Exec("DROP TABLE IF EXISTS MapSearch");
 
 		m_database.Exec("CREATE TABLE Maps"
 			"(artist TEXT, title TEXT, tags TEXT, path TEXT)");
 		m_database.Exec("CREATE TABLE Difficulties"
-			"(metadata BLOB, path TEXT, lwt INTEGER, mapid INTEGER,"
+			"(metadata BLOB, path TEXT, lwt INTEGER, hash INTEGER, mapid INTEGER,"
+			"numNotes INTEGER, numButtons INTEGER, numHolds INTEGER, numLasers INTEGER, maxNotesPerSecond INTEGER,"
+			"minBPM REAL, maxBPM REAL, duration INTEGER, density BLOB,"
 			"FOREIGN KEY(mapid) REFERENCES Maps(rowid))");
+		// Indices for sorting and filtering by chart analytics
+		m_database.Exec("CREATE INDEX DifficultiesByNotes ON Difficulties(numNotes)");
+		m_database.Exec("CREATE INDEX DifficultiesByDensity ON Difficulties(maxNotesPerSecond)");
+		m_database.Exec("CREATE INDEX DifficultiesByMinBPM ON Difficulties(minBPM)");
+		m_database.Exec("CREATE INDEX DifficultiesByMaxBPM ON Difficulties(maxBPM)");
+		m_database.Exec("CREATE INDEX DifficultiesByDuration ON Difficulties(duration)");
 	}
-	void m_LoadInitialData()
+	// Creates the data set to compare to when evaluating if a file is added/removed/updated
+	void m_ResetSearchState()
 	{
-		assert(!m_searching);
-
-		// Clear search state
 		m_searchState.difficulties.clear();
-
-		// Scan original maps
-		m_CleanupMapIndex();
-
-		// Select Maps
-		DBStatement mapScan = m_database.Query("SELECT rowid,path FROM Maps");
-		while(mapScan.StepRow())
+		m_searchState.changes.clear();
+		for(auto& diff : m_difficulties)
+		{
+			SearchState::ExistingDifficulty existing;
+			existing.id = diff.first;
+			existing.lwt = diff.second->lwt;
+			existing.hash = diff.second->hash;
+			m_searchState.difficulties.Add(diff.second->GetPath(), existing);
+		}
+	}
+	// Records a difficulty changed by Update, so only the changed difficulties have to be compared again after a scan
+	void m_AddSearchStateChange(DifficultyIndex* diff, bool removed)
+	{
+		SearchState::Change& change = m_searchState.changes.Add();
+		change.path = diff->GetPath();
+		change.difficulty.id = diff->id;
+		change.difficulty.lwt = diff->lwt;
+		change.difficulty.hash = diff->hash;
+		change.removed = removed;
+	}
+	// Brings the search state up to date with the map index, should only be called while no scan is running
+	void m_ApplySearchStateChanges()
+	{
+		for(SearchState::Change& change : m_searchState.changes)
 		{
-			MapIndex* map = new MapIndex();
-			map->id = mapScan.IntColumn(0);
-			map->path = mapScan.StringColumn(1);
-			m_maps.Add(map->id, map);
-			m_mapsByPath.Add(map->path, map);
+			if(change.removed)
+				m_searchState.difficulties.erase(change.path);
+			else
+				m_searchState.difficulties[change.path] = change.difficulty;
 		}
-		m_nextMapId = m_maps.empty() ? 1 : (m_maps.rbegin()->first + 1);
+		m_searchState.changes.clear();
+	}
+
+	// Starts loading the map index from the database
+	void m_StartLoading()
+	{
+		m_loading = true;
+		m_loadFinished = false;
+		m_interruptLoad = false;
+		m_loadMapCount = 0;
+		m_loadThread = thread(&MapDatabase_Impl::m_LoadThread, this);
+	}
+	// Reads all maps and difficulties, without their metadata, and passes them on in pages
+	void m_LoadThread()
+	{
+		ProfilerScope $("Map Database - Load Maps");
 
-		// Select Difficulties
-		DBStatement diffScan = m_database.Query("SELECT rowid,path,lwt,metadata,mapid FROM Difficulties");
-		while(diffScan.StepRow())
+		Database database;
+		if(database.Open(m_databasePath))
 		{
-			DifficultyIndex* diff = new DifficultyIndex();
-			diff->id = diffScan.IntColumn(0);
-			diff->path = diffScan.StringColumn(1);
-			diff->lwt = diffScan.Int64Column(2);
-			Buffer metadata = diffScan.BlobColumn(3);
-			diff->mapId = diffScan.IntColumn(4);
-			MemoryReader metadataReader(metadata);
-			metadataReader.SerializeObject(diff->settings);
+			database.Exec("PRAGMA busy_timeout=1000");
 
-			// Add existing diff
-			m_difficulties.Add(diff->id, diff);
+			// The total is shown before all maps are loaded
+			DBStatement countQuery = database.Query("SELECT COUNT(*) FROM Maps");
+			if(countQuery.StepRow())
+				m_loadMapCount = countQuery.IntColumn(0);
+			countQuery.Finish();
 
-			SearchState::ExistingDifficulty existing;
-			existing.lwt = diff->lwt;
-			existing.id = diff->id;
-			m_searchState.difficulties.Add(diff->path, existing);
+			// New maps and difficulties are added after the existing ones
+			DBStatement idQuery = database.Query("SELECT (SELECT MAX(rowid) FROM Maps), (SELECT MAX(rowid) FROM Difficulties)");
+			if(idQuery.StepRow())
+			{
+				m_writerState.nextMapId = idQuery.IntColumn(0) + 1;
+				m_writerState.nextDiffId = idQuery.IntColumn(1) + 1;
+			}
+			idQuery.Finish();
 
-			// Add difficulty to map and resort difficulties
-			auto mapIt = m_maps.find(diff->mapId);
-			assert(mapIt != m_maps.end());
-			mapIt->second->difficulties.Add(diff);
-			m_SortDifficulties(mapIt->second);
+			// Both are sorted by map id, so the difficulties of each map follow each other
+			DBStatement mapScan = database.Query("SELECT rowid,path FROM Maps ORDER BY rowid");
+			DBStatement diffScan = database.Query("SELECT rowid,path,lwt,hash,mapid FROM Difficulties ORDER BY mapid,rowid");
+			bool hasDiff = diffScan.StepRow();
 
-			// Add to search state
-			SearchState::ExistingDifficulty ed;
-			ed.id = diff->id;
-			ed.lwt = diff->lwt;
-			m_searchState.difficulties.Add(diff->path, ed);
+			LoadedPage page;
+			while(mapScan.StepRow())
+			{
+				MapIndex* map = new MapIndex();
+				map->id = mapScan.IntColumn(0);
+				map->path = m_strings.Add(mapScan.StringColumn(1));
+				page.maps.Add(map);
+
+				// The writer thread needs to know which maps exist as well
+				WriterState::MapState& mapState = m_writerState.maps[map->id];
+				mapState.path = map->path;
+				m_writerState.mapIds.Add(map->path, map->id);
+
+				// Skip difficulties of maps that don't exist
+				while(hasDiff && diffScan.IntColumn(4) < map->id)
+					hasDiff = diffScan.StepRow();
+				while(hasDiff && diffScan.IntColumn(4) == map->id)
+				{
+					DifficultyIndex* diff = new DifficultyIndex();
+					diff->id = diffScan.IntColumn(0);
+					String fileName;
+					Path::RemoveLast(diffScan.StringColumn(1), &fileName);
+					diff->fileName = m_strings.Add(fileName);
+					diff->lwt = diffScan.Int64Column(2);
+					diff->hash = diffScan.Int64Column(3);
+					diff->mapId = map->id;
+					diff->map = map;
+					diff->metadataLoaded = false;
+					map->difficulties.Add(diff);
+					page.difficulties.Add(diff);
+					mapState.numDifficulties++;
+					m_writerState.difficultyMaps.Add(diff->id, map->id);
+					hasDiff = diffScan.StepRow();
+				}
+
+				if(page.maps.size() >= m_loadPageSize)
+				{
+					lock_guard<mutex> lock(m_loadLock);
+					if(m_interruptLoad)
+						break;
+					m_loadedPages.emplace_back(std::move(page));
+					page = LoadedPage();
+				}
+			}
+
+			m_loadLock.lock();
+			m_loadedPages.emplace_back(std::move(page));
+			m_loadLock.unlock();
+		}
+		else
+		{
+			Logf("Failed to open database for loading [%s]", Logger::Warning, m_databasePath);
 		}
-		m_nextDiffId = m_difficulties.empty() ? 1 : (m_difficulties.rbegin()->first + 1);
 
-		m_outer.OnMapsCleared.Call(m_maps);
+		m_loadLock.lock();
+		m_loadFinished = true;
+		m_loadLock.unlock();
+	}
+	// Adds the maps read by the load thread to the map index
+	void m_AddLoadedPages()
+	{
+		if(!m_loading)
+			return;
+
+		List<LoadedPage> pages;
+		m_loadLock.lock();
+		pages = std::move(m_loadedPages);
+		m_loadedPages.clear();
+		bool finished = m_loadFinished;
+		m_loadLock.unlock();
+
+		for(LoadedPage& page : pages)
+		{
+			for(MapIndex* map : page.maps)
+				m_maps.Add(map->id, map);
+			for(DifficultyIndex* diff : page.difficulties)
+				m_difficulties.Add(diff->id, diff);
+			if(!page.maps.empty())
+				m_outer.OnMapsAdded.Call(page.maps);
+		}
+
+		if(finished)
+		{
+			m_loadThread.join();
+			m_loading = false;
+		}
+	}
+	void m_DeletePage(LoadedPage& page)
+	{
+		for(MapIndex* map : page.maps)
+			delete map;
+		for(DifficultyIndex* diff : page.difficulties)
+			delete diff;
 	}
 	void m_SortDifficulties(MapIndex* mapIndex)
 	{
 		mapIndex->difficulties.Sort([](DifficultyIndex* a, DifficultyIndex* b)
 		{
-			return a->settings.difficulty < b->settings.difficulty;
+			return a->metadata.difficulty < b->metadata.difficulty;
 		});
 	}
+	// Creates the metadata stored in the map index, with the strings stored in the string pool
+	DifficultyMetadata m_CreateMetadata(const BeatmapSettings& settings, const BeatmapAnalytics& analytics)
+	{
+		DifficultyMetadata metadata;
+		metadata.title = m_strings.Add(settings.title);
+		metadata.artist = m_strings.Add(settings.artist);
+		metadata.effector = m_strings.Add(settings.effector);
+		metadata.illustrator = m_strings.Add(settings.illustrator);
+		metadata.jacketPath = m_strings.Add(settings.jacketPath);
+		metadata.audioNoFX = m_strings.Add(settings.audioNoFX);
+		metadata.previewOffset = settings.previewOffset;
+		metadata.level = settings.level;
+		metadata.difficulty = settings.difficulty;
+		metadata.analytics = analytics;
+		return metadata;
+	}
+
+	// Columns of the Difficulties table that store the chart analytics, in the order used by m_BindAnalytics and m_ReadAnalytics
+	static constexpr const char* m_analyticsColumns =
+		"numNotes,numButtons,numHolds,numLasers,maxNotesPerSecond,minBPM,maxBPM,duration,density";
+	static void m_BindAnalytics(DBStatement& statement, int32 firstIndex, const BeatmapAnalytics& analytics)
+	{
+		Buffer density;
+		density.resize(sizeof(analytics.density));
+		memcpy(density.data(), analytics.density, sizeof(analytics.density));
+
+		statement.BindInt(firstIndex, analytics.GetNumNotes());
+		statement.BindInt(firstIndex + 1, analytics.numButtons);
+		statement.BindInt(firstIndex + 2, analytics.numHolds);
+		statement.BindInt(firstIndex + 3, analytics.numLasers);
+		statement.BindInt(firstIndex + 4, analytics.maxNotesPerSecond);
+		statement.BindDouble(firstIndex + 5, analytics.minBPM);
+		statement.BindDouble(firstIndex + 6, analytics.maxBPM);
+		statement.BindInt(firstIndex + 7, analytics.duration);
+		statement.BindBlob(firstIndex + 8, density);
+	}
+	static BeatmapAnalytics m_ReadAnalytics(DBStatement& statement, int32 firstIndex)
+	{
+		BeatmapAnalytics analytics;
+		analytics.numButtons = statement.IntColumn(firstIndex + 1);
+		analytics.numHolds = statement.IntColumn(firstIndex + 2);
+		analytics.numLasers = statement.IntColumn(firstIndex + 3);
+		analytics.maxNotesPerSecond = statement.IntColumn(firstIndex + 4);
+		analytics.minBPM = statement.DoubleColumn(firstIndex + 5);
+		analytics.maxBPM = statement.DoubleColumn(firstIndex + 6);
+		analytics.duration = statement.IntColumn(firstIndex + 7);
+		Buffer density = statement.BlobColumn(firstIndex + 8);
+		if(density.size() == sizeof(analytics.density))
+			memcpy(analytics.density, density.data(), sizeof(analytics.density));
+		return analytics;
+	}
+
+	// A file found by the search thread that needs to have its metadata read
+	struct ScanItem
+	{
+		String path;
+		uint64 lwt;
+		// Id of the difficulty if it is already in the database, 0 otherwise
+		int32 existingId = 0;
+		// Content hash of the difficulty in the database
+		uint64 existingHash = 0;
+	};
+
+	// Changed paths reported by the watcher, checked by the update thread
+	Vector<String> m_updatePaths;
+
+	// Reads the metadata for a scanned file and creates the change event for it
+	//	returns false if the file is a new map that could not be read
+	bool m_ReadMetadata(const ScanItem& item, Event& evt)
+	{
+		evt.path = item.path;
+		evt.lwt = item.lwt;
+		evt.id = item.existingId;
+		evt.action = item.existingId ? Event::Updated : Event::Added;
+
+		// Read the whole file at once, its contents are hashed before reading the metadata
+		File fileStream;
+		Buffer contents;
+		if(fileStream.OpenRead(item.path))
+		{
+			contents.resize(fileStream.GetSize());
+			contents.resize(fileStream.Read(contents.data(), contents.size()));
+			fileStream.Close();
+			evt.hash = Hash::XXHash64(contents.data(), contents.size());
+
+			// Only the last write time changed, for example after restoring or copying the file
+			if(item.existingId && evt.hash == item.existingHash)
+				return true;
+
+			// Read the whole chart to calculate its analytics
+			Beatmap map;
+			MemoryReader reader(contents);
+			if(map.Load(reader))
+			{
+				evt.mapData = new BeatmapSettings(map.GetMapSettings());
+				evt.analytics = map.GetAnalytics();
+				return true;
+			}
+
+			// Still show charts of which only the metadata can be read
+			Beatmap metadataMap;
+			reader.Seek(0);
+			if(metadataMap.Load(reader, true))
+			{
+				evt.mapData = new BeatmapSettings(metadataMap.GetMapSettings());
+				return true;
+			}
+		}
+
+		// Never added
+		if(!item.existingId)
+			return false;
+
+		// Invalid maps get removed from the database
+		evt.action = Event::Removed;
+		return true;
+	}
 
 	// Main search thread
 	void m_SearchThread()
 	{
+		m_scanComplete = false;
+
+		// Start watching before enumerating files, so that no changes are missed
+		for(const String& rootSearchPath : m_searchPaths)
+			m_watcher.Watch(rootSearchPath);
+
 		Map<String, FileInfo> fileList;
 
 		{
@@ -541,81 +1386,166 @@ private:
 			}
 		}
 
+		// Files that are new or changed since the last scan
+		Vector<ScanItem> scanItems;
+		for(auto f : fileList)
+		{
+			ScanItem item;
+			item.path = f.first;
+			item.lwt = f.second.lastWriteTime;
+			SearchState::ExistingDifficulty* existing = m_searchState.difficulties.Find(f.first);
+			if(existing)
+			{
+				// Skip, not changed
+				if(existing->lwt == item.lwt)
+					continue;
+				item.existingId = existing->id;
+				item.existingHash = existing->hash;
+			}
+			scanItems.Add(item);
+		}
+
 		{
 			ProfilerScope $("Map Database - Process New Files");
+			m_ProcessScanItems(scanItems);
+		}
+		m_scanComplete = !m_interruptSearch;
+		m_searching = false;
+	}
 
-			// Process scanned files
-			for(auto f : fileList)
+	// Thread that reads the files reported by the watcher
+	void m_UpdateThread()
+	{
+		// Find the charts that need to be read again
+		Set<String> removedPaths;
+		Map<String, ScanItem> scanItems;
+		for(const String& path : m_updatePaths)
+		{
+			if(Path::IsDirectory(path))
 			{
-				if(!m_searching)
-					break;
-
-				uint64 mylwt = f.second.lastWriteTime;
-				Event evt;
-				evt.lwt = mylwt;
+				for(FileInfo& file : Files::ScanFilesRecursive(path, "ksh", &m_interruptSearch))
+				{
+					ScanItem& item = scanItems[file.fullPath];
+					item.path = file.fullPath;
+					item.lwt = file.lastWriteTime;
+				}
+			}
+			else if(Path::FileExists(path))
+			{
+				if(Path::GetExtension(path) != "ksh")
+					continue;
+				ScanItem& item = scanItems[path];
+				item.path = path;
+				item.lwt = File::GetLastWriteTime(path);
+			}
+			else
+			{
+				removedPaths.Add(path);
+			}
+		}
 
-				SearchState::ExistingDifficulty* existing = m_searchState.difficulties.Find(f.first);
-				if(existing)
+		// Compare against the existing difficulties
+		for(auto& diff : m_searchState.difficulties)
+		{
+			auto it = scanItems.find(diff.first);
+			if(it != scanItems.end())
+			{
+				if(it->second.lwt == diff.second.lwt)
 				{
-					evt.id = existing->id;
-					if(existing->lwt != mylwt)
-					{
-						// Map Updated
-						evt.action = Event::Updated;
-					}
-					else
-					{
-						// Skip, not changed
-						continue;
-					}
+					scanItems.erase(it); // Not changed
 				}
 				else
 				{
-					// Map added
-					evt.action = Event::Added;
+					it->second.existingId = diff.second.id;
+					it->second.existingHash = diff.second.hash;
 				}
+			}
+			else if(m_IsPathRemoved(diff.first, removedPaths))
+			{
+				Event evt;
+				evt.action = Event::Removed;
+				evt.path = diff.first;
+				evt.id = diff.second.id;
+				AddChange(evt);
+			}
+		}
 
-				Logf("Discovered Map [%s]", Logger::Info, f.first);
-
-				// Try to read map metadata
-				bool mapValid = false;
-				File fileStream;
-				Beatmap map;
-				if(fileStream.OpenRead(f.first))
-				{
-					FileReader reader(fileStream);
+		Vector<ScanItem> updateItems;
+		for(auto& item : scanItems)
+			updateItems.Add(item.second);
+		m_ProcessScanItems(updateItems);
+		// Not all changes were processed
+		if(m_interruptSearch)
+			m_scanComplete = false;
+		m_searching = false;
+	}
 
-					if(map.Load(reader, true))
-					{
-						mapValid = true;
-					}
-				}
+	// Reads the metadata of the given files on multiple threads and adds the resulting changes
+	void m_ProcessScanItems(const Vector<ScanItem>& scanItems)
+	{
+		uint32 numThreads = m_scanThreadCount;
+		if(numThreads == 0)
+			numThreads = Math::Max(1u, thread::hardware_concurrency());
+		numThreads = (uint32)Math::Min<size_t>(numThreads, Math::Max<size_t>(1, scanItems.size()));
+
+		// Every thread reads the metadata of the next unprocessed file until all are processed
+		atomic<size_t> nextItem(0);
+		// Files that were touched without changing their contents
+		atomic<size_t> numUnchanged(0);
+		Vector<Vector<String>> skippedFiles(numThreads);
+		auto scanWorker = [&](uint32 threadIndex)
+		{
+			List<Event> batch;
+			while(!m_interruptSearch)
+			{
+				size_t index = nextItem++;
+				if(index >= scanItems.size())
+					break;
 
-				if(mapValid)
+				Event evt;
+				if(m_ReadMetadata(scanItems[index], evt))
 				{
-					evt.mapData = new BeatmapSettings(map.GetMapSettings());
+					if(evt.action == Event::Updated && !evt.mapData)
+						numUnchanged++;
+					batch.push_back(evt);
 				}
 				else
-				{
-					if(!existing) // Never added
-					{
-						Logf("Skipping corrupted map [%s]", Logger::Warning, f.first);
-						continue;
-					}
-					// Invalid maps get removed from the database
-					evt.action = Event::Removed;
-				}
-				evt.path = f.first;
-				AddChange(evt);
-				continue;
+					skippedFiles[threadIndex].Add(scanItems[index].path);
+
+				if(batch.size() >= m_scanBatchSize)
+					AddChanges(batch);
 			}
+			AddChanges(batch);
+		};
+
+		Timer timer;
+		Vector<thread> workers;
+		for(uint32 i = 1; i < numThreads; i++)
+			workers.emplace_back(scanWorker, i);
+		scanWorker(0);
+		for(thread& worker : workers)
+			worker.join();
+
+		for(auto& files : skippedFiles)
+		{
+			for(auto& file : files)
+				Logf("Skipping corrupted map [%s]", Logger::Warning, file);
+		}
+		if(!scanItems.empty())
+		{
+			Logf("Read metadata of %d maps in %.2f s using %d threads, %d were unchanged", Logger::Info,
+				(int32)scanItems.size(), timer.SecondsAsDouble(), numThreads, (int32)numUnchanged.load());
 		}
-		m_searching = false;
 	}
 };
-MapDatabase::MapDatabase()
+String DifficultyIndex::GetPath() const
 {
-	m_impl = new MapDatabase_Impl(*this);
+	return String(map->path) + Path::sep + fileName;
+}
+
+MapDatabase::MapDatabase(const String& databasePath)
+{
+	m_impl = new MapDatabase_Impl(*this, databasePath);
 }
 MapDatabase::~MapDatabase()
 {
@@ -627,7 +1557,19 @@ void MapDatabase::Update()
 }
 bool MapDatabase::IsSearching() const
 {
-	return m_impl->m_searching;
+	return m_impl->IsSearching();
+}
+bool MapDatabase::IsLoading() const
+{
+	return m_impl->IsLoading();
+}
+size_t MapDatabase::GetMapCount() const
+{
+	return m_impl->GetMapCount();
+}
+void MapDatabase::LoadMetadata(MapIndex* map)
+{
+	m_impl->LoadMetadata(map);
 }
 void MapDatabase::StartSearching()
 {
@@ -637,10 +1579,30 @@ void MapDatabase::StopSearching()
 {
 	m_impl->StopSearching();
 }
+bool MapDatabase::IsWatching() const
+{
+	return m_impl->IsWatching();
+}
+void MapDatabase::SetScanThreadCount(uint32 numThreads)
+{
+	m_impl->m_scanThreadCount = numThreads;
+}
 Map<int32, MapIndex*> MapDatabase::FindMaps(const String& search)
 {
 	return m_impl->FindMaps(search);
 }
+void MapDatabase::FindMapsAsync(const String& search)
+{
+	m_impl->FindMapsAsync(search);
+}
+bool MapDatabase::IsFindingMaps() const
+{
+	return m_impl->IsFindingMaps();
+}
+Map<int32, MapIndex*> MapDatabase::GetMaps()
+{
+	return m_impl->m_maps;
+}
 MapIndex* MapDatabase::GetMap(int32 idx)
 {
 	MapIndex** mapIdx = m_impl->m_maps.Find(idx);
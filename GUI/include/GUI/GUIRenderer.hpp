@@ -33,6 +33,9 @@ public:
 	void SetWindow(Graphics::Window* window);
 	Graphics::Window* GetWindow() const;
 
+	// Arena for data that is only needed while rendering the current frame
+	FrameArena& GetFrameArena();
+
 	void PushScissorRect(const Rect& scissor);
 	void PopScissorRect();
 	Rect GetScissorRect() const;
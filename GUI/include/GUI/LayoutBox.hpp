@@ -13,7 +13,8 @@ public:
 	virtual Vector2 GetDesiredSize(GUIRenderData rd) override;
 
 	// Calculates child element sizes based on the current settings
-	Vector<float> CalculateSizes(const GUIRenderData& rd) const;
+	//	the returned array has one entry for every child and is allocated in the frame arena
+	float* CalculateSizes(const GUIRenderData& rd) const;
 
 	enum LayoutDirection
 	{
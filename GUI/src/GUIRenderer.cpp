@@ -116,10 +116,14 @@ Graphics::RenderQueue& GUIRenderer::Begin()
 	guiRs.projectionTransform = ProjectionMatrix::CreateOrthographic(0, windowSize.x, windowSize.y, 0.0f, -1.0f, 100.0f);
 	guiRs.aspectRatio = windowSize.y / windowSize.x;
 	guiRs.time = m_time;
-	m_renderQueue = new RenderQueue(m_gl, guiRs);
+	m_renderQueue = m_gl->GetFrameArena().New<RenderQueue>(m_gl, guiRs);
 
 	return *m_renderQueue;
 }
+FrameArena& GUIRenderer::GetFrameArena()
+{
+	return m_gl->GetFrameArena();
+}
 void GUIRenderer::End()
 {
 	// Must have called Begin
@@ -135,7 +139,7 @@ void GUIRenderer::End()
 	// Verify if scissor rectangle state was correctly restored
 	assert(m_scissorRectangles.empty());
 
-	delete m_renderQueue;
+	m_renderQueue->~RenderQueue();
 	m_renderQueue = nullptr;
 
 	// Reset face culling mode
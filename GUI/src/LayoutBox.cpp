@@ -17,7 +17,7 @@ void LayoutBox::PreRender(GUIRenderData rd, GUIElementBase*& inputElement)
 	m_TickAnimations(rd.deltaTime);
 
 	Rect sourceRect = rd.area;
-	Vector<float> elementSizes = CalculateSizes(rd);
+	float* elementSizes = CalculateSizes(rd);
 
 	float offset = 0.0f;
 	for(size_t i = 0; i < m_children.size(); i++)
@@ -104,7 +104,7 @@ void LayoutBox::Remove(GUIElement element)
 	}
 }
 
-Vector<float> LayoutBox::CalculateSizes(const GUIRenderData& rd) const
+float* LayoutBox::CalculateSizes(const GUIRenderData& rd) const
 {
 	// Combined size of everything
 	float minSize = 0.0f;
@@ -139,8 +139,8 @@ Vector<float> LayoutBox::CalculateSizes(const GUIRenderData& rd) const
 		fixedSize *= fixedScale;
 	}
 
-	float offset = 0.0f;
-	Vector<float> ret;
+	float* ret = rd.guiRenderer->GetFrameArena().NewArray<float>(m_children.size());
+	float* out = ret;
 	for(auto it = m_children.begin(); it != m_children.end(); it++)
 	{
 		Vector2 size = (*it)->GetDesiredSize(rd);
@@ -156,7 +156,7 @@ Vector<float> LayoutBox::CalculateSizes(const GUIRenderData& rd) const
 		{
 			mySize = currentSize * fixedScale;
 		}
-		ret.Add(mySize);
+		*out++ = mySize;
 	}
 
 	return ret;
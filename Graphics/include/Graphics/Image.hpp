@@ -12,6 +12,8 @@ namespace Graphics
 	public:
 		virtual ~ImageRes() = default;
 		static Ref<ImageRes> Create(const String& assetPath);
+		// Creates an image from the contents of an image file
+		static Ref<ImageRes> Create(Buffer& data);
 		static Ref<ImageRes> Create(Vector2i size = Vector2i());
 	public:
 		virtual void SetSize(Vector2i size) = 0;
@@ -13,5 +13,7 @@ namespace Graphics
 	{
 	public:
 		static bool Load(ImageRes* outPtr, const String& fullPath);
+		// Loads an image from the contents of an image file
+		static bool Load(ImageRes* outPtr, Buffer& data);
 	};
 }
\ No newline at end of file
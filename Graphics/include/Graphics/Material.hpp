@@ -46,10 +46,10 @@ namespace Graphics
 		A list of parameters that is set for a material
 		use SetParameter(name, param) to set any parameter by name
 	*/
-	class MaterialParameterSet : public Map<String, MaterialParameter>
+	class MaterialParameterSet : public FlatHashMap<String, MaterialParameter>
 	{
 	public:
-		using Map<String, MaterialParameter>::Map;
+		using FlatHashMap<String, MaterialParameter>::FlatHashMap;
 		void SetParameter(const String& name, float sc);
 		void SetParameter(const String& name, const Vector4& vec);
 		void SetParameter(const String& name, const Colori& color);
@@ -59,6 +59,23 @@ namespace Graphics
 		void SetParameter(const String& name, Ref<class TextureRes> tex);
 	};
 
+	/*
+		Flat list of material parameters used by the render queue
+		the names and data are stored in the frame arena so queued draw calls don't need to copy a parameter set
+	*/
+	struct MaterialParameterList
+	{
+		struct Entry
+		{
+			const char* name;
+			uint32 nameLength;
+			const void* data;
+			uint32 parameterType;
+		};
+		Entry* entries = nullptr;
+		uint32 count = 0;
+	};
+
 	enum class MaterialBlendMode
 	{
 		Normal,
@@ -84,9 +101,11 @@ namespace Graphics
 	public:
 		virtual void AssignShader(ShaderType t, Shader shader) = 0;
 		virtual void Bind(const RenderState& rs, const MaterialParameterSet& params = MaterialParameterSet()) = 0;
+		virtual void Bind(const RenderState& rs, const MaterialParameterList& params) = 0;
 
 		// Only binds parameters to the current shader
 		virtual void BindParameters(const MaterialParameterSet& params, const Transform& worldTransform) = 0;
+		virtual void BindParameters(const MaterialParameterList& params, const Transform& worldTransform) = 0;
 
 		// Bind only shaders/pipeline to context
 		virtual void BindToContext() = 0;
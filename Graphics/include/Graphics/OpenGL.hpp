@@ -1,6 +1,7 @@
 #pragma once
 #include <Graphics/GL.hpp>
 #include <Graphics/Window.hpp>
+#include <Shared/FrameArena.hpp>
 
 namespace Graphics
 {
@@ -20,6 +21,7 @@ namespace Graphics
 		class OpenGL_Impl* m_impl;
 		Window* m_window;
 		class FramebufferRes* m_boundFramebuffer;
+		FrameArena m_frameArena;
 
 		friend class ShaderRes;
 		friend class TextureRes;
@@ -42,6 +44,9 @@ namespace Graphics
 		// Check if the calling thread is the thread that runs this OpenGL context
 		bool IsOpenGLThread() const;
 
+		// Arena for transient render data like queued draw calls, it is reset every time the buffers are swapped
+		FrameArena& GetFrameArena();
+
 		virtual void SwapBuffers();
 	};
 }
\ No newline at end of file
@@ -24,7 +24,7 @@ namespace Graphics
 		Mesh mesh;
 		// Material to use
 		Material mat;
-		MaterialParameterSet params;
+		MaterialParameterList params;
 		// The world transform
 		Transform worldTransform; 
 		// Scissor rectangle
@@ -38,7 +38,7 @@ namespace Graphics
 		// List of points/lines
 		Mesh mesh;
 		Material mat;
-		MaterialParameterSet params;
+		MaterialParameterList params;
 		float size;
 	};
 
@@ -47,10 +47,13 @@ namespace Graphics
 		each of these is stored together with their wanted render state.
 
 		When Process is called, the commands are sorted and grouped, then sent to the graphics pipeline.
+		The commands and their parameters are allocated from the frame arena of the OpenGL object,
+		so a queue has to be processed or cleared before the buffers are swapped.
 	*/
 	class RenderQueue : public Unique
 	{
 	public:
+		// Creates an empty queue, commands can only be added to queues created with an OpenGL object
 		RenderQueue() = default;
 		RenderQueue(OpenGL* ogl, const RenderState& rs);
 		RenderQueue(RenderQueue&& other);
@@ -69,6 +72,9 @@ namespace Graphics
 		void DrawPoints(Mesh m, Material mat, const MaterialParameterSet& params, float pointSize);
 
 	private:
+		// Copies the parameters into the frame arena, space for extra entries is added at the end of the list
+		MaterialParameterList m_CopyParameters(const MaterialParameterSet& params, uint32 numExtraEntries = 0);
+
 		RenderState m_renderState;
 		Vector<RenderQueueItem*> m_orderedCommands;
 		class OpenGL* m_ogl = nullptr;
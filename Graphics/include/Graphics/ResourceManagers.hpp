@@ -38,6 +38,8 @@ namespace Graphics
 
 		static void SuspendGC();
 		static void ContinueGC();
+		// Releases the resources that were found to be unused during the previous ticks, then checks resources for a limited amount of time
+		//	should be called at a point in the frame where no resources are in use by the renderer
 		static void TickAll();
 
 	private:
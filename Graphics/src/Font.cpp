@@ -18,7 +18,7 @@ namespace Graphics
 		float lastUsage;
 	};
 	// Prevents continuous recreation of text that doesn't change
-	class TextCache : public Map<WString, CachedText>
+	class TextCache : public FlatHashMap<WString, CachedText>
 	{
 		Timer timer;
 	public:
@@ -85,7 +85,7 @@ namespace Graphics
 		Texture textureMap;
 		FT_Face face;
 		Vector<CharInfo> infos;
-		Map<wchar_t, uint32> infoByChar;
+		FlatHashMap<wchar_t, uint32> infoByChar;
 		bool bUpdated = false;
 		float lineHeight;
 		TextCache cache;
@@ -184,7 +184,7 @@ namespace Graphics
 		FT_Face m_face;
 		Buffer m_data;
 
-		Map<uint32, FontSize*> m_sizes;
+		FlatHashMap<uint32, FontSize*> m_sizes;
 		uint32 m_currentSize = 0;
 
 		OpenGL* m_gl;
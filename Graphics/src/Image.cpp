@@ -73,4 +73,18 @@ namespace Graphics
 		}
 		return Image();
 	}
+	Image ImageRes::Create(Buffer& data)
+	{
+		Image_Impl* pImpl = new Image_Impl();
+		if(ImageLoader::Load(pImpl, data))
+		{
+			return GetResourceManager<ResourceType::Image>().Register(pImpl);
+		}
+		else
+		{
+			delete pImpl;
+			pImpl = nullptr;
+		}
+		return Image();
+	}
 }
\ No newline at end of file
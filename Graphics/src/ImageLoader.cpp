@@ -127,6 +127,10 @@ namespace Graphics
 
 			Buffer b(f.GetSize());
 			f.Read(b.data(), b.size());
+			return Load(pImage, b);
+		}
+		bool Load(ImageRes* pImage, Buffer& b)
+		{
 			if(b.size() < 4)
 				return false;
 
@@ -149,4 +153,8 @@ namespace Graphics
 	{
 		return ImageLoader_Impl::Main().Load(pImage, fullPath);
 	}
+	bool ImageLoader::Load(ImageRes* pImage, Buffer& data)
+	{
+		return ImageLoader_Impl::Main().Load(pImage, data);
+	}
 }
\ No newline at end of file
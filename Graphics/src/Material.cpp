@@ -57,6 +57,31 @@ namespace Graphics
 	{
 	};
 
+	// Parameter name that is not null terminated, such as the names in a MaterialParameterList
+	struct ParameterName
+	{
+		const char* name;
+		size_t length;
+	};
+	// Allows looking up parameter names without creating a String for every parameter that is bound
+	struct ParameterNameLess
+	{
+		typedef void is_transparent;
+		bool operator()(const String& a, const String& b) const
+		{
+			return a < b;
+		}
+		bool operator()(const String& a, const ParameterName& b) const
+		{
+			return a.compare(0, a.size(), b.name, b.length) < 0;
+		}
+		bool operator()(const ParameterName& a, const String& b) const
+		{
+			return b.compare(0, b.size(), a.name, a.length) > 0;
+		}
+	};
+	typedef std::map<String, uint32, ParameterNameLess> ParameterNameMap;
+
 	// Defined in Shader.cpp
 	extern uint32 shaderStageMap[];
 
@@ -70,8 +95,8 @@ namespace Graphics
 #endif
 		uint32 m_pipeline;
 		Map<uint32, BoundParameterList> m_boundParameters;
-		Map<String, uint32> m_mappedParameters;
-		Map<String, uint32> m_textureIDs;
+		ParameterNameMap m_mappedParameters;
+		ParameterNameMap m_textureIDs;
 		uint32 m_userID = SV_User;
 		uint32 m_textureID = 0;
 
@@ -106,8 +131,8 @@ namespace Graphics
 				if(type == GL_SAMPLER_2D)
 				{
 					typeName = "Sampler2D";
-					if(!m_textureIDs.Contains(name))
-						m_textureIDs.Add(name, m_textureID++);
+					if(m_textureIDs.find(String(name)) == m_textureIDs.end())
+						m_textureIDs.emplace(name, m_textureID++);
 				}
 				else if(type == GL_FLOAT_MAT4)
 				{
@@ -138,10 +163,11 @@ namespace Graphics
 				}
 				else
 				{
-					if(m_mappedParameters.Contains(name))
-						targetID = m_mappedParameters[name];
+					auto it = m_mappedParameters.find(String(name));
+					if(it != m_mappedParameters.end())
+						targetID = it->second;
 					else
-						targetID = m_mappedParameters.Add(name, m_userID++);
+						targetID = m_mappedParameters.emplace(name, m_userID++).first->second;
 				}
 
 				BoundParameterInfo& param = m_boundParameters.FindOrAdd(targetID).Add(BoundParameterInfo(t, type, loc));
@@ -156,6 +182,45 @@ namespace Graphics
 		// Bind render state and params and shaders to context
 		virtual void Bind(const RenderState& rs, const MaterialParameterSet& params) override
 		{
+			BindRenderState(rs);
+			BindParameters(params, rs.worldTransform);
+			BindToContext();
+		}
+		virtual void Bind(const RenderState& rs, const MaterialParameterList& params) override
+		{
+			BindRenderState(rs);
+			BindParameters(params, rs.worldTransform);
+			BindToContext();
+		}
+
+		// Bind only parameters
+		virtual void BindParameters(const MaterialParameterSet& params, const Transform& worldTransform) override
+		{
+			BindAll(SV_World, worldTransform);
+			for(auto& p : params)
+			{
+				BindParameter(p.first.c_str(), p.first.size(), p.second.parameterType, p.second.parameterData.data());
+			}
+		}
+		virtual void BindParameters(const MaterialParameterList& params, const Transform& worldTransform) override
+		{
+			BindAll(SV_World, worldTransform);
+			for(uint32 i = 0; i < params.count; i++)
+			{
+				const MaterialParameterList::Entry& p = params.entries[i];
+				BindParameter(p.name, p.nameLength, p.parameterType, p.data);
+			}
+		}
+
+		virtual void BindToContext()
+		{
+			// Bind pipeline to context
+			glBindProgramPipeline(m_pipeline);
+		}
+
+		// Bind shader variables from the render state
+		void BindRenderState(const RenderState& rs)
+		{
 #if _DEBUG
 			bool reloadedShaders = false;
 			for(uint32 i = 0; i < 3; i++)
@@ -191,82 +256,68 @@ namespace Graphics
 			Transform billboard = CameraMatrix::BillboardMatrix(rs.cameraTransform);
 			BindAll(SV_BillboardMatrix, billboard);
 			BindAll(SV_Time, rs.time);
-			
-			// Bind parameters
-			BindParameters(params, rs.worldTransform);
-
-			BindToContext();
 		}
 
-		// Bind only parameters
-		virtual void BindParameters(const MaterialParameterSet& params, const Transform& worldTransform)
+		// Bind a single parameter, data points to a value of the given GL type
+		void BindParameter(const char* nameData, size_t nameLength, uint32 type, const void* data)
 		{
-			BindAll(SV_World, worldTransform);
-			for(auto p : params)
+			ParameterName name = { nameData, nameLength };
+			switch(type)
+			{
+			case GL_FLOAT:
+				BindAll(name, *(const float*)data);
+				break;
+			case GL_INT_VEC2:
+				BindAll(name, *(const Vector2i*)data);
+				break;
+			case GL_INT_VEC3:
+				BindAll(name, *(const Vector3i*)data);
+				break;
+			case GL_INT_VEC4:
+				BindAll(name, *(const Vector4i*)data);
+				break;
+			case GL_FLOAT_VEC2:
+				BindAll(name, *(const Vector2*)data);
+				break;
+			case GL_FLOAT_VEC3:
+				BindAll(name, *(const Vector3*)data);
+				break;
+			case GL_FLOAT_VEC4:
+				BindAll(name, *(const Vector4*)data);
+				break;
+			case GL_FLOAT_MAT4:
+				BindAll(name, *(const Transform*)data);
+				break;
+			case GL_SAMPLER_2D:
 			{
-				switch(p.second.parameterType)
+				auto textureUnit = m_textureIDs.find(name);
+				if(textureUnit == m_textureIDs.end())
 				{
-				case GL_FLOAT:
-					BindAll(p.first, p.second.Get<float>());
-					break;
-				case GL_INT_VEC2:
-					BindAll(p.first, p.second.Get<Vector2i>());
-					break;
-				case GL_INT_VEC3:
-					BindAll(p.first, p.second.Get<Vector3i>());
-					break;
-				case GL_INT_VEC4:
-					BindAll(p.first, p.second.Get<Vector4i>());
-					break;
-				case GL_FLOAT_VEC2:
-					BindAll(p.first, p.second.Get<Vector2>());
+					/// TODO: Add print once mechanism for these kind of errors
+					//Logf("Texture not found \"%s\"", Logger::Warning, name);
 					break;
-				case GL_FLOAT_VEC3:
-					BindAll(p.first, p.second.Get<Vector3>());
-					break;
-				case GL_FLOAT_VEC4:
-					BindAll(p.first, p.second.Get<Vector4>());
-					break;
-				case GL_FLOAT_MAT4:
-					BindAll(p.first, p.second.Get<Transform>());
-					break;
-				case GL_SAMPLER_2D:
-				{
-					uint32* textureUnit = m_textureIDs.Find(p.first);
-					if(!textureUnit)
-					{
-						/// TODO: Add print once mechanism for these kind of errors
-						//Logf("Texture not found \"%s\"", Logger::Warning, p.first);
-						break;
-					}
-					uint32 texture = p.second.Get<int32>();
+				}
+				uint32 texture = *(const int32*)data;
 
-					// Bind the texture
-					glActiveTexture(GL_TEXTURE0 + *textureUnit);
-					glBindTexture(GL_TEXTURE_2D, texture);
+				// Bind the texture
+				glActiveTexture(GL_TEXTURE0 + textureUnit->second);
+				glBindTexture(GL_TEXTURE_2D, texture);
 
-					// Bind sampler
-					BindAll<int32>(p.first, *textureUnit);
-					break;
-				}
-				default:
-					assert(false);
-				}
+				// Bind sampler
+				BindAll<int32>(name, textureUnit->second);
+				break;
+			}
+			default:
+				assert(false);
 			}
 		}
 
-		virtual void BindToContext()
-		{
-			// Bind pipeline to context
-			glBindProgramPipeline(m_pipeline);
-		}
-
-		BoundParameterInfo* GetBoundParameters(const String& name, uint32& count)
+		BoundParameterInfo* GetBoundParameters(const ParameterName& name, uint32& count)
 		{
-			uint32* mappedID = m_mappedParameters.Find(name);
-			if(!mappedID)
+			auto mappedID = m_mappedParameters.find(name);
+			if(mappedID == m_mappedParameters.end())
 				return nullptr;
-			return GetBoundParameters((BuiltInShaderVariable)*mappedID, count);
+			return GetBoundParameters((BuiltInShaderVariable)mappedID->second, count);
 		}
 		BoundParameterInfo* GetBoundParameters(BuiltInShaderVariable bsv, uint32& count)
 		{
@@ -279,7 +330,7 @@ namespace Graphics
 				return l->data();
 			}
 		}
-		template<typename T> void BindAll(const String& name, const T& obj)
+		template<typename T> void BindAll(const ParameterName& name, const T& obj)
 		{
 			uint32 num = 0;
 			BoundParameterInfo* bp = GetBoundParameters(name, num);
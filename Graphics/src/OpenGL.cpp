@@ -156,11 +156,17 @@ namespace Graphics
 		return m_impl->threadId == std::this_thread::get_id();
 	}
 
+	FrameArena& OpenGL::GetFrameArena()
+	{
+		return m_frameArena;
+	}
+
 	void OpenGL::SwapBuffers()
 	{
 		glFlush();
 		SDL_Window* sdlWnd = (SDL_Window*)m_window->Handle();
 		SDL_GL_SwapWindow(sdlWnd);
+		m_frameArena.Reset();
 	}
 
 	#ifdef _WIN32
@@ -45,7 +45,7 @@ namespace Graphics
 		// Create a new list of items
 		for(RenderQueueItem* item : m_orderedCommands)
 		{
-			auto SetupMaterial = [&](Material& mat, MaterialParameterSet& params)
+			auto SetupMaterial = [&](Material& mat, const MaterialParameterList& params)
 			{
 				// Only bind params if material is already bound to context
 				if(currentMaterial == mat)
@@ -182,53 +182,59 @@ namespace Graphics
 
 	void RenderQueue::Clear()
 	{
-		// Cleanup the list of items
+		// Cleanup the list of items, their memory is owned by the frame arena
 		for(RenderQueueItem* item : m_orderedCommands)
 		{
-			delete item;
+			item->~RenderQueueItem();
 		}
 		m_orderedCommands.clear();
 	}
 
 	void RenderQueue::Draw(Transform worldTransform, Mesh m, Material mat, const MaterialParameterSet& params)
 	{
-		SimpleDrawCall* sdc = new SimpleDrawCall();
+		// Queues made with the default constructor can't be drawn to
+		assert(m_ogl);
+		SimpleDrawCall* sdc = m_ogl->GetFrameArena().New<SimpleDrawCall>();
 		sdc->mat = mat;
 		sdc->mesh = m;
-		sdc->params = params;
+		sdc->params = m_CopyParameters(params);
 		sdc->worldTransform = worldTransform;
 		m_orderedCommands.push_back(sdc);
 	}
 	void RenderQueue::Draw(Transform worldTransform, Ref<class TextRes> text, Material mat, const MaterialParameterSet& params)
 	{
-		SimpleDrawCall* sdc = new SimpleDrawCall();
-		sdc->mat = mat;
-		sdc->mesh = text->GetMesh();
-		sdc->params = params;
-		// Set Font texture map
-		sdc->params.SetParameter("mainTex", text->GetTexture());
-		sdc->worldTransform = worldTransform;
-		m_orderedCommands.push_back(sdc);
+		DrawScissored(Rect(Vector2(), Vector2(-1)), worldTransform, text, mat, params);
 	}
 
 	void RenderQueue::DrawScissored(Rect scissor, Transform worldTransform, Mesh m, Material mat, const MaterialParameterSet& params /*= MaterialParameterSet()*/)
 	{
-		SimpleDrawCall* sdc = new SimpleDrawCall();
+		assert(m_ogl);
+		SimpleDrawCall* sdc = m_ogl->GetFrameArena().New<SimpleDrawCall>();
 		sdc->mat = mat;
 		sdc->mesh = m;
-		sdc->params = params;
+		sdc->params = m_CopyParameters(params);
 		sdc->worldTransform = worldTransform;
 		sdc->scissorRect = scissor;
 		m_orderedCommands.push_back(sdc);
 	}
 	void RenderQueue::DrawScissored(Rect scissor, Transform worldTransform, Ref<class TextRes> text, Material mat, const MaterialParameterSet& params /*= MaterialParameterSet()*/)
 	{
-		SimpleDrawCall* sdc = new SimpleDrawCall();
+		assert(m_ogl);
+		FrameArena& arena = m_ogl->GetFrameArena();
+		SimpleDrawCall* sdc = arena.New<SimpleDrawCall>();
 		sdc->mat = mat;
 		sdc->mesh = text->GetMesh();
-		sdc->params = params;
-		// Set Font texture map
-		sdc->params.SetParameter("mainTex", text->GetTexture());
+		sdc->params = m_CopyParameters(params, 1);
+
+		// Set Font texture map, this comes last so it overrides a texture with the same name in params
+		uint32* texture = arena.New<uint32>(text->GetTexture()->Handle());
+		MaterialParameterList::Entry& mainTex = sdc->params.entries[sdc->params.count - 1];
+		static const char mainTexName[] = "mainTex";
+		mainTex.name = mainTexName;
+		mainTex.nameLength = sizeof(mainTexName) - 1;
+		mainTex.data = texture;
+		mainTex.parameterType = GL_SAMPLER_2D;
+
 		sdc->worldTransform = worldTransform;
 		sdc->scissorRect = scissor;
 		m_orderedCommands.push_back(sdc);
@@ -236,14 +242,39 @@ namespace Graphics
 
 	void RenderQueue::DrawPoints(Mesh m, Material mat, const MaterialParameterSet& params, float pointSize)
 	{
-		PointDrawCall* pdc = new PointDrawCall();
+		assert(m_ogl);
+		PointDrawCall* pdc = m_ogl->GetFrameArena().New<PointDrawCall>();
 		pdc->mat = mat;
 		pdc->mesh = m;
-		pdc->params = params;
+		pdc->params = m_CopyParameters(params);
 		pdc->size = pointSize;
 		m_orderedCommands.push_back(pdc);
 	}
 
+	MaterialParameterList RenderQueue::m_CopyParameters(const MaterialParameterSet& params, uint32 numExtraEntries)
+	{
+		MaterialParameterList list;
+		list.count = (uint32)params.size() + numExtraEntries;
+		if(list.count == 0)
+			return list;
+
+		FrameArena& arena = m_ogl->GetFrameArena();
+		list.entries = (MaterialParameterList::Entry*)arena.Allocate(sizeof(MaterialParameterList::Entry) * list.count, alignof(MaterialParameterList::Entry));
+		MaterialParameterList::Entry* entry = list.entries;
+		for(auto& p : params)
+		{
+			const CopyableBuffer& data = p.second.parameterData;
+			void* dataCopy = arena.Allocate(data.size());
+			memcpy(dataCopy, data.data(), data.size());
+			entry->name = arena.CopyString(p.first.c_str(), p.first.size());
+			entry->nameLength = (uint32)p.first.size();
+			entry->data = dataCopy;
+			entry->parameterType = p.second.parameterType;
+			entry++;
+		}
+		return list;
+	}
+
 	// Initializes the simple draw call structure
 	SimpleDrawCall::SimpleDrawCall()
 		: scissorRect(Vector2(), Vector2(-1))
@@ -5,9 +5,12 @@
 
 namespace Graphics
 {
-	static Timer gcTimer;
-	static Timer cleanupTimer;
 	static int disabled = 0;
+	// Number of objects checked at a time and the time that can be spent checking objects every tick
+	static const size_t gcSliceSize = 64;
+	static const double gcBudget = 0.25;
+	// Manager that is currently being checked
+	static size_t gcManager = 0;
 
 	static ResourceManagers inst;
 	static IResourceManager* managers[(size_t)ResourceType::_Length] = { nullptr };
@@ -71,14 +74,28 @@ namespace Graphics
 	}
 	void ResourceManagers::m_TickAll()
 	{
-		if(gcTimer.Milliseconds() > 250 && disabled == 0)
+		if(disabled != 0)
+			return;
+
+		// Release objects that were found to be unused in the previous ticks
+		for(auto rm : managers)
+		{
+			if(rm)
+				rm->ReleaseUnused();
+		}
+
+		// Check a few objects at a time until the time budget is used, continuing with the next tick
+		//	stops after all managers were fully checked once
+		Timer timer;
+		size_t numFinished = 0;
+		while(numFinished < (size_t)ResourceType::_Length && timer.SecondsAsDouble() * 1000.0 < gcBudget)
 		{
-			for(auto rm : managers)
+			IResourceManager* rm = managers[gcManager];
+			if(!rm || rm->GarbageCollect(gcSliceSize))
 			{
-				if(rm)
-					rm->GarbageCollect();
+				gcManager = (gcManager + 1) % (size_t)ResourceType::_Length;
+				numFinished++;
 			}
-			gcTimer.Restart();
 		}
 	}
 }
@@ -8,7 +8,9 @@
 #include <Graphics/Window.hpp>
 #include <Graphics/ResourceManagers.hpp>
 #include "Shared/Jobs.hpp"
+#include "Shared/AsyncFileReader.hpp"
 #include <Shared/Profiling.hpp>
+#include <Shared/AllocationTracker.hpp>
 #include "Scoring.hpp"
 #include "GameConfig.hpp"
 #include <GUI/GUIRenderer.hpp>
@@ -22,6 +24,7 @@ OpenGL* g_gl = nullptr;
 Graphics::Window* g_gameWindow = nullptr;
 Application* g_application = nullptr;
 JobSheduler* g_jobSheduler = nullptr;
+AsyncFileReader* g_asyncFileReader = nullptr;
 Input g_input;
 
 GUIRenderer* g_guiRenderer = nullptr;
@@ -125,7 +128,7 @@ int32 Application::Run()
 
 	m_MainLoop();
 
-	return 0;
+	return m_exitCode;
 }
 
 bool Application::m_LoadConfig()
@@ -133,7 +136,7 @@ bool Application::m_LoadConfig()
 	File configFile;
 	if(configFile.OpenRead("Main.cfg"))
 	{
-		FileReader reader(configFile);
+		BufferedFileReader reader(configFile);
 		if(g_gameConfig.Load(reader))
 			return true;
 	}
@@ -155,6 +158,7 @@ void Application::m_SaveConfig()
 bool Application::m_Init()
 {
 	ProfilerScope $("Application Setup");
+	Profiler::SetThreadName("Main");
 
 	// Must have command line
 	assert(m_commandLine.size() >= 1);
@@ -166,6 +170,8 @@ bool Application::m_Init()
 
 	// Job sheduler
 	g_jobSheduler = new JobSheduler();
+	// Reads files for loaders without blocking the main thread
+	g_asyncFileReader = new AsyncFileReader();
 
 	m_allowMapConversion = false;
 	bool debugMute = false;
@@ -201,6 +207,16 @@ bool Application::m_Init()
 			{
 				startFullscreen = true;
 			}
+			else if(cl == "-profile")
+			{
+				// Record profiler zones, written to a trace file on exit
+				Profiler::SetEnabled(true);
+			}
+			else if(cl == "-trackallocs")
+			{
+				// Count allocations per frame, shown in the game's debug HUD
+				AllocationTracker::SetEnabled(true);
+			}
 		}
 	}
 
@@ -374,16 +390,23 @@ void Application::m_MainLoop()
 			if(!g_gameWindow->Update())
 				return;
 
+			Profiler::BeginFrame();
+			AllocationTracker::BeginFrame();
 			m_Tick();
 			timeSinceRender = 0.0f;
 
 			// Garbage collect resources
+			ProfileZone("Garbage Collect");
 			ResourceManagers::TickAll();
 		}
 
-		// Tick job sheduler
+		// Tick async file reader and job sheduler
 		// processed callbacks for finished tasks
-		g_jobSheduler->Update();
+		{
+			ProfileZone("Job Callbacks");
+			g_asyncFileReader->Update();
+			g_jobSheduler->Update();
+		}
 
 		if(timeSinceRender < targetRenderTime)
 		{
@@ -397,12 +420,19 @@ void Application::m_MainLoop()
 void Application::m_Tick()
 {
 	// Handle input first
-	g_input.Update(m_deltaTime);
+	{
+		ProfileZone("Input");
+		g_input.Update(m_deltaTime);
+	}
 
 	// Tick all items
-	for(auto& tickable : g_tickables)
 	{
-		tickable->Tick(m_deltaTime);
+		ProfileZone("Tick");
+		AllocationScope allocationScope(AllocationTag::Gameplay);
+		for(auto& tickable : g_tickables)
+		{
+			tickable->Tick(m_deltaTime);
+		}
 	}
 
 	// Not minimized / Valid resolution
@@ -412,15 +442,24 @@ void Application::m_Tick()
 		glClear(GL_COLOR_BUFFER_BIT);
 
 		// Render all items
-		for(auto& tickable : g_tickables)
 		{
-			tickable->Render(m_deltaTime);
+			ProfileZone("Render");
+			AllocationScope allocationScope(AllocationTag::Render);
+			for(auto& tickable : g_tickables)
+			{
+				tickable->Render(m_deltaTime);
+			}
 		}
 
 		// Time to render GUI
-		g_guiRenderer->Render(m_deltaTime, Rect(Vector2(0, 0), g_resolution), g_rootCanvas.As<GUIElementBase>());
+		{
+			ProfileZone("GUI Render");
+			AllocationScope allocationScope(AllocationTag::GUI);
+			g_guiRenderer->Render(m_deltaTime, Rect(Vector2(0, 0), g_resolution), g_rootCanvas.As<GUIElementBase>());
+		}
 
 		// Swap buffers
+		ProfileZone("Swap Buffers");
 		g_gl->SwapBuffers();
 	}
 }
@@ -457,12 +496,22 @@ void Application::m_Cleanup()
 		g_gameWindow = nullptr;
 	}
 
+	// Callbacks of reads that are still in progress can queue jobs, so this is removed first
+	if(g_asyncFileReader)
+	{
+		delete g_asyncFileReader;
+		g_asyncFileReader = nullptr;
+	}
+
 	if(g_jobSheduler)
 	{
 		delete g_jobSheduler;
 		g_jobSheduler = nullptr;
 	}
 
+	if(Profiler::IsEnabled())
+		Profiler::ExportChromeTrace("profile_trace.json");
+
 	// Finally, save config
 	m_SaveConfig();
 }
@@ -474,8 +523,9 @@ class Game* Application::LaunchMap(const String& mapPath)
 	AddTickable(screen);
 	return game;
 }
-void Application::Shutdown()
+void Application::Shutdown(int32 exitCode)
 {
+	m_exitCode = exitCode;
 	g_gameWindow->Close();
 }
 
@@ -7,6 +7,7 @@ extern float g_aspectRatio;
 extern Vector2i g_resolution;
 extern class Application* g_application;
 extern class JobSheduler* g_jobSheduler;
+extern class AsyncFileReader* g_asyncFileReader;
 extern class Input g_input;
 
 // GUI
@@ -27,7 +28,8 @@ public:
 	void SetCommandLine(const char* cmdLine);
 
 	class Game* LaunchMap(const String& mapPath);
-	void Shutdown();
+	// Closes the application, Run returns the given exit code
+	void Shutdown(int32 exitCode = 0);
 
 	void AddTickable(class IApplicationTickable* tickable, class IApplicationTickable* insertBefore = nullptr);
 	void RemoveTickable(class IApplicationTickable* tickable);
@@ -76,4 +78,5 @@ private:
 	float m_lastRenderTime;
 	float m_deltaTime;
 	bool m_allowMapConversion;
+	int32 m_exitCode = 0;
 };
\ No newline at end of file
@@ -1,10 +1,14 @@
 #include "stdafx.h"
 #include "AsyncAssetLoader.hpp"
 #include "Application.hpp"
+#include <Shared/TaskGraph.hpp>
 
 struct AsyncLoadOperation : public IAsyncLoadable
 {
 	String name;
+	// Result and duration of the load step, in milliseconds
+	bool loaded = false;
+	double loadTime = 0.0;
 };
 struct AsyncTextureLoadOperation : public AsyncLoadOperation
 {
@@ -74,6 +78,22 @@ struct AsyncWrapperOperation : public AsyncLoadOperation
 		return target.AsyncFinalize();
 	}
 };
+struct AsyncFunctionOperation : public AsyncLoadOperation
+{
+	Job function;
+	AsyncFunctionOperation(Job function, const String& name) : function(function)
+	{
+		this->name = name;
+	}
+	bool AsyncLoad()
+	{
+		return function->Run();
+	}
+	bool AsyncFinalize()
+	{
+		return true;
+	}
+};
 
 class AsyncAssetLoader_Impl
 {
@@ -113,30 +133,75 @@ void AsyncAssetLoader::AddLoadable(IAsyncLoadable& loadable, const String& id /*
 {
 	m_impl->loadables.Add(new AsyncWrapperOperation(loadable, id));
 }
+void AsyncAssetLoader::m_AddFunction(Job function, const String& id)
+{
+	m_impl->loadables.Add(new AsyncFunctionOperation(function, id));
+}
 
 bool AsyncAssetLoader::Load()
 {
+	Vector<AsyncLoadOperation*>& loadables = m_impl->loadables;
+	Timer timer;
+
+	// Every load step is a seperate range, since they take very different amounts of time
+	ParallelFor(*g_jobSheduler, 0, loadables.size(), 1, [&](size_t begin, size_t end)
+	{
+		for(size_t i = begin; i < end; i++)
+		{
+			AsyncLoadOperation* ld = loadables[i];
+			Timer loadTimer;
+			ld->loaded = ld->AsyncLoad();
+			ld->loadTime = loadTimer.SecondsAsDouble() * 1000.0;
+		}
+	});
+
+	// Log failures and timings from this thread, after all steps are done
 	bool success = true;
-	for(auto& ld : m_impl->loadables)
+	double totalLoadTime = 0.0;
+	AsyncLoadOperation* slowest = nullptr;
+	for(auto& ld : loadables)
 	{
-		if(!ld->AsyncLoad())
+		if(!ld->loaded)
 		{
 			Logf("[AsyncLoad] Load failed on %s", Logger::Error, ld->name);
 			success = false;
 		}
+		totalLoadTime += ld->loadTime;
+		if(!slowest || ld->loadTime > slowest->loadTime)
+			slowest = ld;
+	}
+	if(slowest)
+	{
+		Logf("[AsyncLoad] Loaded %d assets in %.1f ms (%.1f ms of work, slowest: %s %.1f ms)", Logger::Info,
+			(int32)loadables.size(), timer.SecondsAsDouble() * 1000.0, totalLoadTime, slowest->name, slowest->loadTime);
 	}
 	return success;
 }
 bool AsyncAssetLoader::Finalize()
 {
+	Timer timer;
 	bool success = true;
+	String slowestName;
+	double slowestTime = 0.0;
 	for(auto& ld : m_impl->loadables)
 	{
+		Timer finalizeTimer;
 		if(!ld->AsyncFinalize())
 		{
 			Logf("[AsyncLoad] Finalize failed on %s", Logger::Error, ld->name);
 			success = false;
 		}
+		double finalizeTime = finalizeTimer.SecondsAsDouble() * 1000.0;
+		if(finalizeTime > slowestTime)
+		{
+			slowestName = ld->name;
+			slowestTime = finalizeTime;
+		}
+	}
+	if(!m_impl->loadables.empty())
+	{
+		Logf("[AsyncLoad] Finalized %d assets in %.1f ms (slowest: %s %.1f ms)", Logger::Info,
+			(int32)m_impl->loadables.size(), timer.SecondsAsDouble() * 1000.0, slowestName, slowestTime);
 	}
 
 	// Clear state
@@ -1,9 +1,13 @@
 #pragma once
 #include "AsyncLoadable.hpp"
+#include <Shared/Jobs.hpp>
 
 /*
 	Loads assets and IAsyncLoadables 
 	Acts like a queue that stores loading commands
+
+	the load steps run concurrently on the job threads and the thread calling Load
+	the finalize steps run in the order they were added, on the thread calling Finalize
 */
 class AsyncAssetLoader : public Unique
 {
@@ -20,10 +24,19 @@ public:
 	void AddMaterial(Material& out, const String& path);
 	// Add a loadable to be loaded, additionaly with a name so it can be identified in logs if it fails loading
 	void AddLoadable(IAsyncLoadable& loadable, const String& id = "unknown");
+	// Add a function returning a bool for success that is called during Load, for loading steps that don't need finalizing
+	//	the function runs concurrently with the other load steps
+	template<typename Lambda>
+	void AddFunction(Lambda&& func, const String& id = "unknown")
+	{
+		m_AddFunction(JobBase::CreateLambda(typename std::decay<Lambda>::type(std::forward<Lambda>(func))), id);
+	}
 
 	bool Load();
 	bool Finalize();
 
 private:
+	void m_AddFunction(Job function, const String& id);
+
 	class AsyncAssetLoader_Impl* m_impl;
 };
\ No newline at end of file
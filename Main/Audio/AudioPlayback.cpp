@@ -16,20 +16,12 @@ AudioPlayback::~AudioPlayback()
 }
 bool AudioPlayback::Init(class BeatmapPlayback& playback, const String& mapRootPath)
 {
-	// Cleanup exising DSP's
-	m_currentHoldEffects[0] = nullptr;
-	m_currentHoldEffects[1] = nullptr;
-	m_CleanupDSP(m_buttonDSPs[0]);
-	m_CleanupDSP(m_buttonDSPs[1]);
-	m_CleanupDSP(m_laserDSP);
-
 	m_playback = &playback;
 	m_beatmap = &playback.GetBeatmap();
 	m_beatmapRootPath = mapRootPath;
 	assert(m_beatmap != nullptr);
 
-	// Set default effect type
-	SetLaserEffect(EffectType::PeakingFilter);
+	ResetEffects();
 
 	const BeatmapSettings& mapSettings = m_beatmap->GetMapSettings();
 	String audioPath = Path::Normalize(m_beatmapRootPath + Path::sep + mapSettings.audioNoFX);
@@ -70,6 +62,19 @@ bool AudioPlayback::Init(class BeatmapPlayback& playback, const String& mapRootP
 
 	return true;
 }
+void AudioPlayback::ResetEffects()
+{
+	// Cleanup exising DSP's
+	m_currentHoldEffects[0] = nullptr;
+	m_currentHoldEffects[1] = nullptr;
+	m_CleanupDSP(m_buttonDSPs[0]);
+	m_CleanupDSP(m_buttonDSPs[1]);
+	m_CleanupDSP(m_laserDSP);
+	m_laserInput = 0.0f;
+
+	// Set default effect type
+	SetLaserEffect(EffectType::PeakingFilter);
+}
 void AudioPlayback::Tick(float deltaTime)
 {
 
@@ -31,6 +31,9 @@ public:
 	// Loads audio for beatmap
 	//	specify the root path for the map in order to let this class find the audio files
 	bool Init(class BeatmapPlayback& playback, const String& mapRootPath);
+	// Removes all active effects and sets the default laser effect
+	//	the loaded audio is kept, used when restarting or seeking
+	void ResetEffects();
 
 	// Updates effects
 	void Tick(float deltaTime);
@@ -26,7 +26,7 @@ public:
 	{
 		m_style = style;
 		m_diff = diff;
-		m_frame = m_style->diffFrames[Math::Min<size_t>(diff->settings.difficulty, m_style->numDiffFrames-1)];
+		m_frame = m_style->diffFrames[Math::Min<size_t>(diff->metadata.difficulty, m_style->numDiffFrames-1)];
 	}
 	virtual void Render(GUIRenderData rd)
 	{
@@ -35,15 +35,14 @@ public:
 		// Load jacket?
 		if(!m_jacket || m_jacket == m_style->loadingJacketImage)
 		{
-			String jacketPath = m_diff->path;
-			jacketPath = Path::Normalize(Path::RemoveLast(jacketPath) + Path::sep + m_diff->settings.jacketPath);
+			String jacketPath = Path::Normalize(String(m_diff->map->path) + Path::sep + m_diff->metadata.jacketPath);
 			m_jacket = m_style->GetJacketThumnail(jacketPath);
 		}
 
 		// Render lvl text?
 		if(!m_lvlText)
 		{
-			WString lvlStr = Utility::WSprintf(L"%d", m_diff->settings.level);
+			WString lvlStr = Utility::WSprintf(L"%d", m_diff->metadata.level);
 			m_lvlText = rd.guiRenderer->font->CreateText(lvlStr, 20);
 		}
 
@@ -164,9 +163,9 @@ Vector2 SongSelectItem::GetDesiredSize(GUIRenderData rd)
 }
 void SongSelectItem::SetMap(struct MapIndex* map)
 {
-	const BeatmapSettings& settings = map->difficulties[0]->settings;
-	m_title->SetText(Utility::ConvertToWString(settings.title));
-	m_artist->SetText(Utility::ConvertToWString(settings.artist));
+	const DifficultyMetadata& metadata = map->difficulties[0]->metadata;
+	m_title->SetText(Utility::ConvertToWString(metadata.title));
+	m_artist->SetText(Utility::ConvertToWString(metadata.artist));
 
 	// Add all difficulty icons
 	m_diffSelect->Clear();
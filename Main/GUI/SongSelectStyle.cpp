@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "SongSelectStyle.hpp"
 #include "Shared/Jobs.hpp"
+#include "Shared/AsyncFileReader.hpp"
 #include "Application.hpp"
 
 Ref<SongSelectStyle> SongSelectStyle::instance;
@@ -41,7 +42,10 @@ SongSelectStyle::~SongSelectStyle()
 {
 	for(auto t : m_jacketImages)
 	{
-		t.second->loadingJob->Terminate();
+		// The job is not queued if the file is still being read
+		JacketLoadingJob* job = (JacketLoadingJob*)t.second->loadingJob.GetData();
+		job->target = nullptr;
+		job->Terminate();
 		delete t.second;
 	}
 }
@@ -59,7 +63,17 @@ Texture SongSelectStyle::GetJacketThumnail(const String& path)
 		job->target = newImage;
 		newImage->loadingJob = Ref<JobBase>(job);
 		newImage->lastUsage = m_timer.SecondsAsFloat();
-		g_jobSheduler->Queue(newImage->loadingJob);
+
+		// Read the file without blocking, then decode the image on a job thread
+		Job loadingJob = newImage->loadingJob;
+		g_asyncFileReader->Read(AsyncReadRequest(path, [loadingJob](AsyncReadResult& result)
+		{
+			JacketLoadingJob* job = (JacketLoadingJob*)loadingJob.GetData();
+			if(!result.success || !job->target)
+				return;
+			job->imageData = std::move(result.data);
+			g_jobSheduler->Queue(loadingJob);
+		}));
 
 		m_jacketImages.Add(path, newImage);
 	}
@@ -77,13 +91,14 @@ Texture SongSelectStyle::GetJacketThumnail(const String& path)
 }
 bool JacketLoadingJob::Run()
 {
-	// Create loading task
-	loadedImage = ImageRes::Create(imagePath);
+	// Decode the file that was read by the async file reader
+	loadedImage = ImageRes::Create(imageData);
+	imageData.clear();
 	return loadedImage.IsValid();
 }
 void JacketLoadingJob::Finalize()
 {
-	if(IsSuccessfull())
+	if(IsSuccessfull() && target)
 	{
 		target->texture = TextureRes::Create(g_gl, loadedImage);
 		target->texture->SetWrap(TextureWrap::Clamp, TextureWrap::Clamp);
@@ -17,6 +17,9 @@ public:
 
 	Image loadedImage;
 	String imagePath;
+	// Contents of the image file
+	Buffer imageData;
+	// Null when the cache was destroyed before the image was loaded
 	CachedJacketImage* target;
 };
 
@@ -3,6 +3,7 @@
 #include "Application.hpp"
 #include <Beatmap/BeatmapPlayback.hpp>
 #include <Shared/Profiling.hpp>
+#include <Shared/AllocationTracker.hpp>
 #include "Scoring.hpp"
 #include <Audio/Audio.hpp>
 #include "Track.hpp"
@@ -31,7 +32,7 @@ Ref<Beatmap> TryLoadMap(const String& path)
 		delete newMap;
 		return Ref<Beatmap>();
 	}
-	FileReader reader(mapFile);
+	BufferedFileReader reader(mapFile);
 	if(!newMap->Load(reader))
 	{
 		delete newMap;
@@ -58,6 +59,13 @@ private:
 
 	bool m_renderDebugHUD = false;
 
+	// Allocation budget test mode, set with -allocbudget=<allocations per frame>
+	//	fails when a gameplay frame after the warmup makes more allocations than the budget
+	int64 m_allocationBudget = -1;
+	uint32 m_numGameplayFrames = 0;
+	uint64 m_maxFrameAllocations = 0;
+	static const uint32 allocationWarmupFrames = 120;
+
 	// Map object approach speed, scaled by BPM
 	float m_hispeed = 1.0f;
 
@@ -102,6 +110,12 @@ private:
 	Vector<ObjectState*> m_currentObjectSet;
 	MapTime m_lastMapTime;
 
+	// Scoring state at the start of the map, restored when restarting
+	ScoringSnapshot m_startSnapshot;
+	// Practice checkpoint, set with F6 and returned to with F7
+	ScoringSnapshot m_checkpoint;
+	bool m_hasCheckpoint = false;
+
 	// Combo gain animation
 	Timer m_comboAnimation;
 
@@ -150,6 +164,7 @@ public:
 	virtual bool AsyncLoad() override
 	{
 		ProfilerScope $("AsyncLoad Game");
+		AllocationScope allocationScope(AllocationTag::Loading);
 
 		if(!Path::FileExists(m_mapPath))
 		{
@@ -171,28 +186,47 @@ public:
 		{
 			m_renderDebugHUD = true;
 		}
+		for(auto& cl : g_application->GetAppCommandLine())
+		{
+			String k, v;
+			if(cl.Split("=", &k, &v) && k == "-allocbudget")
+			{
+				m_allocationBudget = atol(*v);
+				AllocationTracker::SetEnabled(true);
+			}
+		}
 
 		const BeatmapSettings& mapSettings = m_beatmap->GetMapSettings();
 
-		// Try to load beatmap jacket image
-		String jacketPath = m_mapRootPath + "/" + mapSettings.jacketPath;
-		m_jacketImage = ImageRes::Create(jacketPath);
-
 		// Initialize input/scoring
 		if(!InitGameplay())
 			return false;
 
-		// Load beatmap audio
-		if(!m_audioPlayback.Init(m_playback, m_mapRootPath))
-			return false;
+		// The steps below are added to the loader so they run concurrently with the asset loading
+		// Load beatmap audio, added first since decoding the audio takes the longest
+		loader.AddFunction([this]()
+		{
+			if(!m_audioPlayback.Init(m_playback, m_mapRootPath))
+				return false;
+			ApplyAudioLeadin();
+			return true;
+		}, "Audio");
 
-		ApplyAudioLeadin();
+		// Try to load beatmap jacket image, the game still starts without it
+		String jacketPath = m_mapRootPath + "/" + mapSettings.jacketPath;
+		loader.AddFunction([this, jacketPath]()
+		{
+			m_jacketImage = ImageRes::Create(jacketPath);
+			return true;
+		}, "Jacket");
 
 		// Load audio offset
 		m_audioOffset = g_gameConfig.GetInt(GameConfigKeys::GlobalOffset);
 
-		if(!InitSFX())
-			return false;
+		loader.AddFunction([this]()
+		{
+			return InitSFX();
+		}, "SFX");
 
 		// Intialize track graphics
 		m_track = new Track();
@@ -212,6 +246,8 @@ public:
 	}
 	virtual bool AsyncFinalize() override
 	{
+		AllocationScope allocationScope(AllocationTag::Loading);
+
 		if(m_jacketImage)
 		{
 			m_jacketTexture = TextureRes::Create(g_gl, m_jacketImage);
@@ -236,6 +272,7 @@ public:
 		m_scoring.SetPlayback(m_playback);
 		m_scoring.SetInput(&g_input);
 		m_scoring.Reset(); // Initialize
+		m_startSnapshot = m_scoring.CreateSnapshot();
 
 		return true;
 	}
@@ -252,17 +289,24 @@ public:
 	{
 		m_camera = Camera();
 
-		bool audioReinit = m_audioPlayback.Init(m_playback, m_mapRootPath);
-		assert(audioReinit);
-
-		// Audio leadin
-		ApplyAudioLeadin();
+		// Keep the loaded audio, only the position and effects are reset
+		if(m_audioPlayback.IsPaused())
+			m_audioPlayback.TogglePause();
 
 		m_paused = false;
 		m_started = false;
 		m_ended = false;
-		m_playback.Reset(m_lastMapTime);
-		m_scoring.Reset();
+		m_hasCheckpoint = false;
+		RestoreSnapshot(m_startSnapshot);
+	}
+	// Seeks the map to the time of the snapshot and restores the scoring state
+	void RestoreSnapshot(const ScoringSnapshot& snapshot)
+	{
+		m_audioPlayback.ResetEffects();
+		m_audioPlayback.SetPosition(snapshot.time);
+		m_lastMapTime = snapshot.time;
+		m_playback.Reset(snapshot.time);
+		m_scoring.RestoreSnapshot(snapshot);
 
 		for(uint32 i = 0; i < 2; i++)
 		{
@@ -283,6 +327,8 @@ public:
 	}
 	virtual void Tick(float deltaTime) override
 	{
+		ProfileZone("Game Tick");
+
 		// Lock mouse to screen when playing
 		if(g_gameConfig.GetEnum<Enum_InputDevice>(GameConfigKeys::LaserInputDevice) == InputDevice::Mouse)
 		{
@@ -305,6 +351,8 @@ public:
 	}
 	virtual void Render(float deltaTime) override
 	{
+		ProfileZone("Game Render");
+
 		m_track->SetViewRange((1.0f / m_hispeed) * 4.0f);
 		m_track->Tick(m_playback, deltaTime);
 
@@ -618,11 +666,33 @@ public:
 
 		m_lastMapTime = playbackPositionMs;
 
+		if(m_allocationBudget >= 0 && ++m_numGameplayFrames > allocationWarmupFrames)
+			CheckAllocationBudget();
+
 		if(m_audioPlayback.HasEnded())
 		{
 			FinishGame();
 		}
 	}
+	// Checks the allocations of the last frame against the budget given on the command line, exits on failure
+	void CheckAllocationBudget()
+	{
+		AllocationTracker::Counts frame = AllocationTracker::GetLastFrameTotal();
+		m_maxFrameAllocations = Math::Max(m_maxFrameAllocations, frame.numAllocations);
+		if(frame.numAllocations <= (uint64)m_allocationBudget)
+			return;
+
+		Logf("Allocation budget exceeded: %d allocations (%d bytes) in frame %d, the budget is %d", Logger::Error,
+			(int32)frame.numAllocations, (int32)frame.bytesAllocated, m_numGameplayFrames, (int32)m_allocationBudget);
+		for(size_t i = 0; i < (size_t)AllocationTag::_Length; i++)
+		{
+			AllocationTracker::Counts tagCounts = AllocationTracker::GetLastFrame((AllocationTag)i);
+			Logf("  %s: %d allocations (%d bytes)", Logger::Error, AllocationTracker::GetTagName((AllocationTag)i),
+				(int32)tagCounts.numAllocations, (int32)tagCounts.bytesAllocated);
+		}
+		m_allocationBudget = -1;
+		g_application->Shutdown(1);
+	}
 
 	// Called when game is finished and the score screen should show up
 	void FinishGame()
@@ -630,6 +700,15 @@ public:
 		if(m_ended)
 			return;
 
+		// Exit after playing the map in allocation budget test mode
+		if(m_allocationBudget >= 0)
+		{
+			Logf("Allocation budget of %d met, at most %d allocations per frame", Logger::Info, (int32)m_allocationBudget, (int32)m_maxFrameAllocations);
+			g_application->Shutdown(0);
+			m_ended = true;
+			return;
+		}
+
 		// Transition to score screen
 		TransitionScreen* transition = TransitionScreen::Create(ScoreScreen::Create(this));
 		transition->OnLoadingComplete.Add(this, &Game_Impl::OnScoreScreenLoaded);
@@ -769,6 +848,36 @@ public:
 		textPos.y += RenderText(Utility::Sprintf("Track Zoom Top: %f", m_camera.zoomTop), textPos).y;
 		textPos.y += RenderText(Utility::Sprintf("Track Zoom Bottom: %f", m_camera.zoomBottom), textPos).y;
 
+		// Allocations of the last frame, started with -trackallocs or -allocbudget
+		if(AllocationTracker::IsEnabled())
+		{
+			AllocationTracker::Counts frame = AllocationTracker::GetLastFrameTotal();
+			textPos.y += RenderText(Utility::Sprintf("Allocations: %d (%d bytes)", (int32)frame.numAllocations, (int32)frame.bytesAllocated), textPos).y;
+			for(size_t i = 0; i < (size_t)AllocationTag::_Length; i++)
+			{
+				AllocationTracker::Counts tagCounts = AllocationTracker::GetLastFrame((AllocationTag)i);
+				if(tagCounts.numAllocations > 0)
+					textPos.y += RenderText(Utility::Sprintf("  %s: %d", AllocationTracker::GetTagName((AllocationTag)i), (int32)tagCounts.numAllocations), textPos).y;
+			}
+		}
+
+		// Profiler zones of the last frame, started with -profile
+		if(Profiler::IsEnabled())
+		{
+			Profiler::FrameStats frame = Profiler::GetLastFrame();
+			textPos.y += RenderText(Utility::Sprintf("Frame: %.2f ms", frame.duration), textPos).y;
+			for(auto& thread : frame.threads)
+			{
+				textPos.y += RenderText(thread.name, textPos, Color::Yellow).y;
+				for(auto& zone : thread.zones)
+				{
+					if(zone.depth > 1)
+						continue;
+					textPos.y += RenderText(Utility::Sprintf("%*s%s: %.2f ms (%d)", (int32)zone.depth * 2 + 2, "", zone.name, zone.time, zone.count), textPos).y;
+				}
+			}
+		}
+
 		Vector2 buttonStateTextPos = Vector2(g_resolution.x - 200.0f, 100.0f);
 		RenderText(g_input.GetControllerStateString(), buttonStateTextPos);
 
@@ -957,6 +1066,16 @@ public:
 			// Restart
 			Restart();
 		}
+		else if(key == Key::F6) // Set practice checkpoint
+		{
+			m_checkpoint = m_scoring.CreateSnapshot();
+			m_hasCheckpoint = true;
+		}
+		else if(key == Key::F7) // Return to practice checkpoint
+		{
+			if(m_hasCheckpoint && !m_ended)
+				RestoreSnapshot(m_checkpoint);
+		}
 		else if(key == Key::F8)
 		{
 			m_renderDebugHUD = !m_renderDebugHUD;
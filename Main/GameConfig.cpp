@@ -23,6 +23,7 @@ void GameConfig::InitDefaults()
 	Set(GameConfigKeys::HiSpeed, 1.0f);
 	Set(GameConfigKeys::GlobalOffset, 0);
 	Set(GameConfigKeys::SongFolder, "songs");
+	Set(GameConfigKeys::MapScanThreads, 0);
 
 	// Input settings
 	SetEnum<Enum_InputDevice>(GameConfigKeys::ButtonInputDevice, InputDevice::Keyboard);
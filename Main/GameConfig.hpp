@@ -15,6 +15,7 @@ DefineEnum(GameConfigKeys,
 	HiSpeed,
 	GlobalOffset,
 	SongFolder,
+	MapScanThreads,
 
 	// Input device setting per element
 	LaserInputDevice,
@@ -265,7 +265,7 @@ void LaserTrackBuilder::m_RecalculateConstants()
 	effectiveWidth = m_trackWidth - m_laserWidth;
 }
 
-void LaserTrackBuilder::m_Cleanup(MapTime newTime, Map<LaserObjectState*, Mesh>& arr)
+void LaserTrackBuilder::m_Cleanup(MapTime newTime, FlatHashMap<LaserObjectState*, Mesh>& arr)
 {
 	// Cleanup unused meshes
 	for(auto it = arr.begin(); it != arr.end();)
@@ -53,14 +53,14 @@ private:
 
 private:
 	void m_RecalculateConstants();
-	void m_Cleanup(MapTime newTime, Map<LaserObjectState*, Mesh>& arr);
+	void m_Cleanup(MapTime newTime, FlatHashMap<LaserObjectState*, Mesh>& arr);
 	class OpenGL* m_gl;
 	class Track* m_track;
 
 	float m_trackWidth;
 	float m_laserWidth;
 	uint32 m_laserIndex;
-	Map<LaserObjectState*, Mesh> m_objectCache;
-	Map<LaserObjectState*, Mesh> m_cachedEntries;
-	Map<LaserObjectState*, Mesh> m_cachedExits;
+	FlatHashMap<LaserObjectState*, Mesh> m_objectCache;
+	FlatHashMap<LaserObjectState*, Mesh> m_cachedEntries;
+	FlatHashMap<LaserObjectState*, Mesh> m_cachedExits;
 };
\ No newline at end of file
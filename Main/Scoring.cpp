@@ -92,12 +92,83 @@ void Scoring::Reset()
 	m_heldObjects.clear();
 	memset(m_holdObjects, 0, sizeof(m_holdObjects));
 	memset(m_currentLaserSegments, 0, sizeof(m_currentLaserSegments));
+	m_laserSegmentQueue.clear();
+	m_tickStartTime = INT32_MIN;
 	m_CleanupHitStats();
 	m_CleanupTicks();
 
 	OnScoreChanged.Call(0);
 }
 
+ScoringSnapshot Scoring::CreateSnapshot() const
+{
+	ScoringSnapshot snapshot;
+	snapshot.time = m_playback->GetLastTime();
+	snapshot.currentMaxScore = currentMaxScore;
+	snapshot.currentHitScore = currentHitScore;
+	memcpy(snapshot.categorizedHits, categorizedHits, sizeof(categorizedHits));
+	snapshot.currentComboCounter = currentComboCounter;
+	snapshot.maxComboCounter = maxComboCounter;
+	snapshot.currentGauge = currentGauge;
+	snapshot.hitStats.reserve(hitStats.size());
+	for(HitStat* stat : hitStats)
+		snapshot.hitStats.Add(*stat);
+	// Ticks that are still inside their hit window are judged after the snapshot is restored
+	for(uint32 i = 0; i < 8; i++)
+	{
+		for(ScoreTick* tick : m_ticks[i])
+		{
+			if(tick->time < snapshot.time)
+				snapshot.pendingTicks[i].Add(*tick);
+		}
+	}
+	return snapshot;
+}
+void Scoring::RestoreSnapshot(const ScoringSnapshot& snapshot)
+{
+	currentMaxScore = snapshot.currentMaxScore;
+	currentHitScore = snapshot.currentHitScore;
+	memcpy(categorizedHits, snapshot.categorizedHits, sizeof(categorizedHits));
+	currentComboCounter = snapshot.currentComboCounter;
+	maxComboCounter = snapshot.maxComboCounter;
+	currentGauge = snapshot.currentGauge;
+
+	// Reset laser positions
+	laserTargetPositions[0] = 0.0f;
+	laserTargetPositions[1] = 0.0f;
+	laserPositions[0] = 0.0f;
+	laserPositions[1] = 1.0f;
+	timeSinceLaserUsed[0] = 1000.0f;
+	timeSinceLaserUsed[1] = 1000.0f;
+
+	m_heldObjects.clear();
+	memset(m_holdObjects, 0, sizeof(m_holdObjects));
+	memset(m_currentLaserSegments, 0, sizeof(m_currentLaserSegments));
+	m_laserSegmentQueue.clear();
+	m_CleanupHitStats();
+	m_CleanupTicks();
+
+	// Restore hit statistics, hold and laser statistics keep being updated by the remaining ticks
+	for(const HitStat& stat : snapshot.hitStats)
+	{
+		HitStat* copy = new HitStat(stat);
+		hitStats.Add(copy);
+		if(copy->object->type != ObjectType::Single)
+			m_holdHitStats.Add(copy->object, copy);
+	}
+
+	// Ticks that were already processed before the snapshot are skipped when the objects are entered again
+	m_tickStartTime = snapshot.time;
+	for(uint32 i = 0; i < 8; i++)
+	{
+		for(const ScoreTick& tick : snapshot.pendingTicks[i])
+			m_ticks[i].Add(new ScoreTick(tick));
+	}
+
+	OnComboChanged.Call(currentComboCounter);
+	OnScoreChanged.Call(CalculateCurrentScore());
+}
+
 void Scoring::Tick(float deltaTime)
 {
 	m_UpdateLasers(deltaTime);
@@ -358,6 +429,8 @@ void Scoring::m_OnObjectEntered(ObjectState* obj)
 	if(obj->type == ObjectType::Single)
 	{
 		ButtonObjectState* bt = (ButtonObjectState*)obj;
+		if(bt->time < m_tickStartTime)
+			return;
 		ScoreTick* t = m_ticks[bt->index].Add(new ScoreTick(obj));
 		t->time = bt->time;
 		t->SetFlag(TickFlags::Button);
@@ -373,6 +446,8 @@ void Scoring::m_OnObjectEntered(ObjectState* obj)
 		m_CalculateHoldTicks(hold, holdTicks);
 		for(size_t i = 0; i < holdTicks.size(); i++)
 		{
+			if(holdTicks[i] < m_tickStartTime)
+				continue;
 			ScoreTick* t = m_ticks[hold->index].Add(new ScoreTick(obj));
 			t->SetFlag(TickFlags::Hold);
 			if(i == 0 && !hold->prev)
@@ -392,6 +467,8 @@ void Scoring::m_OnObjectEntered(ObjectState* obj)
 			m_CalculateLaserTicks(laser, laserTicks);
 			for(size_t i = 0; i < laserTicks.size(); i++)
 			{
+				if(laserTicks[i].time < m_tickStartTime)
+					continue;
 				// Add copy
 				m_ticks[laser->index + 6].Add(new ScoreTick(laserTicks[i]));
 			}
@@ -55,6 +55,23 @@ struct MapTotals
 	uint32 maxScore;
 };
 
+// Copy of the scoring state at a given point in the map
+// used to return to that point without replaying the map up to it
+struct ScoringSnapshot
+{
+	// Playback time at which the snapshot was taken
+	MapTime time = 0;
+	uint32 currentMaxScore = 0;
+	uint32 currentHitScore = 0;
+	uint32 categorizedHits[3] = { 0 };
+	uint32 currentComboCounter = 0;
+	uint32 maxComboCounter = 0;
+	float currentGauge = 0.0f;
+	Vector<HitStat> hitStats;
+	// Ticks before the snapshot time that were not hit or missed yet, for each BT[4] / FX[2] / Laser[2]
+	Vector<ScoreTick> pendingTicks[8];
+};
+
 /*
 	Calculates game score and checks which objects are hit
 	also keeps track of laser positions
@@ -75,6 +92,12 @@ public:
 	// Called after SetPlayback
 	void Reset();
 
+	// Stores the current score, gauge and hit statistics
+	ScoringSnapshot CreateSnapshot() const;
+	// Restores the state stored in a snapshot
+	// Called after the playback has been reset to the time of the snapshot
+	void RestoreSnapshot(const ScoringSnapshot& snapshot);
+
 	// Updates the list of objects that are possible to hit
 	void Tick(float deltaTime);
 
@@ -250,6 +273,9 @@ private:
 
 	// Ticks for each BT[4] / FX[2] / Laser[2]
 	Vector<ScoreTick*> m_ticks[8];
+	// Ticks before this time are not registered, set when restoring a snapshot
+	//	the ticks before it that were still pending are restored from the snapshot
+	MapTime m_tickStartTime = INT32_MIN;
 	// Hold objects
 	ObjectState* m_holdObjects[8];
 	Set<ObjectState*> m_heldObjects;
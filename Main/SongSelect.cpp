@@ -113,8 +113,11 @@ class SelectionWheel : public Canvas
 	// Style to use for everything song select related
 	Ref<SongSelectStyle> m_style;
 
+	// Used to load the metadata of maps when they are shown
+	MapDatabase* m_mapDatabase;
+
 public:
-	SelectionWheel(Ref<SongSelectStyle> style) : m_style(style)
+	SelectionWheel(Ref<SongSelectStyle> style, MapDatabase* mapDatabase) : m_style(style), m_mapDatabase(mapDatabase)
 	{
 	}
 	void OnMapsAdded(Vector<MapIndex*> maps)
@@ -379,8 +382,8 @@ private:
 
 		Ref<SongSelectItem> newItem = Ref<SongSelectItem>(new SongSelectItem(m_style));
 
-		// Send first map as metadata settings
-		const BeatmapSettings& firstSettings = index->difficulties[0]->settings;
+		// Metadata is only loaded for maps that are shown
+		m_mapDatabase->LoadMetadata(index);
 		newItem->SetMap(index);
 		m_guiElements.Add(index, newItem);
 		return newItem;
@@ -427,6 +430,8 @@ private:
 	Ref<SelectionWheel> m_selectionWheel;
 	// Search field
 	Ref<TextInputField> m_searchField;
+	// Shows the number of maps
+	Label* m_mapCountLabel;
 
 	// Player of preview music
 	PreviewPlayer m_previewPlayer;
@@ -437,6 +442,9 @@ private:
 	// Select sound
 	Sample m_selectSound;
 
+	// A random map is selected once the map index is loaded, maps are added in pages until then
+	bool m_selectRandomPending = true;
+
 public:
 	bool Init() override
 	{
@@ -474,7 +482,11 @@ public:
 			searchFieldSlot->fillX = true;
 			m_searchField->OnTextUpdated.Add(this, &SongSelect_Impl::OnSearchTermChanged);
 
-			m_selectionWheel = Ref<SelectionWheel>(new SelectionWheel(m_style));
+			m_mapCountLabel = new Label();
+			m_mapCountLabel->SetFontSize(20);
+			box->Add(m_mapCountLabel->MakeShared());
+
+			m_selectionWheel = Ref<SelectionWheel>(new SelectionWheel(m_style, &m_mapDatabase));
 			LayoutBox::Slot* selectionSlot = box->Add(m_selectionWheel.As<GUIElementBase>());
 			selectionSlot->fillY = true;
 			m_selectionWheel->OnMapSelected.Add(this, &SongSelect_Impl::OnMapSelected);
@@ -486,14 +498,15 @@ public:
 
 		// Setup the map database
 		m_mapDatabase.AddSearchPath(g_gameConfig.GetString(GameConfigKeys::SongFolder));
+		m_mapDatabase.SetScanThreadCount((uint32)Math::Max(0, g_gameConfig.GetInt(GameConfigKeys::MapScanThreads)));
 
 		m_mapDatabase.OnMapsAdded.Add(m_selectionWheel.GetData(), &SelectionWheel::OnMapsAdded);
 		m_mapDatabase.OnMapsUpdated.Add(m_selectionWheel.GetData(), &SelectionWheel::OnMapsUpdated);
 		m_mapDatabase.OnMapsRemoved.Add(m_selectionWheel.GetData(), &SelectionWheel::OnMapsRemoved);
 		m_mapDatabase.OnMapsCleared.Add(m_selectionWheel.GetData(), &SelectionWheel::OnMapsCleared);
+		m_mapDatabase.OnFoundMaps.Add(this, &SongSelect_Impl::OnFoundMaps);
 		m_mapDatabase.StartSearching();
-
-		m_selectionWheel->SelectRandom();
+		m_UpdateMapCount();
 
 		return true;
 	}
@@ -511,12 +524,12 @@ public:
 
 		// Set current preview audio
 		DifficultyIndex* previewDiff = map->difficulties[0];
-		String audioPath = map->path + Path::sep + previewDiff->settings.audioNoFX;
+		String audioPath = String(map->path) + Path::sep + previewDiff->metadata.audioNoFX;
 
 		AudioStream previewAudio = g_audio->CreateStream(audioPath);
 		if(previewAudio)
 		{
-			previewAudio->SetPosition(previewDiff->settings.previewOffset);
+			previewAudio->SetPosition(previewDiff->metadata.previewOffset);
 			m_previewPlayer.FadeTo(previewAudio);
 		}
 		else
@@ -537,10 +550,16 @@ public:
 		else
 		{
 			String utf8Search = Utility::ConvertToUTF8(search);
-			Map<int32, MapIndex*> filter = m_mapDatabase.FindMaps(utf8Search);
-			m_selectionWheel->SetFilter(filter);
+			m_mapDatabase.FindMapsAsync(utf8Search);
 		}
 	}
+	// When the search started by OnSearchTermChanged is done
+	void OnFoundMaps(Map<int32, MapIndex*> filter)
+	{
+		// The search field might have been cleared in the meantime
+		if(!m_searchField->GetText().empty())
+			m_selectionWheel->SetFilter(filter);
+	}
 
 	virtual void OnKeyPressed(Key key)
 	{
@@ -576,7 +595,7 @@ public:
 			{
 				DifficultyIndex* diff = m_selectionWheel->GetSelectedDifficulty();
 
-				Game* game = Game::Create(diff->path);
+				Game* game = Game::Create(diff->GetPath());
 				if(!game)
 				{
 					Logf("Failed to start game", Logger::Error);
@@ -604,14 +623,32 @@ public:
 	}
 	virtual void Tick(float deltaTime) override
 	{
-		if(m_dbUpdateTimer.Milliseconds() > 500)
+		// Search results, loaded maps and changed maps are received through the database update
+		//	the update is kept short enough to run every frame while these are pending
+		if(m_dbUpdateTimer.Milliseconds() > 500 || m_mapDatabase.IsFindingMaps() || m_mapDatabase.IsLoading() ||
+			m_mapDatabase.IsSearching())
 		{
 			m_mapDatabase.Update();
 			m_dbUpdateTimer.Restart();
+			m_UpdateMapCount();
+		}
+		if(m_selectRandomPending && !m_mapDatabase.IsLoading())
+		{
+			m_selectRandomPending = false;
+			m_selectionWheel->SelectRandom();
 		}
 		m_previewPlayer.Update(deltaTime);
 	}
 
+	// Updates the number of maps displayed below the search field
+	void m_UpdateMapCount()
+	{
+		if(m_mapDatabase.IsLoading())
+			m_mapCountLabel->SetText(Utility::WSprintf(L"Loading maps (%d)", (int32)m_mapDatabase.GetMapCount()));
+		else
+			m_mapCountLabel->SetText(Utility::WSprintf(L"%d maps", (int32)m_mapDatabase.GetMapCount()));
+	}
+
 	virtual void OnSuspend()
 	{
 		m_previewPlayer.Pause();
@@ -622,7 +659,9 @@ public:
 	virtual void OnRestore()
 	{
 		m_previewPlayer.Restore();
-		m_mapDatabase.StartSearching();
+		// Changes made while suspended are reported by the watcher, only search if that is not possible
+		if(!m_mapDatabase.IsWatching())
+			m_mapDatabase.StartSearching();
 
 		OnSearchTermChanged(m_searchField->GetText());
 
@@ -84,6 +84,8 @@ public:
 			return DoLoad();
 		});
 		m_loadingJob->OnFinished.Add(this, &TransitionScreen_Impl::OnFinished);
+		// The user is waiting for this
+		m_loadingJob->priority = JobPriority::Interactive;
 		g_jobSheduler->Queue(m_loadingJob);
 
 		return true;
@@ -0,0 +1,64 @@
+#pragma once
+#include "Shared/Unique.hpp"
+
+// Subsystems that allocations are counted for
+enum class AllocationTag : uint8
+{
+	General = 0,
+	Gameplay,
+	Render,
+	GUI,
+	Audio,
+	Loading,
+	_Length
+};
+
+/*
+	Opt-in tracker that counts the heap allocations made with new and delete
+	allocations and frees are counted for the tag of the innermost AllocationScope on the calling thread
+	new and delete are replaced when this is linked in, while the tracker is disabled they only check a flag
+*/
+namespace AllocationTracker
+{
+	struct Counts
+	{
+		uint64 numAllocations = 0;
+		uint64 numFrees = 0;
+		// Total size of the allocations, freed memory is not subtracted
+		uint64 bytesAllocated = 0;
+
+		Counts& operator+=(const Counts& other);
+	};
+
+	void SetEnabled(bool enabled);
+	bool IsEnabled();
+	const char* GetTagName(AllocationTag tag);
+
+	// Sets the tag allocations on the calling thread are counted for, returns the previous tag
+	AllocationTag SetCurrentTag(AllocationTag tag);
+
+	// Counts since the program started
+	Counts GetCounts(AllocationTag tag);
+	// Marks the start of a new frame, called from the main loop
+	void BeginFrame();
+	// Counts between the last two calls to BeginFrame
+	Counts GetLastFrame(AllocationTag tag);
+	Counts GetLastFrameTotal();
+}
+
+// Counts allocations on this thread for the given tag until the scope ends
+class AllocationScope : public Unique
+{
+public:
+	AllocationScope(AllocationTag tag)
+	{
+		m_previous = AllocationTracker::SetCurrentTag(tag);
+	}
+	~AllocationScope()
+	{
+		AllocationTracker::SetCurrentTag(m_previous);
+	}
+
+private:
+	AllocationTag m_previous;
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include "Shared/Unique.hpp"
+#include "Shared/String.hpp"
+#include "Shared/Buffer.hpp"
+#include "Shared/Vector.hpp"
+#include "Shared/Action.hpp"
+
+/*
+	Result of an asynchronous read
+*/
+struct AsyncReadResult
+{
+	String path;
+	size_t offset = 0;
+	// The data that was read, shorter than the requested length if the end of the file was reached
+	Buffer data;
+	// False if the file could not be opened or read
+	bool success = false;
+};
+
+/*
+	Asynchronous read of a part of a file
+*/
+struct AsyncReadRequest
+{
+	// Length that reads the file until the end
+	static const size_t wholeFile = (size_t)-1;
+
+	AsyncReadRequest() = default;
+	template<typename Callback>
+	AsyncReadRequest(const String& path, Callback&& callback, size_t offset = 0, size_t length = wholeFile)
+		: path(path), offset(offset), length(length), callback(std::forward<Callback>(callback))
+	{
+	}
+
+	String path;
+	size_t offset = 0;
+	size_t length = wholeFile;
+	// Called with the result from the thread that calls AsyncFileReader::Update
+	Action<void, AsyncReadResult&> callback;
+};
+
+/*
+	Reads files without blocking the thread that requests the reads
+	reads are done with io_uring on Linux kernels that support it, otherwise they are done on worker threads
+	a batch of requests is submitted at once, so loaders can start many reads with a single call
+	callbacks are not called from the reading threads but from Update, like the callbacks of the JobSheduler
+*/
+class AsyncFileReader : public Unique
+{
+public:
+	// Uses io_uring when allowed and supported, otherwise reads files on the given number of threads
+	AsyncFileReader(uint32 numThreads = 2, bool allowIoUring = true);
+	// Waits for the reads that are in progress, the callbacks of reads that were not handled by Update are not called
+	~AsyncFileReader();
+
+	void Read(AsyncReadRequest&& request);
+	// Submits all the requests at once, the requests are moved out of the vector
+	void Read(Vector<AsyncReadRequest>& requests);
+
+	// Calls the callbacks of finished reads
+	// should be called from the main thread only
+	void Update();
+	// Waits until all submitted reads are finished and calls their callbacks
+	void WaitAll();
+
+	// Number of reads that have been submitted but whose callback has not been called yet
+	uint32 GetNumPending() const;
+	bool IsUsingIoUring() const;
+
+private:
+	class AsyncFileReader_Impl* m_impl;
+};
@@ -3,11 +3,20 @@
 #include "Shared/Vector.hpp"
 #include "Shared/Map.hpp"
 #include "Shared/String.hpp"
+#include "Shared/Buffer.hpp"
+
+// True for types that are serialized by copying their memory, vectors of these types are read and written in a single call
+template<typename T>
+struct IsBulkSerializable : std::integral_constant<bool,
+	!std::is_pointer<T>::value && !std::is_same<T, bool>::value && std::is_trivially_copyable<T>::value>
+{
+};
 
 /*
 	Abstract binary stream base class
 	a stream can either be operating as a reading stream or as a writing stream
 	allows custom structures and String,Vector and Map types
+	memory streams are read and written inline, other streams go through the virtual Serialize function
 
 	Example:
 	{
@@ -64,8 +73,12 @@ public:
 	{
 		T* tempObj = &obj;
 		bool r = T::StaticSerialize(*this, tempObj);
-		if(IsReading())
-			obj = *tempObj;
+		if(IsReading() && tempObj != &obj)
+		{
+			// StaticSerialize allocated a new object
+			obj = std::move(*tempObj);
+			delete tempObj;
+		}
 		return r;
 	}
 
@@ -73,10 +86,36 @@ public:
 	template<typename T>
 	typename std::enable_if<!std::is_pointer<T>::value && std::is_trivially_copyable<T>::value, bool>::type SerializeObject(T& obj)
 	{
-		Serialize(&obj, sizeof(obj));
+		SerializeBytes(&obj, sizeof(obj));
 		return true;
 	}
 
+	// Reads or writes data based on the stream's mode of operation
+	// this avoids the virtual Serialize call for memory streams
+	size_t SerializeBytes(void* data, size_t len)
+	{
+		if(!m_buffer)
+			return Serialize(data, len);
+
+		if(m_isReading)
+		{
+			size_t available = m_cursor < m_buffer->size() ? m_buffer->size() - m_cursor : 0;
+			if(len > available)
+				len = available;
+			if(len > 0)
+				memcpy(data, m_buffer->data() + m_cursor, len);
+		}
+		else
+		{
+			if(m_cursor + len > m_buffer->size())
+				m_buffer->resize(m_cursor + len);
+			if(len > 0)
+				memcpy(m_buffer->data() + m_cursor, data, len);
+		}
+		m_cursor += len;
+		return len;
+	}
+
 	// Reads or writes data based on the stream's mode of operation
 	virtual size_t Serialize(void* data, size_t len) = 0;
 	// Seeks to a position in the stream
@@ -114,23 +153,57 @@ public:
 		return !m_isReading;
 	}
 protected:
+	template<typename T>
+	bool m_SerializeVector(Vector<T>& obj, std::true_type bulk);
+	template<typename T>
+	bool m_SerializeVector(Vector<T>& obj, std::false_type bulk);
+
 	bool m_isReading;
+	// Buffer and position of memory streams
+	Buffer* m_buffer = nullptr;
+	size_t m_cursor = 0;
 };
 
 template<typename T>
 bool BinaryStream::SerializeObject(Vector<T>& obj)
+{
+	return m_SerializeVector(obj, IsBulkSerializable<T>());
+}
+template<typename T>
+bool BinaryStream::m_SerializeVector(Vector<T>& obj, std::true_type bulk)
+{
+	uint32 len = (uint32)obj.size();
+	*this << len;
+	if(IsReading())
+	{
+		// Don't allocate more than what is left in the stream when the length is corrupted
+		size_t remaining = GetSize() - Tell();
+		if((size_t)len * sizeof(T) > remaining)
+		{
+			obj.clear();
+			return false;
+		}
+		obj.resize(len);
+	}
+	size_t size = (size_t)len * sizeof(T);
+	return size == 0 || SerializeBytes(obj.data(), size) == size;
+}
+template<typename T>
+bool BinaryStream::m_SerializeVector(Vector<T>& obj, std::false_type bulk)
 {
 	if(IsReading())
 	{
 		obj.clear();
 		uint32 len;
 		*this << len; 
+		// Every element takes up at least a byte
+		obj.reserve(std::min<size_t>(len, GetSize() - Tell()));
 		for(uint32 i = 0; i < len; i++)
 		{
 			T v;
 			bool ok = SerializeObject(v);
 			assert(ok);
-			obj.Add(v);
+			obj.push_back(std::move(v));
 		}
 	}
 	else
@@ -161,7 +234,8 @@ bool BinaryStream::SerializeObject(Map<K, V>& obj)
 			ok = ok && SerializeObject(k);
 			ok = ok && SerializeObject(v);
 			assert(ok);
-			obj.Add(k, v);
+			// Maps are written in order, so every key goes at the end
+			obj.emplace_hint(obj.end(), std::move(k), std::move(v));
 		}
 	}
 	else
@@ -1,140 +1,283 @@
 #pragma once
 #include "Shared/Utility.hpp"
-#include "Shared/Map.hpp"
+#include "Shared/Unique.hpp"
 #include "Shared/Bindable.hpp"
 
 typedef void* DelegateHandle;
 
 /*
 	Template delegate class, can have multiple registered classes that handle a call to this function
+	handlers are stored in a flat array that has space for two handlers inside of the delegate, so most delegates never allocate
+	static and member functions are called through a plain function pointer, lambdas are allocated and called through IFunctionBinding
+	handlers are called in the order they were added, handlers removed during a call are skipped and removed from the array after the call
 */
 template<typename... A>
-class Delegate
+class Delegate : Unique
 {
-	Map<void*, IFunctionBinding<void, A...>*> staticMap;
-	Map<void*, Map<void*, IFunctionBinding<void, A...>*>> objectMap;
-	Map<void*, IFunctionBinding<void, A...>*> lambdaMap;
 public:
+	Delegate() = default;
+	Delegate(Delegate&& other)
+	{
+		m_MoveFrom(other);
+	}
+	Delegate& operator=(Delegate&& other)
+	{
+		if(this != &other)
+		{
+			m_Free();
+			m_MoveFrom(other);
+		}
+		return *this;
+	}
 	~Delegate()
 	{
-		Clear();
+		m_Free();
 	}
 
 	// Adds an object function handler
 	template<typename Class>
 	void Add(Class* object, void (Class::*func)(A...))
 	{
-		void* id = Utility::UnionCast<void*>(func);
-		auto& fmap = objectMap.FindOrAdd(object);
-		assert(!fmap.Contains(id));
-		fmap.Add(id, new ObjectBinding<Class, void, A...>(object, func));
+		Binding binding = m_MakeBinding(Object, object, func);
+		binding.invoke = &m_CallObject<Class>;
+		assert(m_Find(binding) == npos);
+		m_Add(binding);
 	}
 	// Adds a static function handler
 	void Add(void (*func)(A...))
 	{
-		void* id = Utility::UnionCast<void*>(func);
-		assert(!staticMap.Contains(id));
-		staticMap.Add(id, new StaticBinding<void, A...>(func));
+		Binding binding = m_MakeBinding(Static, nullptr, func);
+		binding.invoke = &m_CallStatic;
+		assert(m_Find(binding) == npos);
+		m_Add(binding);
 	}
 	// Adds a lambda function as a handler for this delegate
 	template<typename T> DelegateHandle AddLambda(T&& lambda)
 	{
-		LambdaBinding<T, void, A...>* binding = new LambdaBinding<T, void, A...>(std::forward<T>(lambda));
-		void* id = binding;
-		assert(!lambdaMap.Contains(id));
-		lambdaMap.Add(id, binding);
-		return id;
+		IFunctionBinding<void, A...>* lambdaBinding = new LambdaBinding<T, void, A...>(std::forward<T>(lambda));
+		Binding binding = m_MakeBinding(Lambda, lambdaBinding, nullptr);
+		binding.invoke = &m_CallLambda;
+		m_Add(binding);
+		return lambdaBinding;
 	}
 
 	// Removes an object handler
 	template<typename Class>
 	void Remove(Class* object, void(Class::*func)(A...))
 	{
-		void* id = Utility::UnionCast<void*>(func);
-		assert(objectMap.Contains(object));
-		auto& fmap = objectMap[object];
-		assert(fmap.Contains(id));
-		fmap.erase(id);
-		if(fmap.empty())
-			objectMap.erase(object);
+		size_t index = m_Find(m_MakeBinding(Object, object, func));
+		assert(index != npos);
+		if(index != npos)
+			m_Remove(index);
 	}
 	// Removes a static handler
 	void Remove(void(*func)(A...))
 	{
-		void* id = Utility::UnionCast<void*>(func);
-		assert(staticMap.Contains(id));
-		delete staticMap[id];
-		staticMap.erase(id);
+		size_t index = m_Find(m_MakeBinding(Static, nullptr, func));
+		assert(index != npos);
+		if(index != npos)
+			m_Remove(index);
 	}
 	// Removes a lambda by it's handle
 	void Remove(DelegateHandle handle)
 	{
-		assert(lambdaMap.Contains(handle));
-		delete lambdaMap[handle];
-		lambdaMap.erase(handle);
+		size_t index = m_Find(m_MakeBinding(Lambda, handle, nullptr));
+		assert(index != npos);
+		if(index != npos)
+			m_Remove(index);
 	}
 
 	// Removes all handlers belonging to a specific object
 	void RemoveAll(void* object)
 	{
-		auto it = objectMap.find(object);
-		if(it != objectMap.end())
+		for(size_t i = m_size; i > 0; i--)
 		{
-			for(auto& f : it->second)
-			{
-				delete f.second;
-			}
+			Binding& binding = m_bindings[i - 1];
+			if(binding.type == Object && binding.object == object && !binding.removed)
+				m_Remove(i - 1);
 		}
-		objectMap.erase(it);
 	}
 
 	// Removes all handlers
 	void Clear()
 	{
-		// Cleanup the pointers
-		for(auto& h : staticMap)
+		for(size_t i = m_size; i > 0; i--)
+		{
+			if(!m_bindings[i - 1].removed)
+				m_Remove(i - 1);
+		}
+	}
+
+	// Calls the delegate
+	//	handlers are visited by index since they can add handlers, which can move the array
+	void Call(A... args)
+	{
+		m_callDepth++;
+		for(uint32 i = 0; i < m_size; i++)
+		{
+			const Binding& binding = m_bindings[i];
+			if(!binding.removed)
+				binding.invoke(binding, args...);
+		}
+		m_callDepth--;
+		if(m_callDepth == 0 && m_numRemoved > 0)
+			m_RemoveMarked();
+	}
+
+	// True if anything function is handling this delegate being called
+	bool IsHandled() const
+	{
+		return m_size > m_numRemoved;
+	}
+
+private:
+	static const size_t npos = (size_t)-1;
+	// Number of handlers that are stored inside the delegate
+	static const uint32 inlineCapacity = 2;
+	// Space for a member function pointer, these can be larger than a normal pointer
+	static const size_t functionSize = sizeof(void*) * 3;
+
+	enum BindingType : uint8
+	{
+		Static,
+		Object,
+		Lambda,
+	};
+	struct Binding
+	{
+		// Calls the function of this binding with the arguments
+		void (*invoke)(const Binding&, A...);
+		// The object for member functions or the IFunctionBinding for lambdas
+		void* object;
+		// Static or member function pointer
+		uint8 function[functionSize];
+		BindingType type;
+		// Set for handlers that are removed during a call
+		bool removed;
+	};
+
+	template<typename Function>
+	static Binding m_MakeBinding(BindingType type, void* object, Function func)
+	{
+		static_assert(sizeof(Function) <= functionSize, "Function pointer does not fit in the binding");
+		Binding binding;
+		memset(&binding, 0, sizeof(Binding));
+		binding.type = type;
+		binding.object = object;
+		memcpy(binding.function, &func, sizeof(Function));
+		return binding;
+	}
+	template<typename Class>
+	static void m_CallObject(const Binding& binding, A... args)
+	{
+		void (Class::*func)(A...);
+		memcpy(&func, binding.function, sizeof(func));
+		(((Class*)binding.object)->*func)(args...);
+	}
+	static void m_CallStatic(const Binding& binding, A... args)
+	{
+		void (*func)(A...);
+		memcpy(&func, binding.function, sizeof(func));
+		func(args...);
+	}
+	static void m_CallLambda(const Binding& binding, A... args)
+	{
+		((IFunctionBinding<void, A...>*)binding.object)->Call(args...);
+	}
+
+	// Finds a handler that is not removed
+	size_t m_Find(const Binding& binding) const
+	{
+		for(size_t i = 0; i < m_size; i++)
 		{
-			delete h.second;
+			const Binding& other = m_bindings[i];
+			if(!other.removed && other.type == binding.type && other.object == binding.object &&
+				memcmp(other.function, binding.function, functionSize) == 0)
+				return i;
 		}
-		for(auto& h : objectMap)
+		return npos;
+	}
+	void m_Add(const Binding& binding)
+	{
+		if(m_size == m_capacity)
 		{
-			for(auto& f : h.second)
-			{
-				delete f.second;
-			}
+			// The old array is not used anymore by the handler that is being called
+			Binding* bindings = new Binding[m_capacity * 2];
+			memcpy(bindings, m_bindings, m_size * sizeof(Binding));
+			if(m_bindings != m_inlineBindings)
+				delete[] m_bindings;
+			m_bindings = bindings;
+			m_capacity *= 2;
 		}
-		for(auto& h : lambdaMap)
+		m_bindings[m_size++] = binding;
+	}
+	void m_Remove(size_t index)
+	{
+		// Handlers can't be moved during a call, so they are only marked
+		if(m_callDepth > 0)
 		{
-			delete h.second;
+			m_bindings[index].removed = true;
+			m_numRemoved++;
+			return;
 		}
-		staticMap.clear();
-		objectMap.clear();
-		lambdaMap.clear();
+		m_Release(m_bindings[index]);
+		memmove(m_bindings + index, m_bindings + index + 1, (m_size - index - 1) * sizeof(Binding));
+		m_size--;
 	}
-
-	// Calls the delegate
-	void Call(A... args)
+	// Removes the handlers that were marked during a call
+	void m_RemoveMarked()
 	{
-		for(auto& h : staticMap)
+		uint32 size = 0;
+		for(uint32 i = 0; i < m_size; i++)
 		{
-			h.second->Call(args...);
+			if(m_bindings[i].removed)
+				m_Release(m_bindings[i]);
+			else
+				m_bindings[size++] = m_bindings[i];
 		}
-		for(auto& h : objectMap)
+		m_size = size;
+		m_numRemoved = 0;
+	}
+	void m_Free()
+	{
+		assert(m_callDepth == 0);
+		for(uint32 i = 0; i < m_size; i++)
+			m_Release(m_bindings[i]);
+		if(m_bindings != m_inlineBindings)
+			delete[] m_bindings;
+	}
+	// Takes the handlers of another delegate, which is left empty
+	void m_MoveFrom(Delegate& other)
+	{
+		assert(other.m_callDepth == 0);
+		if(other.m_bindings == other.m_inlineBindings)
 		{
-			for(auto& f : h.second)
-			{
-				f.second->Call(args...);
-			}
+			memcpy(m_inlineBindings, other.m_inlineBindings, other.m_size * sizeof(Binding));
+			m_bindings = m_inlineBindings;
 		}
-		for(auto& h : lambdaMap)
+		else
 		{
-			h.second->Call(args...);
+			m_bindings = other.m_bindings;
 		}
+		m_size = other.m_size;
+		m_capacity = other.m_capacity;
+		m_numRemoved = other.m_numRemoved;
+		m_callDepth = 0;
+		other.m_bindings = other.m_inlineBindings;
+		other.m_size = 0;
+		other.m_capacity = inlineCapacity;
+		other.m_numRemoved = 0;
 	}
-
-	// True if anything function is handling this delegate being called
-	bool IsHandled() const
+	static void m_Release(Binding& binding)
 	{
-		return !staticMap.empty() || !objectMap.empty() || !lambdaMap.empty();
+		if(binding.type == Lambda)
+			delete (IFunctionBinding<void, A...>*)binding.object;
 	}
+
+	Binding m_inlineBindings[inlineCapacity];
+	Binding* m_bindings = m_inlineBindings;
+	uint32 m_size = 0;
+	uint32 m_capacity = inlineCapacity;
+	uint32 m_numRemoved = 0;
+	uint32 m_callDepth = 0;
 };
@@ -32,4 +32,32 @@ public:
 	FileWriter() = default;
 	FileWriter(File& file);
 	virtual size_t Serialize(void* data, size_t len);
-};
\ No newline at end of file
+};
+
+/*
+	Stream that reads from a file through a buffer
+	reads ahead by the size of the buffer, so reading small fields or text does not need a call to File::Read every time
+	the file size is only checked once when the reader is created and the file should not be used directly while reading
+*/
+class BufferedFileReader : public FileStreamBase
+{
+public:
+	BufferedFileReader(File& file, size_t bufferSize = 64 * 1024);
+	virtual size_t Serialize(void* data, size_t len);
+	virtual void Seek(size_t pos);
+	virtual size_t Tell() const;
+	virtual size_t GetSize() const;
+
+private:
+	// Reads the next part of the file into the buffer
+	bool m_Fill();
+
+	Buffer m_readBuffer;
+	// Position of the start of the buffer in the file
+	size_t m_bufferStart = 0;
+	// Number of valid bytes in the buffer
+	size_t m_bufferSize = 0;
+	// Read position in the buffer
+	size_t m_bufferPosition = 0;
+	size_t m_fileSize = 0;
+};
@@ -0,0 +1,32 @@
+#pragma once
+#include "Shared/String.hpp"
+#include "Shared/Vector.hpp"
+#include "Shared/Unique.hpp"
+
+/*
+	Watches folders and all their subfolders for changed files
+	Uses inotify on linux, not available on other platforms, where the folders need to be polled instead
+*/
+class FileWatcher : public Unique
+{
+public:
+	FileWatcher();
+	~FileWatcher();
+
+	// Starts watching a folder and its subfolders
+	//	returns false if the folder can not be watched
+	bool Watch(const String& folder);
+	// Stops watching all folders
+	void Clear();
+
+	// Returns true if changes are being received for all the folders passed to Watch
+	bool IsWatching() const;
+
+	// Returns the paths of files that were added, changed or removed since the last call
+	//	for removed or moved folders the path of the folder itself is returned
+	//	'overflow' is set when changes were lost and the folders need to be scanned completely
+	Vector<String> GetChanges(bool& overflow);
+
+private:
+	class FileWatcher_Impl* m_impl;
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include "Shared/FlatHashTable.hpp"
+
+/*
+	Hash map that stores its entries in a contiguous array, has the same interface as Map
+	faster than Map for lookups, but unordered and adding or removing entries invalidates pointers to values
+	the keys of the entries should not be modified through iterators
+*/
+template<typename K, typename V, typename H = FlatHash<K>>
+class FlatHashMap : public FlatHashTable<K, std::pair<K, V>, H>
+{
+	typedef FlatHashTable<K, std::pair<K, V>, H> Base;
+	using Base::m_entries;
+	using Base::m_FindEntry;
+	using Base::m_AddEntry;
+	using Base::npos;
+
+public:
+	FlatHashMap() = default;
+	FlatHashMap(std::initializer_list<std::pair<K, V>> entries)
+	{
+		for(auto& entry : entries)
+			Add(entry.first, entry.second);
+	}
+
+	V& FindOrAdd(const K& key, const V& defaultValue = V())
+	{
+		size_t index = m_FindEntry(key);
+		if(index != npos)
+			return m_entries[index].second;
+		return m_AddEntry(std::pair<K, V>(key, defaultValue)).second;
+	}
+	V& Add(const K& key, const V& value = V())
+	{
+		size_t index = m_FindEntry(key);
+		if(index != npos)
+			return m_entries[index].second = value;
+		return m_AddEntry(std::pair<K, V>(key, value)).second;
+	}
+	V& operator[](const K& key)
+	{
+		return FindOrAdd(key);
+	}
+
+	// Finds the value in the map or returns null
+	V* Find(const K& key)
+	{
+		size_t index = m_FindEntry(key);
+		return index == npos ? nullptr : &m_entries[index].second;
+	}
+	const V* Find(const K& key) const
+	{
+		size_t index = m_FindEntry(key);
+		return index == npos ? nullptr : &m_entries[index].second;
+	}
+};
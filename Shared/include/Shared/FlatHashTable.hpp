@@ -0,0 +1,239 @@
+#pragma once
+#include "Shared/Vector.hpp"
+#include "Shared/String.hpp"
+#include <functional>
+
+// Default hash function for the flat hash containers
+template<typename K>
+struct FlatHash
+{
+	size_t operator()(const K& key) const
+	{
+		return std::hash<K>()(key);
+	}
+};
+template<typename T>
+struct FlatHash<StringBase<T>>
+{
+	size_t operator()(const StringBase<T>& key) const
+	{
+		return std::hash<std::basic_string<T>>()(key);
+	}
+};
+
+/*
+	Base class of FlatHashMap and FlatHashSet
+	entries are stored in a contiguous array and found through a separate table of indices that is searched with linear probing
+	tables with only a few entries have no index table and are searched linearly instead
+	removing an entry moves the last entry into its place, so the iteration order changes and pointers to entries are invalidated by adding and removing
+*/
+template<typename K, typename Entry, typename H>
+class FlatHashTable
+{
+public:
+	typedef typename Vector<Entry>::iterator iterator;
+	typedef typename Vector<Entry>::const_iterator const_iterator;
+
+	iterator begin()
+	{
+		return m_entries.begin();
+	}
+	iterator end()
+	{
+		return m_entries.end();
+	}
+	const_iterator begin() const
+	{
+		return m_entries.begin();
+	}
+	const_iterator end() const
+	{
+		return m_entries.end();
+	}
+	size_t size() const
+	{
+		return m_entries.size();
+	}
+	bool empty() const
+	{
+		return m_entries.empty();
+	}
+	void clear()
+	{
+		m_entries.clear();
+		m_slots.clear();
+	}
+	void reserve(size_t count)
+	{
+		m_entries.reserve(count);
+		if(count > linearSearchLimit && count * 2 > m_slots.size())
+			m_Rehash(count * 2);
+	}
+
+	bool Contains(const K& key) const
+	{
+		return m_FindEntry(key) != npos;
+	}
+	iterator find(const K& key)
+	{
+		size_t index = m_FindEntry(key);
+		return index == npos ? end() : begin() + index;
+	}
+	const_iterator find(const K& key) const
+	{
+		size_t index = m_FindEntry(key);
+		return index == npos ? end() : begin() + index;
+	}
+
+	// Removes the entry with the given key, returns the number of removed entries
+	size_t erase(const K& key)
+	{
+		size_t index = m_FindEntry(key);
+		if(index == npos)
+			return 0;
+		m_RemoveEntry(index);
+		return 1;
+	}
+	// Removes the entry and returns an iterator to the entry that took its place
+	iterator erase(const_iterator it)
+	{
+		size_t index = it - m_entries.cbegin();
+		m_RemoveEntry(index);
+		return m_entries.begin() + index;
+	}
+	bool Remove(const K& key)
+	{
+		return erase(key) != 0;
+	}
+
+protected:
+	static const size_t npos = (size_t)-1;
+	// Tables up to this size are searched linearly
+	static const size_t linearSearchLimit = 8;
+
+	struct Slot
+	{
+		// Index of the entry + 1, 0 for empty slots
+		uint32 index;
+		uint32 hash;
+	};
+
+	static const K& m_GetKey(const K& key)
+	{
+		return key;
+	}
+	template<typename V>
+	static const K& m_GetKey(const std::pair<K, V>& entry)
+	{
+		return entry.first;
+	}
+	// Mixes the hash so keys that only differ in their high bits, like pointers, are spread over the table
+	static uint32 m_Hash(const K& key)
+	{
+		uint64 hash = (uint64)H()(key);
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdull;
+		hash ^= hash >> 33;
+		return (uint32)hash;
+	}
+
+	size_t m_FindEntry(const K& key) const
+	{
+		if(m_slots.empty())
+		{
+			for(size_t i = 0; i < m_entries.size(); i++)
+			{
+				if(m_GetKey(m_entries[i]) == key)
+					return i;
+			}
+			return npos;
+		}
+
+		uint32 hash = m_Hash(key);
+		size_t mask = m_slots.size() - 1;
+		for(size_t i = hash & mask;; i = (i + 1) & mask)
+		{
+			const Slot& slot = m_slots[i];
+			if(slot.index == 0)
+				return npos;
+			if(slot.hash == hash && m_GetKey(m_entries[slot.index - 1]) == key)
+				return slot.index - 1;
+		}
+	}
+	// Adds an entry whose key is not in the table yet
+	Entry& m_AddEntry(Entry&& entry)
+	{
+		m_entries.push_back(std::move(entry));
+		size_t index = m_entries.size() - 1;
+		if(m_slots.empty() && m_entries.size() <= linearSearchLimit)
+			return m_entries[index];
+
+		// Keep the index table at most half full
+		if(m_entries.size() * 2 > m_slots.size())
+			m_Rehash(m_entries.size() * 2);
+		else
+			m_InsertSlot(index, m_Hash(m_GetKey(m_entries[index])));
+		return m_entries[index];
+	}
+	void m_RemoveEntry(size_t index)
+	{
+		size_t last = m_entries.size() - 1;
+		if(!m_slots.empty())
+		{
+			m_RemoveSlot(m_FindSlot(index));
+			if(index != last)
+				m_slots[m_FindSlot(last)].index = (uint32)index + 1;
+		}
+		if(index != last)
+			m_entries[index] = std::move(m_entries[last]);
+		m_entries.pop_back();
+	}
+
+	// Rebuilds the index table with at least the given number of slots
+	void m_Rehash(size_t minSlots)
+	{
+		size_t numSlots = 16;
+		while(numSlots < minSlots)
+			numSlots *= 2;
+		m_slots.assign(numSlots, Slot{ 0, 0 });
+		for(size_t i = 0; i < m_entries.size(); i++)
+			m_InsertSlot(i, m_Hash(m_GetKey(m_entries[i])));
+	}
+	void m_InsertSlot(size_t index, uint32 hash)
+	{
+		size_t mask = m_slots.size() - 1;
+		size_t i = hash & mask;
+		while(m_slots[i].index != 0)
+			i = (i + 1) & mask;
+		m_slots[i].index = (uint32)index + 1;
+		m_slots[i].hash = hash;
+	}
+	// Finds the slot that refers to an entry
+	size_t m_FindSlot(size_t index) const
+	{
+		size_t mask = m_slots.size() - 1;
+		size_t i = m_Hash(m_GetKey(m_entries[index])) & mask;
+		while(m_slots[i].index != index + 1)
+			i = (i + 1) & mask;
+		return i;
+	}
+	// Empties a slot and moves following slots back so no gaps are left in their probe sequences
+	void m_RemoveSlot(size_t hole)
+	{
+		size_t mask = m_slots.size() - 1;
+		for(size_t i = (hole + 1) & mask; m_slots[i].index != 0; i = (i + 1) & mask)
+		{
+			// A slot can be moved into the hole if the hole is not before its ideal position
+			size_t ideal = m_slots[i].hash & mask;
+			if(((i - ideal) & mask) >= ((i - hole) & mask))
+			{
+				m_slots[hole] = m_slots[i];
+				hole = i;
+			}
+		}
+		m_slots[hole].index = 0;
+	}
+
+	Vector<Entry> m_entries;
+	Vector<Slot> m_slots;
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include "Shared/Vector.hpp"
+#include "Shared/Unique.hpp"
+#include <new>
+#include <cstddef>
+
+/*
+	Linear allocator for data that only lives for a single frame
+	allocations just advance a pointer in a block of memory, everything is freed at once by calling Reset
+	destructors are not called by the arena, objects that need them have to be destroyed by their owner before the reset
+	the blocks are kept after a reset so a frame that allocates as much as the last one does not touch the heap
+	not thread safe
+*/
+class FrameArena : public Unique
+{
+public:
+	FrameArena(size_t blockSize = 64 * 1024);
+	~FrameArena();
+
+	// Allocates uninitialized memory that stays valid until the next reset
+	void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	// Constructs an object in the arena
+	template<typename T, typename... Args>
+	T* New(Args&&... args)
+	{
+		return new(Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+	}
+	// Allocates a default constructed array in the arena
+	template<typename T>
+	T* NewArray(size_t count)
+	{
+		T* array = (T*)Allocate(sizeof(T) * count, alignof(T));
+		for(size_t i = 0; i < count; i++)
+			new(array + i) T();
+		return array;
+	}
+	// Copies a string into the arena
+	const char* CopyString(const char* str, size_t length);
+
+	// Frees all allocations
+	// when the last frame needed more than one block they are replaced by a single block that fits everything
+	void Reset();
+
+	// Number of bytes allocated since the last reset
+	size_t GetUsed() const;
+	// Total size of the blocks owned by the arena
+	size_t GetCapacity() const;
+
+private:
+	struct Block
+	{
+		uint8* data;
+		size_t size;
+	};
+
+	void m_AddBlock(size_t minSize);
+
+	size_t m_blockSize;
+	Vector<Block> m_blocks;
+	// Offset in the last block
+	size_t m_offset = 0;
+	size_t m_used = 0;
+};
+
+/*
+	Two frame arenas that are swapped every frame
+	this allows one thread to fill the current arena while another thread still reads the data from the previous frame
+	the caller has to make sure the previous frame is no longer used before calling Swap again
+*/
+class DoubleBufferedFrameArena : public Unique
+{
+public:
+	DoubleBufferedFrameArena(size_t blockSize = 64 * 1024);
+
+	// The arena to allocate the current frame's data from
+	FrameArena& Get();
+	// The arena that contains the previous frame's data
+	FrameArena& GetPrevious();
+	// Starts a new frame, the arena of the frame before the previous one is reset and used for the new frame
+	void Swap();
+
+private:
+	FrameArena m_arenas[2];
+	uint32 m_current = 0;
+};
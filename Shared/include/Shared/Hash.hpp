@@ -0,0 +1,10 @@
+#pragma once
+
+/*
+	Non-cryptographic hash functions
+*/
+namespace Hash
+{
+	// 64-bit xxHash (XXH64) of a block of memory, fast enough to hash whole files
+	uint64 XXHash64(const void* data, size_t length, uint64 seed = 0);
+}
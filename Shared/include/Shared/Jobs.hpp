@@ -5,6 +5,7 @@
 #include "Shared/Unique.hpp"
 #include "Shared/Ref.hpp"
 #include "Shared/Delegate.hpp"
+#include <atomic>
 
 /*
 	Additional job flags,
@@ -18,6 +19,18 @@ enum class JobFlags : uint8
 JobFlags operator|(JobFlags a, JobFlags b);
 JobFlags operator&(JobFlags a, JobFlags b);
 
+/*
+	Order in which queued jobs are started, jobs with a higher priority are started first
+*/
+enum class JobPriority : uint8
+{
+	// Jobs the user is waiting for, such as loading a game
+	Interactive = 0,
+	Normal,
+	// Jobs that can be delayed, such as prefetching or writing caches
+	Background,
+};
+
 /*
 	A single task that gets completed by the JobSheduler
 	abstract
@@ -33,11 +46,14 @@ public:
 	bool IsQueued() const;
 
 	// Either cancel this job or wait till it finished if it is already being processed
+	//	should only be called from the main thread, since finished jobs are removed from the sheduler
 	void Terminate();
 	
 	// Flags for jobs
 	// make sure to add the IO flag if this job performs file operations
 	JobFlags jobFlags = JobFlags::None;
+	// Priority for starting this job, changing it has no effect once the job is queued
+	JobPriority priority = JobPriority::Normal;
 
 	// Performs the task to be done, returns success
 	virtual bool Run() = 0;
@@ -54,7 +70,8 @@ public:
 
 private:
 	bool m_ret = false;
-	bool m_finished = false;
+	// Set by the job thread once the job ran, can be checked from any thread
+	std::atomic<bool> m_finished = { false };
 	class JobSheduler_Impl* m_sheduler = nullptr;
 	friend class JobSheduler_Impl;
 };
@@ -96,19 +113,30 @@ Job JobBase::CreateLambda(Lambda&& obj, Args... args)
 /*
 	The manager for performing asynchronous tasks
 	you should only have one of these
+
+	every worker thread has its own queue, idle workers take jobs from the queues of other workers
+	workers sleep until jobs are queued, so queued jobs are started right away if a worker is available
+	only a limited number of IO jobs runs at the same time, so other jobs can still run while a lot of files are being read
 */
 class JobSheduler : public Unique
 {
 public:
-	JobSheduler();
+	// Creates the worker threads, 0 uses the number of hardware threads that are not used by the main and audio threads
+	JobSheduler(uint32 numThreads = 0);
 	~JobSheduler();
 
+	// Number of worker threads
+	uint32 GetNumThreads() const;
+
 	// Runs callbacks on finished tasks on the main thread
 	// should thus be called from the main thread only
 	void Update();
 
 	// Queue job
 	bool Queue(Job job);
+	// Removes a queued job that was not started yet, returns false if it already started
+	//	can be called from any thread, unlike JobBase::Terminate
+	bool Dequeue(Job job);
 
 private:
 	class JobSheduler_Impl* m_impl;
@@ -0,0 +1,367 @@
+#pragma once
+#include "Shared/Types.hpp"
+#include "Shared/Unique.hpp"
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <type_traits>
+#include <cassert>
+
+// Size of a cache line, indices written by different threads are kept this far apart
+static const size_t CacheLineSize = 64;
+
+/*
+	Lets threads wait until a condition on a lock free queue is met
+	waiting threads first spin for a short time and then sleep until they are notified
+	notifying is only an atomic load if no thread is sleeping
+*/
+class QueueWaiter : Unique
+{
+public:
+	QueueWaiter() = default;
+
+	// Waits until ready returns true
+	template<typename Predicate>
+	void Wait(Predicate ready)
+	{
+		for(uint32 i = 0; i < spinCount; i++)
+		{
+			if(ready())
+				return;
+			std::this_thread::yield();
+		}
+
+		m_waiters.fetch_add(1);
+		// Either this thread sees the change that it waits for or the notifying thread sees this thread waiting
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, ready);
+		}
+		m_waiters.fetch_sub(1);
+	}
+	// Wakes up the waiting threads, should be called after the change that they wait for
+	void Notify()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(m_waiters.load(std::memory_order_relaxed) == 0)
+			return;
+		// Taking the lock makes sure a thread that checked the condition before the change is waiting on the condition variable
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+		}
+		m_condition.notify_all();
+	}
+
+private:
+	static const uint32 spinCount = 32;
+
+	std::atomic<uint32> m_waiters = { 0 };
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+};
+
+/*
+	Bounded lock free queue with a single producer and a single consumer thread
+	the capacity is rounded up to a power of two
+	TryPush and TryPop return false instead of waiting when the queue is full or empty
+	Push and Pop wait for space or items and wake up the other thread when it is waiting, so a thread that waits in Pop is only woken up by Push
+*/
+template<typename T>
+class SPSCQueue : Unique
+{
+public:
+	SPSCQueue(size_t capacity)
+	{
+		size_t size = 2;
+		while(size < capacity)
+			size *= 2;
+		m_items = new Storage[size];
+		m_mask = size - 1;
+	}
+	~SPSCQueue()
+	{
+		size_t tail = m_tail.index.load(std::memory_order_relaxed);
+		for(size_t i = m_head.index.load(std::memory_order_relaxed); i != tail; i++)
+			m_Item(i)->~T();
+		delete[] m_items;
+	}
+
+	// Called by the producer
+	bool TryPush(const T& item)
+	{
+		return m_TryPush(item);
+	}
+	bool TryPush(T&& item)
+	{
+		return m_TryPush(std::move(item));
+	}
+	// Waits until there is space in the queue, returns false if the queue is closed
+	bool Push(T item)
+	{
+		m_notFull.Wait([&]() { return m_closed.load(std::memory_order_acquire) || !m_Full(); });
+		if(m_closed.load(std::memory_order_acquire))
+			return false;
+		m_TryPush(std::move(item));
+		m_notEmpty.Notify();
+		return true;
+	}
+
+	// Called by the consumer
+	bool TryPop(T& out)
+	{
+		size_t head = m_head.index.load(std::memory_order_relaxed);
+		if(head == m_head.cached)
+		{
+			m_head.cached = m_tail.index.load(std::memory_order_acquire);
+			if(head == m_head.cached)
+				return false;
+		}
+		T* item = m_Item(head);
+		out = std::move(*item);
+		item->~T();
+		m_head.index.store(head + 1, std::memory_order_release);
+		return true;
+	}
+	// Waits until there is an item in the queue, returns false if the queue is closed and empty
+	bool Pop(T& out)
+	{
+		m_notEmpty.Wait([&]() { return !m_Empty() || m_closed.load(std::memory_order_acquire); });
+		if(!TryPop(out))
+			return false;
+		m_notFull.Notify();
+		return true;
+	}
+
+	// Wakes up the threads waiting in Push and Pop, Push fails after this and Pop fails once the queue is empty
+	void Close()
+	{
+		m_closed.store(true, std::memory_order_release);
+		m_notFull.Notify();
+		m_notEmpty.Notify();
+	}
+	bool IsClosed() const
+	{
+		return m_closed.load(std::memory_order_acquire);
+	}
+
+	// Number of items in the queue, only exact when called from the producer or consumer while the other thread is idle
+	size_t GetSize() const
+	{
+		return m_tail.index.load(std::memory_order_acquire) - m_head.index.load(std::memory_order_acquire);
+	}
+	size_t GetCapacity() const
+	{
+		return m_mask + 1;
+	}
+
+private:
+	typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+
+	// Position in the queue written by one thread, on its own cache line
+	struct Index
+	{
+		std::atomic<size_t> index = { 0 };
+		// Last seen index of the other thread, only used by the thread that writes this index
+		size_t cached = 0;
+		uint8 padding[CacheLineSize - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+	};
+
+	template<typename U>
+	bool m_TryPush(U&& item)
+	{
+		size_t tail = m_tail.index.load(std::memory_order_relaxed);
+		if(tail - m_tail.cached > m_mask)
+		{
+			m_tail.cached = m_head.index.load(std::memory_order_acquire);
+			if(tail - m_tail.cached > m_mask)
+				return false;
+		}
+		new(m_Item(tail)) T(std::forward<U>(item));
+		m_tail.index.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+	T* m_Item(size_t index)
+	{
+		return (T*)&m_items[index & m_mask];
+	}
+	bool m_Full() const
+	{
+		return m_tail.index.load(std::memory_order_relaxed) - m_head.index.load(std::memory_order_acquire) > m_mask;
+	}
+	bool m_Empty() const
+	{
+		return m_head.index.load(std::memory_order_relaxed) == m_tail.index.load(std::memory_order_acquire);
+	}
+
+	uint8 m_padding[CacheLineSize];
+	Storage* m_items;
+	size_t m_mask;
+	// Read position, written by the consumer
+	Index m_head;
+	// Write position, written by the producer
+	Index m_tail;
+	std::atomic<bool> m_closed = { false };
+	QueueWaiter m_notEmpty;
+	QueueWaiter m_notFull;
+};
+
+/*
+	Bounded lock free queue with any number of producer threads and a single consumer thread
+	the capacity is rounded up to a power of two
+	every slot has a sequence number that tells if it can be written or read, producers claim slots by incrementing the write position
+	TryPush and TryPop return false instead of waiting when the queue is full or empty
+	Push and Pop wait for space or items and wake up the other threads when they are waiting, so a thread that waits in Pop is only woken up by Push
+*/
+template<typename T>
+class MPSCQueue : Unique
+{
+public:
+	MPSCQueue(size_t capacity)
+	{
+		size_t size = 2;
+		while(size < capacity)
+			size *= 2;
+		m_slots = new Slot[size];
+		for(size_t i = 0; i < size; i++)
+			m_slots[i].sequence.store(i, std::memory_order_relaxed);
+		m_mask = size - 1;
+	}
+	~MPSCQueue()
+	{
+		for(; !m_Empty(); m_head++)
+			((T*)&m_slots[m_head & m_mask].item)->~T();
+		delete[] m_slots;
+	}
+
+	// Called by the producers
+	bool TryPush(const T& item)
+	{
+		return m_TryPush(item);
+	}
+	bool TryPush(T&& item)
+	{
+		return m_TryPush(std::move(item));
+	}
+	// Waits until there is space in the queue, returns false if the queue is closed
+	bool Push(T item)
+	{
+		while(true)
+		{
+			if(m_closed.load(std::memory_order_acquire))
+				return false;
+			if(m_TryPush(std::move(item)))
+				break;
+			m_notFull.Wait([&]() { return m_closed.load(std::memory_order_acquire) || !m_Full(); });
+		}
+		m_notEmpty.Notify();
+		return true;
+	}
+
+	// Called by the consumer
+	bool TryPop(T& out)
+	{
+		Slot& slot = m_slots[m_head & m_mask];
+		if(slot.sequence.load(std::memory_order_acquire) != m_head + 1)
+			return false;
+		T* item = (T*)&slot.item;
+		out = std::move(*item);
+		item->~T();
+		// The slot can be written again when the write position has gone around the queue once
+		slot.sequence.store(m_head + m_mask + 1, std::memory_order_release);
+		m_head++;
+		return true;
+	}
+	// Waits until there is an item in the queue, returns false if the queue is closed and empty
+	bool Pop(T& out)
+	{
+		m_notEmpty.Wait([&]() { return !m_Empty() || m_closed.load(std::memory_order_acquire); });
+		if(!TryPop(out))
+			return false;
+		m_notFull.Notify();
+		return true;
+	}
+
+	// Wakes up the threads waiting in Push and Pop, Push fails after this and Pop fails once the queue is empty
+	void Close()
+	{
+		m_closed.store(true, std::memory_order_release);
+		m_notFull.Notify();
+		m_notEmpty.Notify();
+	}
+	bool IsClosed() const
+	{
+		return m_closed.load(std::memory_order_acquire);
+	}
+
+	size_t GetCapacity() const
+	{
+		return m_mask + 1;
+	}
+
+private:
+	typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+
+	struct Slot
+	{
+		// Equal to the write position when the slot can be written, the write position + 1 when it can be read
+		std::atomic<size_t> sequence;
+		Storage item;
+	};
+
+	template<typename U>
+	bool m_TryPush(U&& item)
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		while(true)
+		{
+			Slot& slot = m_slots[tail & m_mask];
+			size_t sequence = slot.sequence.load(std::memory_order_acquire);
+			intptr_t difference = (intptr_t)sequence - (intptr_t)tail;
+			if(difference == 0)
+			{
+				// The slot is free, claim it by moving the write position past it
+				if(m_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+				{
+					new(&slot.item) T(std::forward<U>(item));
+					slot.sequence.store(tail + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if(difference < 0)
+			{
+				// The slot still contains an item from the previous time around the queue
+				return false;
+			}
+			else
+			{
+				// Another producer claimed the slot
+				tail = m_tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+	bool m_Full() const
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		return (intptr_t)m_slots[tail & m_mask].sequence.load(std::memory_order_acquire) - (intptr_t)tail < 0;
+	}
+	bool m_Empty() const
+	{
+		return m_slots[m_head & m_mask].sequence.load(std::memory_order_acquire) != m_head + 1;
+	}
+
+	uint8 m_padding0[CacheLineSize];
+	Slot* m_slots;
+	size_t m_mask;
+	uint8 m_padding1[CacheLineSize];
+	// Write position, shared by the producers
+	std::atomic<size_t> m_tail = { 0 };
+	uint8 m_padding2[CacheLineSize];
+	// Read position, only used by the consumer
+	size_t m_head = 0;
+	uint8 m_padding3[CacheLineSize];
+	std::atomic<bool> m_closed = { false };
+	QueueWaiter m_notEmpty;
+	QueueWaiter m_notFull;
+};
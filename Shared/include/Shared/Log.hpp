@@ -6,6 +6,7 @@
 	Logging utility class
 	formats loggin messages with time stamps and module names
 	allows message coloring on platforms that support it
+	can be used from multiple threads
 */
 class Logger : Unique
 {
@@ -45,6 +46,7 @@ public:
 	void Write(const String& msg);
 
 private:
+	void m_SetColor(Color color);
 	class Logger_Impl* m_impl;
 };
 
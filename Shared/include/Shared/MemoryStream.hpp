@@ -3,11 +3,12 @@
 #include "Shared/Unique.hpp"
 #include "Shared/Buffer.hpp"
 
+/*
+	Base class for streams on a buffer in memory
+	reads and writes are done inline by BinaryStream::SerializeBytes, without virtual calls
+*/
 class MemoryStreamBase : public BinaryStream
 {
-protected:
-	Buffer* m_buffer = nullptr;
-	size_t m_cursor = 0; // Write position
 public:
 	MemoryStreamBase() = default;
 	MemoryStreamBase(Buffer& buffer, bool isReading);
@@ -0,0 +1,33 @@
+#pragma once
+#include "Shared/BinaryStream.hpp"
+#include "Shared/Unique.hpp"
+
+/*
+	Stream that reads from a file that is mapped into memory
+	the whole file is also available with GetData, this stays valid until the reader is closed
+	the file should not be truncated by other programs while it is mapped
+*/
+class MmapFileReader : public BinaryStream, Unique
+{
+public:
+	MmapFileReader();
+	~MmapFileReader();
+
+	bool Open(const String& path);
+	void Close();
+	bool IsOpen() const;
+
+	// Contents of the file, null for empty files
+	const uint8* GetData() const;
+
+	virtual size_t Serialize(void* data, size_t len);
+	virtual void Seek(size_t pos);
+	virtual size_t Tell() const;
+	virtual size_t GetSize() const;
+
+private:
+	class MmapFileReader_Impl* m_impl = nullptr;
+	const uint8* m_data = nullptr;
+	size_t m_size = 0;
+	size_t m_position = 0;
+};
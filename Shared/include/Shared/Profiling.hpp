@@ -1,4 +1,9 @@
 #pragma once
+#include "Shared/String.hpp"
+#include "Shared/Vector.hpp"
+#include "Shared/Timer.hpp"
+#include "Shared/Log.hpp"
+#include <atomic>
 
 class ProfilerScope
 {
@@ -14,4 +19,82 @@ public:
 private:
 	Timer t;
 	String name;
-};
\ No newline at end of file
+};
+
+/*
+	Instrumenting profiler that records the start and end of named zones on every thread
+	the events are stored in a ring buffer per thread, so recording never locks and only the most recent events are kept
+	zones are only recorded while the profiler is enabled
+
+	Use the ProfileZone macro to record the scope it is placed in, zone and thread names should be string literals
+*/
+namespace Profiler
+{
+	// Time spent in a zone during a frame, zones with the same name and depth are combined
+	struct ZoneStats
+	{
+		const char* name;
+		// Number of zones this one is nested in
+		uint32 depth;
+		uint32 count;
+		// In milliseconds
+		double time;
+	};
+	struct ThreadStats
+	{
+		const char* name;
+		Vector<ZoneStats> zones;
+	};
+	struct FrameStats
+	{
+		// In milliseconds
+		double duration = 0.0;
+		Vector<ThreadStats> threads;
+	};
+
+	void SetEnabled(bool enabled);
+	bool IsEnabled();
+	// Names the calling thread in the frame statistics and traces
+	void SetThreadName(const char* name);
+
+	// Marks the start of a new frame, called from the main loop
+	void BeginFrame();
+	// Zones that were recorded on all threads during the last completed frame
+	FrameStats GetLastFrame();
+
+	// Writes the recorded events as chrome trace events, can be opened with chrome://tracing or other trace viewers
+	bool ExportChromeTrace(const String& path);
+
+	void BeginZone(const char* name);
+	void EndZone();
+}
+
+namespace ProfilerInternal
+{
+	extern std::atomic<bool> enabled;
+}
+
+// Records a zone from construction until destruction
+class ProfilerZone
+{
+public:
+	ProfilerZone(const char* name)
+	{
+		m_active = ProfilerInternal::enabled.load(std::memory_order_relaxed);
+		if(m_active)
+			Profiler::BeginZone(name);
+	}
+	~ProfilerZone()
+	{
+		if(m_active)
+			Profiler::EndZone();
+	}
+
+private:
+	bool m_active;
+};
+
+#define PROFILER_CONCAT_INNER(__a, __b) __a##__b
+#define PROFILER_CONCAT(__a, __b) PROFILER_CONCAT_INNER(__a, __b)
+// Records the current scope as a zone with the given name
+#define ProfileZone(__name) ProfilerZone PROFILER_CONCAT(__profilerZone, __LINE__)(__name)
@@ -1,71 +1,159 @@
 #pragma once
 #include <assert.h>
 #include <type_traits>
+#include <atomic>
+#include <utility>
+#include <new>
 
 template<typename T> class RefCounted;
+template<typename T> class WeakRef;
+
+/*
+	Reference counter shared by all Refs and WeakRefs to an object
+	the counts are atomic so references can be copied and released from multiple threads
+*/
+class RefCounterBase
+{
+public:
+	RefCounterBase() : m_strong(0), m_weak(1), m_alive(true) {}
+	virtual ~RefCounterBase() = default;
+
+	void AddRef()
+	{
+		m_strong.fetch_add(1, std::memory_order_relaxed);
+	}
+	void ReleaseRef()
+	{
+		if(m_strong.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			DestroyObject();
+			// The weak count held by the strong references
+			ReleaseWeak();
+		}
+	}
+	// Adds a reference if the object still has references and is not destroyed, used to lock weak references
+	bool TryAddRef()
+	{
+		int32 strong = m_strong.load(std::memory_order_relaxed);
+		while(strong > 0)
+		{
+			if(m_strong.compare_exchange_weak(strong, strong + 1, std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				if(IsAlive())
+					return true;
+				ReleaseRef();
+				return false;
+			}
+		}
+		return false;
+	}
+
+	void AddWeak()
+	{
+		m_weak.fetch_add(1, std::memory_order_relaxed);
+	}
+	void ReleaseWeak()
+	{
+		if(m_weak.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			m_Free();
+	}
+
+	// Destroys the object while there may still be references to it, these references become invalid
+	//	returns false if the object was already destroyed
+	bool DestroyObject()
+	{
+		if(!m_alive.exchange(false, std::memory_order_acq_rel))
+			return false;
+		m_DestroyObject();
+		return true;
+	}
+
+	bool IsAlive() const { return m_alive.load(std::memory_order_acquire); }
+	int32 GetRefCount() const { return IsAlive() ? m_strong.load(std::memory_order_relaxed) : 0; }
+	int32 GetWeakCount() const { return m_weak.load(std::memory_order_relaxed) - (m_strong.load(std::memory_order_relaxed) > 0 ? 1 : 0); }
+
+protected:
+	// Calls the destructor of the managed object
+	virtual void m_DestroyObject() = 0;
+	// Frees this counter, after the object is destroyed and there are no more references
+	virtual void m_Free() { delete this; }
+
+private:
+	// Number of Refs
+	std::atomic<int32> m_strong;
+	// Number of WeakRefs, plus one for all the Refs together
+	std::atomic<int32> m_weak;
+	std::atomic<bool> m_alive;
+};
+
+// Counter for an object that was allocated seperately with new
+template<typename T>
+class RefPointerCounter : public RefCounterBase
+{
+public:
+	RefPointerCounter(T* object) : m_object(object) {}
+
+protected:
+	virtual void m_DestroyObject() override
+	{
+		delete m_object;
+	}
+
+private:
+	T* m_object;
+};
+
+// Counter with the object stored directly after it, so both only need a single allocation
+template<typename T>
+class RefObjectCounter : public RefCounterBase
+{
+public:
+	template<typename... Args>
+	RefObjectCounter(Args&&... args)
+	{
+		new(m_storage) T(std::forward<Args>(args)...);
+	}
+	T* GetObject() { return (T*)m_storage; }
+
+protected:
+	virtual void m_DestroyObject() override
+	{
+		GetObject()->~T();
+	}
+
+private:
+	alignas(T) unsigned char m_storage[sizeof(T)];
+};
 
 /*
 	Basic shared pointer class
 	the object should be constructed once explicitly with a pointer to the object to manage
+	or created with Utility::NewRef, which allocates the object and the reference counter together
 	When there are no more references to this object, the underlying object gets deleted
+
+	copying and releasing references is thread safe, the object itself is not
 */
 template<typename T>
 class Ref
 {
 protected:
 	T* m_data;
-	int32_t* m_refCount;
+	RefCounterBase* m_refCount;
 	void m_Dec()
 	{
 		if(m_refCount)
-		{
-			assert(m_refCount[0] != 0);
-			if(m_refCount[0] >= 0)
-			{
-				m_refCount[0]--;
-				if(m_refCount[0] == 0)
-				{
-					delete m_data;
-					delete m_refCount;
-					m_refCount = nullptr;
-#if _DEBUG
-					m_data = nullptr;
-#endif
-				}
-			}
-			else
-			{
-				m_refCount[0]++;
-				if(m_refCount[0] == 0)
-				{
-					delete m_refCount;
-					m_refCount = nullptr;
-#if _DEBUG
-					m_data = nullptr;
-#endif
-				}
-			}
-		}
+			m_refCount->ReleaseRef();
 	}
 	void m_Inc()
 	{
 		if(m_refCount)
-		{
-			if(m_refCount[0] >= 0)
-			{
-				m_refCount[0]++;
-			}
-			else
-			{
-				m_refCount[0]--;
-			}
-		}
+			m_refCount->AddRef();
 	}
 	void m_AssignCounter();
-	int32* m_CreateNewCounter();
+	RefCounterBase* m_CreateNewCounter();
 
 public:
-	explicit Ref(T* data, int32_t* refCount)
+	explicit Ref(T* data, RefCounterBase* refCount)
 		: m_data(data), m_refCount(refCount)
 	{
 		m_Inc();
@@ -76,7 +164,7 @@ public:
 	{
 		m_data = obj;
 		m_refCount = m_CreateNewCounter();
-		m_refCount[0]++;
+		m_refCount->AddRef();
 		m_AssignCounter();
 	}
 	inline ~Ref()
@@ -97,14 +185,19 @@ public:
 	}
 	inline Ref& operator=(const Ref& other)
 	{
-		m_Dec();
+		// Increment first, in case this is assigned to itself
+		RefCounterBase* oldRefCount = m_refCount;
 		m_data = other.m_data;
 		m_refCount = other.m_refCount;
 		m_Inc();
+		if(oldRefCount)
+			oldRefCount->ReleaseRef();
 		return *this;
 	}
 	inline Ref& operator=(Ref&& other)
 	{
+		if(this == &other)
+			return *this;
 		m_Dec();
 		m_data = other.m_data;
 		m_refCount = other.m_refCount;
@@ -161,13 +254,15 @@ public:
 		return m_refCount && m_data != other;
 	}
 
+	// Deletes the object, other references to it become invalid
+	//	does nothing for an empty reference
 	inline void Destroy()
 	{
+		if(!m_refCount)
+			return;
 		assert(IsValid());
-		assert(m_refCount[0] > 0);
-		m_refCount[0] = -m_refCount[0] + 1;
-		m_refCount = nullptr;
-		delete m_data;
+		m_refCount->DestroyObject();
+		Release();
 	}
 	inline void Release()
 	{
@@ -175,55 +270,128 @@ public:
 		m_refCount = nullptr;
 	}
 
-	inline bool IsValid() const { return m_refCount != nullptr && m_refCount[0] > 0; }
+	inline bool IsValid() const { return m_refCount != nullptr && m_refCount->IsAlive(); }
 	inline operator bool() const { return IsValid(); }
 
-	inline int32_t GetRefCount() const { if(m_refCount && m_refCount[0] > 0) return m_refCount[0]; else return 0; }
+	inline int32_t GetRefCount() const { return m_refCount ? m_refCount->GetRefCount() : 0; }
 
 	inline T* GetData() { assert(IsValid()); return m_data; }
 	inline const T* GetData() const { assert(IsValid()); return m_data; }
+
+	friend class WeakRef<T>;
 };
 
-namespace Utility
+/*
+	Reference to an object managed by Ref that does not keep the object alive
+	Lock returns a Ref to the object, or an invalid Ref if the object was deleted
+*/
+template<typename T>
+class WeakRef
 {
-	template<typename T>
-	Ref<T> MakeRef(T* obj)
+public:
+	inline WeakRef() : m_data(nullptr), m_refCount(nullptr) {}
+	inline WeakRef(const Ref<T>& ref) : m_data(ref.m_data), m_refCount(ref.m_refCount)
 	{
-		return Ref<T>(obj);
+		m_Inc();
+	}
+	inline ~WeakRef()
+	{
+		m_Dec();
+	}
+	inline WeakRef(const WeakRef& other) : m_data(other.m_data), m_refCount(other.m_refCount)
+	{
+		m_Inc();
+	}
+	inline WeakRef(WeakRef&& other) : m_data(other.m_data), m_refCount(other.m_refCount)
+	{
+		other.m_refCount = nullptr;
+	}
+	inline WeakRef& operator=(const WeakRef& other)
+	{
+		RefCounterBase* oldRefCount = m_refCount;
+		m_data = other.m_data;
+		m_refCount = other.m_refCount;
+		m_Inc();
+		if(oldRefCount)
+			oldRefCount->ReleaseWeak();
+		return *this;
+	}
+	inline WeakRef& operator=(WeakRef&& other)
+	{
+		if(this == &other)
+			return *this;
+		m_Dec();
+		m_data = other.m_data;
+		m_refCount = other.m_refCount;
+		other.m_refCount = nullptr;
+		return *this;
+	}
+
+	// Returns a reference to the object if it still exists
+	inline Ref<T> Lock() const
+	{
+		if(!m_refCount || !m_refCount->TryAddRef())
+			return Ref<T>();
+		Ref<T> ret;
+		ret.m_data = m_data;
+		ret.m_refCount = m_refCount;
+		return ret;
+	}
+	inline bool IsExpired() const { return !m_refCount || m_refCount->GetRefCount() == 0; }
+	inline void Release()
+	{
+		m_Dec();
+		m_refCount = nullptr;
+	}
+
+private:
+	void m_Inc()
+	{
+		if(m_refCount)
+			m_refCount->AddWeak();
+	}
+	void m_Dec()
+	{
+		if(m_refCount)
+			m_refCount->ReleaseWeak();
 	}
-}
+
+	T* m_data;
+	RefCounterBase* m_refCount;
+};
 
 /*
 	Base class for objects that allows them to create a shared pointer from themselves
-	WARNING: Only use on objects allocated with "new"
+	WARNING: Only use on objects allocated with "new" or Utility::NewRef
 	Repeatedly calling MakeShared will return the same shared pointer
 */
 class IRefCounted
 {
 protected:
-	int32* m_refCount = (int32*)0;
+	RefCounterBase* m_refCount = nullptr;
 public:
 #if _DEBUG
 	~IRefCounted()
 	{
-		// Should never happen, object will always 
-		assert(!m_refCount || m_refCount[0] <= 0);
+		// Should never happen, object will always
+		assert(!m_refCount || !m_refCount->IsAlive());
 	}
 #endif
 	int32 GetRefCount() const
 	{
-		return (m_refCount) ? m_refCount[0] : 0;
+		return (m_refCount) ? m_refCount->GetRefCount() : 0;
 	}
 	// Internal use, assigns the reference counter when constructing a Ref object without calling RefCounted::MakeShared
-	void _AssignRefCounter(int32* counter)
+	void _AssignRefCounter(RefCounterBase* counter)
 	{
 		assert(m_refCount == nullptr || m_refCount == counter);
 		m_refCount = counter;
 	}
-	int32* _GetRefCounter()
+	template<typename T>
+	RefCounterBase* _GetRefCounter(T* obj)
 	{
 		if(!m_refCount)
-			m_refCount = new int32(0);
+			m_refCount = new RefPointerCounter<T>(obj);
 		return m_refCount;
 	}
 };
@@ -235,7 +403,7 @@ public:
 	// Can be used for objects allocated with new to get a reference counted handle to this object
 	Ref<T> MakeShared()
 	{
-		return Ref<T>((T*)this, _GetRefCounter());
+		return Ref<T>((T*)this, _GetRefCounter((T*)this));
 	}
 };
 
@@ -243,23 +411,23 @@ public:
 // Possibly assign reference counter in RefCounted object
 template<typename T, bool> struct RefCounterHelper
 {
-	static void Assign(T* obj, int32* counter)
+	static void Assign(T* obj, RefCounterBase* counter)
 	{
 	}
-	static int32* CreateCounter(T* obj)
+	static RefCounterBase* CreateCounter(T* obj)
 	{
-		return new int32(0);
+		return new RefPointerCounter<T>(obj);
 	}
 };
 template<typename T> struct RefCounterHelper<T, true>
 {
-	static void Assign(T* obj, int32* counter)
+	static void Assign(T* obj, RefCounterBase* counter)
 	{
 		obj->_AssignRefCounter(counter);
 	}
-	static int32* CreateCounter(T* obj)
+	static RefCounterBase* CreateCounter(T* obj)
 	{
-		return obj->_GetRefCounter();
+		return obj->_GetRefCounter(obj);
 	}
 };
 template<typename T> void Ref<T>::m_AssignCounter()
@@ -267,8 +435,26 @@ template<typename T> void Ref<T>::m_AssignCounter()
 	assert(m_data);
 	RefCounterHelper<T, std::is_base_of<IRefCounted, T>::value>::Assign((T*)m_data, m_refCount);
 }
-template<typename T> int32* Ref<T>::m_CreateNewCounter()
+template<typename T> RefCounterBase* Ref<T>::m_CreateNewCounter()
 {
 	assert(m_data);
 	return RefCounterHelper<T, std::is_base_of<IRefCounted, T>::value>::CreateCounter((T*)m_data);
-}
\ No newline at end of file
+}
+
+namespace Utility
+{
+	template<typename T>
+	Ref<T> MakeRef(T* obj)
+	{
+		return Ref<T>(obj);
+	}
+	// Creates a new object that is allocated together with its reference counter
+	template<typename T, typename... Args>
+	Ref<T> NewRef(Args&&... args)
+	{
+		RefObjectCounter<T>* counter = new RefObjectCounter<T>(std::forward<Args>(args)...);
+		T* obj = counter->GetObject();
+		RefCounterHelper<T, std::is_base_of<IRefCounted, T>::value>::Assign(obj, counter);
+		return Ref<T>(obj, counter);
+	}
+}
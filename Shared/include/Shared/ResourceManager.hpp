@@ -10,23 +10,36 @@
 class IResourceManager
 {
 public:
-	// Collects unused object
-	virtual void GarbageCollect() = 0;
+	// Checks at most maxObjects objects for ones that are no longer used, continuing where the previous call stopped
+	//	unused objects are queued for release, they are destroyed by ReleaseUnused
+	//	returns true once all objects have been checked since the scan started at the first object
+	virtual bool GarbageCollect(size_t maxObjects) = 0;
+	// Releases the objects queued by GarbageCollect, should be called when it is safe to destroy them
+	virtual void ReleaseUnused() = 0;
 	// Forcefully releases all objects from this resource manager
 	virtual void ReleaseAll() = 0;
+	// Number of objects that are managed, including ones queued for release
+	virtual size_t GetNumLive() const = 0;
+	// Total number of objects that were released
+	virtual size_t GetNumFreed() const = 0;
 	virtual ~IResourceManager() = default;
 };
 
 /*
 	Templated resource managed that keeps Ref<> objects
-	the GarbageCollect function checks these and cleans up unused ones
+	the GarbageCollect function checks these incrementally and queues unused ones to be released later
 */
 template<typename T>
 class ResourceManager : public IResourceManager, Unique
 {
 	// List of managed object
 	Vector<Ref<T>> m_objects;
-	Mutex m_lock;
+	// Unused objects that are waiting to be released
+	Vector<Ref<T>> m_unused;
+	// Index of the next object to check
+	size_t m_scanPosition = 0;
+	size_t m_numFreed = 0;
+	mutable Mutex m_lock;
 public:
 	ResourceManager()
 	{
@@ -44,40 +57,82 @@ public:
 		m_lock.unlock();
 		return ret;
 	}
-	virtual void GarbageCollect() override
+	virtual bool GarbageCollect(size_t maxObjects) override
+	{
+		std::lock_guard<Mutex> lock(m_lock);
+		size_t end = m_scanPosition + maxObjects;
+		while(m_scanPosition < m_objects.size() && m_scanPosition < end)
+		{
+			if(m_objects[m_scanPosition].GetRefCount() <= 1)
+			{
+				// Swap with the last object, the swapped in object is checked next
+				m_unused.push_back(std::move(m_objects[m_scanPosition]));
+				m_objects[m_scanPosition] = std::move(m_objects.back());
+				m_objects.pop_back();
+				end--;
+				continue;
+			}
+			m_scanPosition++;
+		}
+		if(m_scanPosition < m_objects.size())
+			return false;
+		m_scanPosition = 0;
+		return true;
+	}
+	virtual void ReleaseUnused() override
 	{
-		size_t numCleanedUp = 0;
 		m_lock.lock();
-		for(auto it = m_objects.begin(); it != m_objects.end();)
+		Vector<Ref<T>> unused = std::move(m_unused);
+		m_unused.clear();
+
+		// Objects can be referenced again through weak references after they were queued
+		size_t numFreed = 0;
+		for(auto it = unused.begin(); it != unused.end();)
 		{
-			if(it->GetRefCount() <= 1)
+			if(it->GetRefCount() > 1)
 			{
-				numCleanedUp++;
-				it = m_objects.erase(it);
+				m_objects.push_back(std::move(*it));
+				it = unused.erase(it);
 				continue;
 			}
+			numFreed++;
 			it++;
 		}
+		m_numFreed += numFreed;
 		m_lock.unlock();
-		if(numCleanedUp > 0)
-		{
-			//Logf("Cleaned up %d resource(s) of %s", Logger::Info, numCleanedUp, Utility::TypeInfo<T>::name);
-		}
+
+		// Destroyed outside of the lock, so objects can be registered while this is running
+		unused.clear();
 	}
-	virtual void ReleaseAll()
+	virtual void ReleaseAll() override
 	{
 		m_lock.lock();
-		size_t numCleanedUp = m_objects.size();
-		for(auto it = m_objects.begin(); it != m_objects.end(); it++)
+		size_t numCleanedUp = m_objects.size() + m_unused.size();
+		for(auto& list : { &m_objects, &m_unused })
 		{
-			if(*it)
-				it->Destroy();
+			for(auto it = list->begin(); it != list->end(); it++)
+			{
+				if(*it)
+					it->Destroy();
+			}
+			list->clear();
 		}
-		m_objects.clear();
+		m_scanPosition = 0;
+		m_numFreed += numCleanedUp;
 		m_lock.unlock();
 		if(numCleanedUp > 0)
 		{
-			Logf("Cleaned up %d resource(s) of %s", Logger::Info, numCleanedUp, Utility::TypeInfo<T>::name);
+			Logf("Cleaned up %d resource(s) of %s", Logger::Info, (int32)numCleanedUp, Utility::TypeInfo<T>::name);
 		}
 	}
-};
\ No newline at end of file
+	virtual size_t GetNumLive() const override
+	{
+		std::lock_guard<Mutex> lock(m_lock);
+		return m_objects.size() + m_unused.size();
+	}
+	virtual size_t GetNumFreed() const override
+	{
+		std::lock_guard<Mutex> lock(m_lock);
+		return m_numFreed;
+	}
+};
@@ -20,6 +20,8 @@
 #include "Vector.hpp"
 #include "Map.hpp"
 #include "Set.hpp"
+#include "FlatHashMap.hpp"
+#include "FlatHashSet.hpp"
 #include "List.hpp"
 
 // Debugging and logging
@@ -63,10 +63,11 @@ namespace Utility
 
 	// Helper function that perorms the c standard sprintf but returns a managed object instead
 	// Max Output length = 8000
+	// the buffer is per thread, so this can be called from multiple threads
 	template<typename... Args>
 	String Sprintf(const char* fmt, Args... args)
 	{
-		static char buffer[8000];
+		static thread_local char buffer[8000];
 #ifdef _WIN32
 		sprintf_s(buffer, fmt, SprintfArgFilter(args)...);
 #else
@@ -80,7 +81,7 @@ namespace Utility
 	template<typename... Args>
 	WString WSprintf(const wchar_t* fmt, Args... args)
 	{
-		static wchar_t buffer[8000];
+		static thread_local wchar_t buffer[8000];
 #ifdef _WIN32
 		swprintf(buffer, 8000-1, fmt, WSprintfArgFilter(args)...);
 #else
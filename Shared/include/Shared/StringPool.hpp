@@ -0,0 +1,47 @@
+#pragma once
+#include "Shared/String.hpp"
+#include "Shared/Vector.hpp"
+#include "Shared/Unique.hpp"
+#include "Shared/Thread.hpp"
+
+/*
+	Stores strings in large blocks of memory, equal strings are only stored once
+	the returned strings stay valid until the pool is destroyed, so strings added once can be compared by their address
+	strings can be added from multiple threads
+*/
+class StringPool : public Unique
+{
+public:
+	StringPool() = default;
+	~StringPool();
+
+	// Adds a string to the pool if it is not in it yet and returns the pooled string
+	const char* Add(const char* str, size_t length);
+	const char* Add(const String& str);
+
+	// Number of unique strings in the pool
+	size_t GetNumStrings() const;
+	// Number of bytes allocated by the pool
+	size_t GetMemoryUsage() const;
+
+private:
+	struct Entry
+	{
+		const char* str;
+		uint32 hash;
+		uint32 length;
+	};
+
+	char* m_Allocate(size_t length);
+	void m_GrowTable();
+
+	// Blocks the strings are stored in
+	Vector<char*> m_blocks;
+	// Space left in the last block
+	size_t m_blockSpace = 0;
+	size_t m_blockMemory = 0;
+	// Hash table of the stored strings, using linear probing
+	Vector<Entry> m_table;
+	size_t m_numStrings = 0;
+	mutable Mutex m_lock;
+};
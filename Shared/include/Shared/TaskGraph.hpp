@@ -0,0 +1,124 @@
+#pragma once
+#include "Shared/Jobs.hpp"
+#include "Shared/Vector.hpp"
+#include "Shared/Thread.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <initializer_list>
+
+/*
+	Flag that is set to stop a group of tasks early
+	long running tasks should check it regularly and return once it is set
+*/
+class CancellationToken : public Unique
+{
+public:
+	CancellationToken() : m_cancelled(false) {}
+
+	void Cancel() { m_cancelled = true; }
+	bool IsCancelled() const { return m_cancelled; }
+
+private:
+	std::atomic<bool> m_cancelled;
+};
+
+/*
+	A set of tasks that run on the job threads once the tasks they depend on are finished
+	tasks can also run on the main thread, for work that requires it, such as creating graphics resources
+
+	a task returns false to signal failure, this cancels the graph and the tasks that didn't start yet are skipped
+	the graph should be kept alive until all tasks are finished, destroying it cancels it and waits for running tasks
+*/
+class TaskGraph : public Unique
+{
+public:
+	typedef uint32 Task;
+
+	TaskGraph(JobSheduler& sheduler);
+	~TaskGraph();
+
+	// Adds a task that runs on a job thread after all its dependencies finished
+	//	the task is a function returning a bool for success
+	template<typename Lambda>
+	Task Add(Lambda&& func, std::initializer_list<Task> dependencies = {}, JobPriority priority = JobPriority::Normal)
+	{
+		return m_Add(JobBase::CreateLambda(typename std::decay<Lambda>::type(std::forward<Lambda>(func))), dependencies, priority, false);
+	}
+	// Adds a task that runs on the main thread, from Update or Wait, after all its dependencies finished
+	template<typename Lambda>
+	Task AddOnMainThread(Lambda&& func, std::initializer_list<Task> dependencies = {})
+	{
+		return m_Add(JobBase::CreateLambda(typename std::decay<Lambda>::type(std::forward<Lambda>(func))), dependencies, JobPriority::Normal, true);
+	}
+
+	// Queues the tasks without dependencies, tasks can't be added after this
+	void Start();
+	// Runs the main thread tasks that are ready
+	//	returns true once all tasks are finished
+	bool Update();
+	// Waits for all tasks to finish, running main thread tasks on the calling thread
+	//	returns true if all tasks were successful
+	bool Wait();
+
+	// Stops tasks that didn't start yet from running
+	void Cancel();
+	const CancellationToken& GetCancellationToken() const { return m_cancellation; }
+
+	bool IsFinished() const;
+	// True if all tasks finished and none failed or were cancelled
+	bool IsSuccessfull() const;
+
+private:
+	struct TaskState
+	{
+		// The function to run, this job is not queued itself
+		Job function;
+		// Tasks waiting for this one
+		Vector<Task> dependents;
+		// Number of dependencies that are not finished yet
+		std::atomic<uint32> numWaiting;
+		JobPriority priority;
+		bool mainThread;
+	};
+
+	Task m_Add(Job function, std::initializer_list<Task> dependencies, JobPriority priority, bool mainThread);
+	void m_Ready(Task task);
+	void m_RunTask(Task task);
+	bool m_RunMainThreadTasks();
+
+	JobSheduler& m_sheduler;
+	Vector<TaskState*> m_tasks;
+	CancellationToken m_cancellation;
+	bool m_started = false;
+
+	// Main thread tasks that are ready to run
+	Vector<Task> m_mainThreadTasks;
+	// Number of tasks that did not finish yet
+	uint32 m_numRemaining = 0;
+	// Protects the above and is used to wait for tasks
+	mutable Mutex m_lock;
+	std::condition_variable_any m_taskFinished;
+
+	friend class TaskJob;
+};
+
+namespace ParallelForInternal
+{
+	typedef void(*RangeFunction)(void* context, size_t begin, size_t end);
+	void Run(JobSheduler& sheduler, size_t begin, size_t end, size_t grainSize, RangeFunction func, void* context, const CancellationToken* cancellation);
+}
+
+/*
+	Calls func(rangeBegin, rangeEnd) for consecutive ranges of at most grainSize items between begin and end
+	the ranges are processed by the job threads and the calling thread, this returns once all ranges are processed
+	if a cancellation token is given, ranges that didn't start yet are skipped once it is cancelled
+*/
+template<typename Lambda>
+void ParallelFor(JobSheduler& sheduler, size_t begin, size_t end, size_t grainSize, Lambda&& func, const CancellationToken* cancellation = nullptr)
+{
+	auto callRange = [](void* context, size_t rangeBegin, size_t rangeEnd)
+	{
+		(*(typename std::remove_reference<Lambda>::type*)context)(rangeBegin, rangeEnd);
+	};
+	ParallelForInternal::Run(sheduler, begin, end, grainSize, callRange, (void*)&func, cancellation);
+}
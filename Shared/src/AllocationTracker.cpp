@@ -0,0 +1,163 @@
+#include "stdafx.h"
+#include "AllocationTracker.hpp"
+#include "Thread.hpp"
+#include <atomic>
+#include <new>
+
+static const size_t numTags = (size_t)AllocationTag::_Length;
+
+// Counters for a single tag, these are constant initialized so allocations during static initialization can be counted
+struct AllocationCounters
+{
+	std::atomic<uint64> numAllocations;
+	std::atomic<uint64> numFrees;
+	std::atomic<uint64> bytesAllocated;
+
+	AllocationTracker::Counts Load() const
+	{
+		AllocationTracker::Counts counts;
+		counts.numAllocations = numAllocations.load(std::memory_order_relaxed);
+		counts.numFrees = numFrees.load(std::memory_order_relaxed);
+		counts.bytesAllocated = bytesAllocated.load(std::memory_order_relaxed);
+		return counts;
+	}
+};
+
+static std::atomic<bool> enabled(false);
+static AllocationCounters counters[numTags];
+static thread_local AllocationTag currentTag = AllocationTag::General;
+
+// Counts at the start of the current frame and the counts of the last frame
+static Mutex frameLock;
+static AllocationTracker::Counts frameStart[numTags];
+static AllocationTracker::Counts lastFrame[numTags];
+
+static void CountAllocation(size_t size)
+{
+	if(!enabled.load(std::memory_order_relaxed))
+		return;
+	AllocationCounters& tagCounters = counters[(size_t)currentTag];
+	tagCounters.numAllocations.fetch_add(1, std::memory_order_relaxed);
+	tagCounters.bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+}
+static void CountFree(void* ptr)
+{
+	if(!ptr || !enabled.load(std::memory_order_relaxed))
+		return;
+	counters[(size_t)currentTag].numFrees.fetch_add(1, std::memory_order_relaxed);
+}
+
+AllocationTracker::Counts& AllocationTracker::Counts::operator+=(const Counts& other)
+{
+	numAllocations += other.numAllocations;
+	numFrees += other.numFrees;
+	bytesAllocated += other.bytesAllocated;
+	return *this;
+}
+
+void AllocationTracker::SetEnabled(bool enable)
+{
+	enabled = enable;
+}
+bool AllocationTracker::IsEnabled()
+{
+	return enabled;
+}
+const char* AllocationTracker::GetTagName(AllocationTag tag)
+{
+	static const char* names[] =
+	{
+		"General",
+		"Gameplay",
+		"Render",
+		"GUI",
+		"Audio",
+		"Loading",
+	};
+	static_assert(sizeof(names) / sizeof(names[0]) == numTags, "Missing allocation tag names");
+	return names[(size_t)tag];
+}
+AllocationTag AllocationTracker::SetCurrentTag(AllocationTag tag)
+{
+	AllocationTag previous = currentTag;
+	currentTag = tag;
+	return previous;
+}
+
+AllocationTracker::Counts AllocationTracker::GetCounts(AllocationTag tag)
+{
+	return counters[(size_t)tag].Load();
+}
+void AllocationTracker::BeginFrame()
+{
+	std::lock_guard<Mutex> lock(frameLock);
+	for(size_t i = 0; i < numTags; i++)
+	{
+		Counts current = counters[i].Load();
+		lastFrame[i].numAllocations = current.numAllocations - frameStart[i].numAllocations;
+		lastFrame[i].numFrees = current.numFrees - frameStart[i].numFrees;
+		lastFrame[i].bytesAllocated = current.bytesAllocated - frameStart[i].bytesAllocated;
+		frameStart[i] = current;
+	}
+}
+AllocationTracker::Counts AllocationTracker::GetLastFrame(AllocationTag tag)
+{
+	std::lock_guard<Mutex> lock(frameLock);
+	return lastFrame[(size_t)tag];
+}
+AllocationTracker::Counts AllocationTracker::GetLastFrameTotal()
+{
+	std::lock_guard<Mutex> lock(frameLock);
+	Counts total;
+	for(size_t i = 0; i < numTags; i++)
+		total += lastFrame[i];
+	return total;
+}
+
+// Replacements for the global new and delete operators
+void* operator new(size_t size)
+{
+	CountAllocation(size);
+	void* ptr = malloc(size > 0 ? size : 1);
+	if(!ptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	CountAllocation(size);
+	return malloc(size > 0 ? size : 1);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return operator new(size, std::nothrow);
+}
+void operator delete(void* ptr) noexcept
+{
+	CountFree(ptr);
+	free(ptr);
+}
+void operator delete[](void* ptr) noexcept
+{
+	operator delete(ptr);
+}
+void operator delete(void* ptr, size_t) noexcept
+{
+	operator delete(ptr);
+}
+void operator delete[](void* ptr, size_t) noexcept
+{
+	operator delete(ptr);
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+	operator delete(ptr);
+}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+	operator delete(ptr);
+}
@@ -0,0 +1,214 @@
+#include "stdafx.h"
+#include "AsyncFileReader.hpp"
+#include "AsyncFileReader_Impl.hpp"
+#include "File.hpp"
+#include "List.hpp"
+#include "Log.hpp"
+#include "Math.hpp"
+#include "Thread.hpp"
+#include "Profiling.hpp"
+#include <condition_variable>
+#include <atomic>
+
+/*
+	Backend that reads files with the blocking File functions on worker threads
+	used on platforms without io_uring
+*/
+class ThreadAsyncFileBackend : public AsyncFileBackend
+{
+public:
+	ThreadAsyncFileBackend(AsyncReadSink& sink, uint32 numThreads) : m_sink(sink)
+	{
+		for(uint32 i = 0; i < Math::Max(numThreads, 1u); i++)
+			m_threads.emplace_back(&ThreadAsyncFileBackend::m_ReadThread, this);
+	}
+	~ThreadAsyncFileBackend()
+	{
+		m_lock.lock();
+		m_terminate = true;
+		m_lock.unlock();
+		m_readsChanged.notify_all();
+		for(Thread& thread : m_threads)
+			thread.join();
+	}
+	virtual void Submit(Vector<AsyncRead*>& reads) override
+	{
+		m_lock.lock();
+		for(AsyncRead* read : reads)
+			m_queued.AddBack(read);
+		m_lock.unlock();
+		m_readsChanged.notify_all();
+	}
+	virtual bool IsIoUring() const override
+	{
+		return false;
+	}
+
+private:
+	void m_ReadThread()
+	{
+		Profiler::SetThreadName("Async File Thread");
+		while(true)
+		{
+			AsyncRead* read;
+			{
+				std::unique_lock<Mutex> lock(m_lock);
+				// Queued reads are finished before the threads exit
+				m_readsChanged.wait(lock, [this]() { return m_terminate || !m_queued.empty(); });
+				if(m_queued.empty())
+					return;
+				read = m_queued.front();
+				m_queued.pop_front();
+			}
+			m_Read(*read);
+			List<AsyncRead*> finished = { read };
+			m_sink.Finish(finished);
+		}
+	}
+	static void m_Read(AsyncRead& read)
+	{
+		ProfileZone("Async File Read");
+		AsyncReadRequest& request = read.request;
+		File file;
+		if(!file.OpenRead(request.path))
+			return;
+
+		size_t fileSize = file.GetSize();
+		size_t offset = Math::Min(request.offset, fileSize);
+		size_t length = Math::Min(request.length, fileSize - offset);
+		read.result.data.resize(length);
+		file.Seek(offset);
+		size_t done = 0;
+		while(done < length)
+		{
+			size_t numRead = file.Read(read.result.data.data() + done, length - done);
+			if(numRead == 0 || numRead == (size_t)-1)
+				break;
+			done += numRead;
+		}
+		read.result.data.resize(done);
+		read.result.success = true;
+	}
+
+	AsyncReadSink& m_sink;
+	Vector<Thread> m_threads;
+	List<AsyncRead*> m_queued;
+	Mutex m_lock;
+	std::condition_variable_any m_readsChanged;
+	bool m_terminate = false;
+};
+
+class AsyncFileReader_Impl : public AsyncReadSink
+{
+public:
+	AsyncFileReader_Impl(uint32 numThreads, bool allowIoUring)
+	{
+		if(allowIoUring)
+			m_backend = CreateIoUringBackend(*this);
+		if(!m_backend)
+			m_backend = new ThreadAsyncFileBackend(*this, numThreads);
+	}
+	~AsyncFileReader_Impl()
+	{
+		// The backend finishes the reads that are in progress
+		delete m_backend;
+		for(AsyncRead* read : m_finished)
+			delete read;
+	}
+
+	void Submit(Vector<AsyncReadRequest>& requests)
+	{
+		if(requests.empty())
+			return;
+		Vector<AsyncRead*> reads;
+		reads.reserve(requests.size());
+		for(AsyncReadRequest& request : requests)
+		{
+			AsyncRead* read = reads.Add(new AsyncRead());
+			read->request = std::move(request);
+			read->result.path = read->request.path;
+			read->result.offset = read->request.offset;
+		}
+		requests.clear();
+		m_numPending += (uint32)reads.size();
+		m_backend->Submit(reads);
+	}
+
+	virtual void Finish(List<AsyncRead*>& reads) override
+	{
+		m_finishedLock.lock();
+		m_finished.splice(m_finished.end(), reads);
+		m_finishedLock.unlock();
+		m_readFinished.notify_all();
+	}
+
+	void Update()
+	{
+		m_finishedLock.lock();
+		List<AsyncRead*> finished = std::move(m_finished);
+		m_finished.clear();
+		m_finishedLock.unlock();
+
+		for(AsyncRead* read : finished)
+		{
+			if(read->request.callback.IsBound())
+				read->request.callback.Call(read->result);
+			delete read;
+			m_numPending--;
+		}
+	}
+	void WaitAll()
+	{
+		while(m_numPending > 0)
+		{
+			{
+				std::unique_lock<Mutex> lock(m_finishedLock);
+				m_readFinished.wait(lock, [this]() { return !m_finished.empty(); });
+			}
+			Update();
+		}
+	}
+
+	AsyncFileBackend* m_backend = nullptr;
+	// Submitted reads whose callback has not been called yet
+	std::atomic<uint32> m_numPending = { 0 };
+
+	List<AsyncRead*> m_finished;
+	Mutex m_finishedLock;
+	std::condition_variable_any m_readFinished;
+};
+
+AsyncFileReader::AsyncFileReader(uint32 numThreads, bool allowIoUring)
+{
+	m_impl = new AsyncFileReader_Impl(numThreads, allowIoUring);
+}
+AsyncFileReader::~AsyncFileReader()
+{
+	delete m_impl;
+}
+void AsyncFileReader::Read(AsyncReadRequest&& request)
+{
+	Vector<AsyncReadRequest> requests;
+	requests.push_back(std::move(request));
+	m_impl->Submit(requests);
+}
+void AsyncFileReader::Read(Vector<AsyncReadRequest>& requests)
+{
+	m_impl->Submit(requests);
+}
+void AsyncFileReader::Update()
+{
+	m_impl->Update();
+}
+void AsyncFileReader::WaitAll()
+{
+	m_impl->WaitAll();
+}
+uint32 AsyncFileReader::GetNumPending() const
+{
+	return m_impl->m_numPending;
+}
+bool AsyncFileReader::IsUsingIoUring() const
+{
+	return m_impl->m_backend->IsIoUring();
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "AsyncFileReader.hpp"
+#include "List.hpp"
+
+// A read that is being processed by a backend
+struct AsyncRead
+{
+	AsyncReadRequest request;
+	AsyncReadResult result;
+};
+
+// Receives the reads that are finished by a backend
+class AsyncReadSink
+{
+public:
+	virtual ~AsyncReadSink() = default;
+	// Can be called from any thread, the reads are moved out of the list
+	virtual void Finish(List<AsyncRead*>& reads) = 0;
+};
+
+/*
+	Performs the reads for an AsyncFileReader
+	the backend should finish every submitted read before it is destroyed
+*/
+class AsyncFileBackend
+{
+public:
+	virtual ~AsyncFileBackend() = default;
+	virtual void Submit(Vector<AsyncRead*>& reads) = 0;
+	virtual bool IsIoUring() const = 0;
+};
+
+// Creates the io_uring backend, returns null if the platform or kernel does not support it
+AsyncFileBackend* CreateIoUringBackend(AsyncReadSink& sink);
@@ -30,7 +30,7 @@ bool BinaryStream::SerializeObject(String& obj)
 		len = (uint32)obj.size();
 		*this << len;
 	}
-	Serialize(obj.GetData(), len); 
+	SerializeBytes(obj.GetData(), len);
 	return true;
 }
 bool BinaryStream::SerializeObject(WString& obj)
@@ -46,6 +46,6 @@ bool BinaryStream::SerializeObject(WString& obj)
 		len = (uint32)obj.size();
 		*this << len;
 	}
-	Serialize(obj.GetData(), len * 2);
+	SerializeBytes(obj.GetData(), len * 2);
 	return true;
 }
\ No newline at end of file
@@ -18,7 +18,7 @@ bool ConfigBase::Load(const String& path)
     File file;
     if(!file.OpenRead(path))
         return false;
-    FileReader reader(file);
+    BufferedFileReader reader(file);
     return Load(reader);
 }
 bool ConfigBase::Load(BinaryStream& stream)
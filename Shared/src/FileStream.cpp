@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "FileStream.hpp"
+#include "Math.hpp"
 
 FileStreamBase::FileStreamBase(File& file, bool isReading) : m_file(&file), BinaryStream(isReading)
 {
@@ -43,3 +44,78 @@ size_t FileWriter::Serialize(void* data, size_t len)
 	assert(m_file);
 	return m_file->Write(data, len);
 }
+
+BufferedFileReader::BufferedFileReader(File& file, size_t bufferSize) : FileStreamBase(file, true)
+{
+	assert(bufferSize > 0);
+	m_readBuffer.resize(bufferSize);
+	m_bufferStart = file.Tell();
+	m_fileSize = file.GetSize();
+}
+size_t BufferedFileReader::Serialize(void* data, size_t len)
+{
+	assert(m_file);
+	uint8* out = (uint8*)data;
+	size_t total = 0;
+	while(len > 0)
+	{
+		size_t available = m_bufferSize - m_bufferPosition;
+		if(available == 0)
+		{
+			// Large reads go to the output directly
+			if(len >= m_readBuffer.size())
+			{
+				m_bufferStart += m_bufferSize;
+				m_bufferSize = 0;
+				m_bufferPosition = 0;
+				size_t read = m_file->Read(out, len);
+				if(read == (size_t)-1)
+					read = 0;
+				m_bufferStart += read;
+				return total + read;
+			}
+			if(!m_Fill())
+				break;
+			continue;
+		}
+
+		size_t copy = Math::Min(available, len);
+		memcpy(out, m_readBuffer.data() + m_bufferPosition, copy);
+		m_bufferPosition += copy;
+		out += copy;
+		total += copy;
+		len -= copy;
+	}
+	return total;
+}
+void BufferedFileReader::Seek(size_t pos)
+{
+	assert(m_file);
+	// Keep the buffer when seeking inside of it
+	if(pos >= m_bufferStart && pos <= m_bufferStart + m_bufferSize)
+	{
+		m_bufferPosition = pos - m_bufferStart;
+		return;
+	}
+	m_file->Seek(pos);
+	m_bufferStart = pos;
+	m_bufferSize = 0;
+	m_bufferPosition = 0;
+}
+size_t BufferedFileReader::Tell() const
+{
+	return m_bufferStart + m_bufferPosition;
+}
+size_t BufferedFileReader::GetSize() const
+{
+	return m_fileSize;
+}
+bool BufferedFileReader::m_Fill()
+{
+	m_bufferStart += m_bufferSize;
+	m_bufferPosition = 0;
+	m_bufferSize = m_file->Read(m_readBuffer.data(), m_readBuffer.size());
+	if(m_bufferSize == (size_t)-1)
+		m_bufferSize = 0;
+	return m_bufferSize > 0;
+}
@@ -0,0 +1,97 @@
+#include "stdafx.h"
+#include "FrameArena.hpp"
+#include "Math.hpp"
+
+FrameArena::FrameArena(size_t blockSize) : m_blockSize(blockSize)
+{
+}
+FrameArena::~FrameArena()
+{
+	for(Block& block : m_blocks)
+		delete[] block.data;
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+	for(uint32 attempt = 0; attempt < 2; attempt++)
+	{
+		if(!m_blocks.empty())
+		{
+			Block& block = m_blocks.back();
+			size_t address = (size_t)(block.data + m_offset);
+			size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+			if(m_offset + padding + size <= block.size)
+			{
+				m_offset += padding + size;
+				m_used += size;
+				return (void*)(address + padding);
+			}
+		}
+
+		// Doesn't fit in the current block, the new block has enough space for any padding
+		m_AddBlock(size + alignment);
+	}
+	assert(false);
+	return nullptr;
+}
+const char* FrameArena::CopyString(const char* str, size_t length)
+{
+	char* copy = (char*)Allocate(length + 1, 1);
+	memcpy(copy, str, length);
+	copy[length] = 0;
+	return copy;
+}
+
+void FrameArena::Reset()
+{
+	if(m_blocks.size() > 1)
+	{
+		size_t capacity = GetCapacity();
+		for(Block& block : m_blocks)
+			delete[] block.data;
+		m_blocks.clear();
+		m_AddBlock(capacity);
+	}
+	m_offset = 0;
+	m_used = 0;
+}
+
+size_t FrameArena::GetUsed() const
+{
+	return m_used;
+}
+size_t FrameArena::GetCapacity() const
+{
+	size_t capacity = 0;
+	for(const Block& block : m_blocks)
+		capacity += block.size;
+	return capacity;
+}
+
+void FrameArena::m_AddBlock(size_t minSize)
+{
+	Block block;
+	block.size = Math::Max(m_blockSize, minSize);
+	block.data = new uint8[block.size];
+	m_blocks.Add(block);
+	m_offset = 0;
+}
+
+DoubleBufferedFrameArena::DoubleBufferedFrameArena(size_t blockSize)
+	: m_arenas{ { blockSize }, { blockSize } }
+{
+}
+FrameArena& DoubleBufferedFrameArena::Get()
+{
+	return m_arenas[m_current];
+}
+FrameArena& DoubleBufferedFrameArena::GetPrevious()
+{
+	return m_arenas[m_current ^ 1];
+}
+void DoubleBufferedFrameArena::Swap()
+{
+	m_current ^= 1;
+	m_arenas[m_current].Reset();
+}
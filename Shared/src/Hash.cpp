@@ -0,0 +1,102 @@
+#include "stdafx.h"
+#include "Hash.hpp"
+
+// Constants and algorithm from the xxHash specification
+static const uint64 prime1 = 11400714785074694791ULL;
+static const uint64 prime2 = 14029467366897019727ULL;
+static const uint64 prime3 = 1609587929392839161ULL;
+static const uint64 prime4 = 9650029242287828579ULL;
+static const uint64 prime5 = 2870177450012600261ULL;
+
+static inline uint64 RotateLeft(uint64 value, uint32 bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+// Unaligned little endian reads
+static inline uint64 Read64(const uint8* ptr)
+{
+	uint64 value;
+	memcpy(&value, ptr, sizeof(value));
+	return value;
+}
+static inline uint32 Read32(const uint8* ptr)
+{
+	uint32 value;
+	memcpy(&value, ptr, sizeof(value));
+	return value;
+}
+static inline uint64 Round(uint64 acc, uint64 input)
+{
+	acc += input * prime2;
+	acc = RotateLeft(acc, 31);
+	return acc * prime1;
+}
+static inline uint64 MergeRound(uint64 acc, uint64 value)
+{
+	acc ^= Round(0, value);
+	return acc * prime1 + prime4;
+}
+
+uint64 Hash::XXHash64(const void* data, size_t length, uint64 seed)
+{
+	const uint8* ptr = (const uint8*)data;
+	const uint8* end = ptr + length;
+	uint64 hash;
+
+	if(length >= 32)
+	{
+		// Process 32 byte stripes using 4 accumulators
+		uint64 v1 = seed + prime1 + prime2;
+		uint64 v2 = seed + prime2;
+		uint64 v3 = seed;
+		uint64 v4 = seed - prime1;
+		const uint8* limit = end - 32;
+		do
+		{
+			v1 = Round(v1, Read64(ptr));
+			v2 = Round(v2, Read64(ptr + 8));
+			v3 = Round(v3, Read64(ptr + 16));
+			v4 = Round(v4, Read64(ptr + 24));
+			ptr += 32;
+		} while(ptr <= limit);
+
+		hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+		hash = MergeRound(hash, v1);
+		hash = MergeRound(hash, v2);
+		hash = MergeRound(hash, v3);
+		hash = MergeRound(hash, v4);
+	}
+	else
+	{
+		hash = seed + prime5;
+	}
+	hash += (uint64)length;
+
+	// Remaining bytes
+	while(ptr + 8 <= end)
+	{
+		hash ^= Round(0, Read64(ptr));
+		hash = RotateLeft(hash, 27) * prime1 + prime4;
+		ptr += 8;
+	}
+	if(ptr + 4 <= end)
+	{
+		hash ^= (uint64)Read32(ptr) * prime1;
+		hash = RotateLeft(hash, 23) * prime2 + prime3;
+		ptr += 4;
+	}
+	while(ptr < end)
+	{
+		hash ^= (*ptr) * prime5;
+		hash = RotateLeft(hash, 11) * prime1;
+		ptr++;
+	}
+
+	// Final mix
+	hash ^= hash >> 33;
+	hash *= prime2;
+	hash ^= hash >> 29;
+	hash *= prime3;
+	hash ^= hash >> 32;
+	return hash;
+}
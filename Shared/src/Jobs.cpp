@@ -4,8 +4,11 @@
 #include "Vector.hpp"
 #include "Log.hpp"
 #include "Thread.hpp"
+#include "Math.hpp"
+#include "Profiling.hpp"
 #include <thread>
-#include "Timer.hpp"
+#include <atomic>
+#include <condition_variable>
 
 JobFlags operator|(JobFlags a, JobFlags b)
 {
@@ -16,46 +19,61 @@ JobFlags operator&(JobFlags a, JobFlags b)
 	return (JobFlags)((uint8)a & (uint8)b);
 }
 
+static const uint32 numPriorities = (uint32)JobPriority::Background + 1;
+
 struct JobThread
 {
 	// Thread index
 	uint32 index = 0;
-	bool terminate = false;
+	class JobSheduler_Impl* sheduler = nullptr;
 	Thread thread;
 
-	// Job currently being processed
-	Job activeJob;
+	// Jobs queued on this thread for every priority, other threads can take jobs from these as well
+	List<Job> queues[numPriorities];
+	// Total number of jobs in the queues, used to skip empty queues without locking them
+	std::atomic<uint32> numQueued;
+	Mutex lock;
 
-	Timer idleDuration;
+	// Job currently being processed
+	//	set while holding the queue lock, so a job is always either queued or active
+	std::atomic<JobBase*> activeJob;
 
-	// Terminate this thread
-	void Terminate()
+	JobThread() : numQueued(0), activeJob(nullptr)
 	{
-		if(terminate)
-			return; // Already terminated
-		terminate = true;
-		if(thread.joinable())
-			thread.join();
 	}
-	bool IsActive() const { return activeJob.IsValid(); }
 };
 
+// Worker thread of the current thread, null on threads that don't belong to a job sheduler
+static thread_local JobThread* currentJobThread = nullptr;
+
 class JobSheduler_Impl
 {
 public:
-	// Contains tasks to be done
-	List<Job> m_jobQueue;
+	Vector<JobThread*> m_threadPool;
+
 	// Contains tasks that are done
 	List<Job> m_finishedJobs;
-	
-	Mutex m_lock;
-	Vector<JobThread*> m_threadPool;
+	Mutex m_finishedLock;
+
+	// Idle threads wait for this to be signaled
+	Mutex m_sleepLock;
+	std::condition_variable_any m_jobsChanged;
+	// Incremented when a job is queued or an IO job finished, protected by m_sleepLock
+	//	threads that didn't find a job wait for this to change
+	std::atomic<uint64> m_changeCount;
+	bool m_terminate = false;
+
+	// Used to spread jobs queued from other threads over the job threads
+	std::atomic<uint32> m_nextThread;
+	// Number of running IO jobs and the maximum allowed at once
+	std::atomic<uint32> m_numIOJobs;
+	uint32 m_maxIOJobs = 1;
 
 	friend class JobBase;
 
-	JobSheduler_Impl()
+	JobSheduler_Impl(uint32 numThreads) : m_changeCount(0), m_nextThread(0), m_numIOJobs(0)
 	{
-		AllocateThreads();
+		AllocateThreads(numThreads);
 	}
 	~JobSheduler_Impl()
 	{
@@ -63,52 +81,66 @@ public:
 	}
 	void ClearThreads()
 	{
+		m_sleepLock.lock();
+		m_terminate = true;
+		m_sleepLock.unlock();
+		m_jobsChanged.notify_all();
+
 		for(JobThread* t : m_threadPool)
 		{
-			t->Terminate();
-			delete t;
+			if(t->thread.joinable())
+				t->thread.join();
 		}
-		m_lock.lock();
+
 		// Unregister jobs
-		for(auto job : m_jobQueue)
+		for(JobThread* t : m_threadPool)
 		{
-			job->m_sheduler = nullptr;
+			for(auto& queue : t->queues)
+			{
+				for(auto job : queue)
+					job->m_sheduler = nullptr;
+			}
+			delete t;
 		}
+		m_threadPool.clear();
+
+		m_finishedLock.lock();
 		for(auto job : m_finishedJobs)
 		{
 			job->m_sheduler = nullptr;
 		}
-		m_threadPool.clear();
-		m_lock.unlock();
+		m_finishedJobs.clear();
+		m_finishedLock.unlock();
 	}
-	void AllocateThreads()
+	void AllocateThreads(uint32 numThreads)
 	{
 		assert(m_threadPool.empty());
 
-		unsigned concurentThreadsSupported = std::thread::hardware_concurrency();
-		int32 targetThreadCount = concurentThreadsSupported - 2;
-		if(targetThreadCount <= 0)
-			targetThreadCount = 1;
-
-		for(int32 i = 0; i < targetThreadCount; i++)
+		if(numThreads == 0)
 		{
-			// Create affinity mask for job threads
-			// always skip the first core since it runs the main thread
-			uint32 affinityMask = 1 << (i+1);
+			// Leave room for the main and audio threads
+			int32 targetThreadCount = (int32)std::thread::hardware_concurrency() - 2;
+			numThreads = (uint32)Math::Max(targetThreadCount, 1);
+		}
+		m_maxIOJobs = Math::Max(numThreads / 2, 1u);
 
+		for(uint32 i = 0; i < numThreads; i++)
+		{
 			JobThread* thread = m_threadPool.Add(new JobThread());
 			thread->index = i;
-			thread->thread = Thread(&JobSheduler_Impl::m_JobThread, this, thread);
-			thread->thread.SetAffinityMask(affinityMask);
+			thread->sheduler = this;
 		}
+		// Started after all threads are created, since they access each others queues
+		for(JobThread* thread : m_threadPool)
+			thread->thread = Thread(&JobSheduler_Impl::m_JobThread, this, thread);
 	}
 
 	void Update()
 	{
-		m_lock.lock();
-		List<Job> finished = m_finishedJobs;
+		m_finishedLock.lock();
+		List<Job> finished = std::move(m_finishedJobs);
 		m_finishedJobs.clear();
-		m_lock.unlock();
+		m_finishedLock.unlock();
 
 		for(Job& j : finished)
 		{
@@ -123,75 +155,159 @@ public:
 	{
 		job->m_sheduler = this;
 
-		m_lock.lock();
-		m_jobQueue.AddBack(job);
-		m_lock.unlock();
+		// Jobs queued from a job thread stay on that thread, others are spread over all threads
+		JobThread* thread = currentJobThread;
+		if(!thread || thread->sheduler != this)
+			thread = m_threadPool[m_nextThread++ % m_threadPool.size()];
+
+		thread->lock.lock();
+		thread->queues[(uint32)job->priority].AddBack(job);
+		thread->numQueued++;
+		thread->lock.unlock();
 
+		m_SignalChange();
 		return true;
 	}
 
-private:
-	// Single job thread
-	void m_JobThread(JobThread* myThread)
+	// Removes a job that was not started yet from the queues
+	bool RemoveQueued(JobBase* job)
 	{
-		while(!myThread->terminate)
+		for(JobThread* t : m_threadPool)
 		{
-			if(!m_jobQueue.empty())
+			std::lock_guard<Mutex> lock(t->lock);
+			for(auto& queue : t->queues)
 			{
-				m_lock.lock();
-				if(!m_jobQueue.empty())
+				for(auto it = queue.begin(); it != queue.end(); it++)
 				{
-					myThread->idleDuration.Restart();
-
-					// Process a job
-					Job peekJob = m_jobQueue.front();
-					if((peekJob->jobFlags & JobFlags::IO) != JobFlags::IO || (myThread->index != 0)) // Only perform IO on first thread
+					if(*it == job)
 					{
-						myThread->activeJob = m_jobQueue.PopFront();
-						m_lock.unlock();
+						queue.erase(it);
+						t->numQueued--;
+						return true;
+					}
+				}
+			}
+		}
+		return false;
+	}
+	bool Dequeue(JobBase* job)
+	{
+		if(!RemoveQueued(job))
+			return false;
+		// Jobs that were never started are not accessed by any other thread
+		job->m_sheduler = nullptr;
+		return true;
+	}
 
-						// Run
-						myThread->activeJob->m_ret = myThread->activeJob->Run();
-						myThread->activeJob->m_finished = true;
+private:
+	// Wakes up a thread waiting for jobs
+	void m_SignalChange()
+	{
+		m_sleepLock.lock();
+		m_changeCount++;
+		m_sleepLock.unlock();
+		m_jobsChanged.notify_one();
+	}
 
-						// Add to finished queue
-						m_lock.lock();
-						m_finishedJobs.AddBack(myThread->activeJob);
-						m_lock.unlock();
+	// Takes the job with the highest priority, preferring jobs queued on the given thread
+	//	the job is set as the active job of the thread
+	Job m_TakeJob(JobThread* myThread)
+	{
+		uint32 numThreads = (uint32)m_threadPool.size();
+		for(uint32 priority = 0; priority < numPriorities; priority++)
+		{
+			for(uint32 i = 0; i < numThreads; i++)
+			{
+				JobThread* thread = m_threadPool[(myThread->index + i) % numThreads];
+				if(thread->numQueued == 0)
+					continue;
 
-						// Clear the active job
-						myThread->activeJob.Release();
-					}
-					else
-					{
-						m_lock.unlock();
-					}
-				}
-				else
+				std::lock_guard<Mutex> lock(thread->lock);
+				List<Job>& queue = thread->queues[priority];
+				for(auto it = queue.begin(); it != queue.end(); it++)
 				{
-					// Just do nothing
-					m_lock.unlock();
+					// Skip IO jobs while the maximum number of them is running
+					if(((*it)->jobFlags & JobFlags::IO) == JobFlags::IO && !m_TryStartIOJob())
+						continue;
+
+					Job job = std::move(*it);
+					queue.erase(it);
+					thread->numQueued--;
+					myThread->activeJob = job.GetData();
+					return job;
 				}
 			}
+		}
+		return Job();
+	}
+	bool m_TryStartIOJob()
+	{
+		uint32 numIOJobs = m_numIOJobs;
+		while(numIOJobs < m_maxIOJobs)
+		{
+			if(m_numIOJobs.compare_exchange_weak(numIOJobs, numIOJobs + 1))
+				return true;
+		}
+		return false;
+	}
+
+	// Single job thread
+	void m_JobThread(JobThread* myThread)
+	{
+		currentJobThread = myThread;
+		Profiler::SetThreadName("Job Thread");
+		while(true)
+		{
+			// Read before looking for jobs, so jobs queued while looking are not missed
+			uint64 changeCount = m_changeCount;
+
+			Job job = m_TakeJob(myThread);
+			if(!job)
+			{
+				std::unique_lock<Mutex> lock(m_sleepLock);
+				m_jobsChanged.wait(lock, [&]() { return m_terminate || m_changeCount != changeCount; });
+				if(m_terminate)
+					break;
+				continue;
+			}
+
+			// Run
+			{
+				ProfileZone("Job");
+				job->m_ret = job->Run();
+			}
+			job->m_finished = true;
 
-			// Various idle levels
-			if(myThread->idleDuration.Minutes() > 1)
-				std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-			if(myThread->idleDuration.Seconds() > 1)
-				std::this_thread::sleep_for(std::chrono::milliseconds(500));
-			else
-				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			// Another IO job can be started
+			if((job->jobFlags & JobFlags::IO) == JobFlags::IO)
+			{
+				m_numIOJobs--;
+				m_SignalChange();
+			}
+
+			// Add to finished queue, the job is moved so the main thread holds the only reference
+			m_finishedLock.lock();
+			m_finishedJobs.push_back(std::move(job));
+			m_finishedLock.unlock();
+
+			// Clear the active job
+			myThread->activeJob = nullptr;
 		}
+		currentJobThread = nullptr;
 	}
 };
-JobSheduler::JobSheduler()
+JobSheduler::JobSheduler(uint32 numThreads)
 {
-	m_impl = new JobSheduler_Impl();
+	m_impl = new JobSheduler_Impl(numThreads);
 }
 JobSheduler::~JobSheduler()
 {
 	delete m_impl;
 }
+uint32 JobSheduler::GetNumThreads() const
+{
+	return (uint32)m_impl->m_threadPool.size();
+}
 void JobSheduler::Update()
 {
 	m_impl->Update();
@@ -213,6 +329,10 @@ bool JobSheduler::Queue(Job job)
 
 	return m_impl->QueueUnchecked(job);
 }
+bool JobSheduler::Dequeue(Job job)
+{
+	return m_impl->Dequeue(job.GetData());
+}
 
 bool JobBase::IsFinished() const
 {
@@ -233,45 +353,33 @@ void JobBase::Terminate()
 	JobSheduler_Impl* sheduler = m_sheduler;
 
 	// Try to erase from queue first
-	m_sheduler->m_lock.lock();
-	for(auto it = sheduler->m_jobQueue.begin(); it != sheduler->m_jobQueue.end(); it++)
+	if(sheduler->RemoveQueued(this))
 	{
-		if(*it == this)
-		{
-			sheduler->m_jobQueue.erase(it);
-			m_sheduler = nullptr;
-			m_sheduler->m_lock.unlock();
-			return; // Ok
-		}
+		m_sheduler = nullptr;
+		return; // Ok
 	}
-	m_sheduler->m_lock.unlock();
 
 	// Wait for running job
-	for(JobThread* t : m_sheduler->m_threadPool)
+	for(JobThread* t : sheduler->m_threadPool)
 	{
-		if(t->activeJob == this)
+		// Wait for job to complete
+		while(t->activeJob == this)
 		{
-			// Wait for job to complete
-			while(t->activeJob == this)
-			{
-				std::this_thread::yield();
-			}
-			break;
+			std::this_thread::yield();
 		}
 	}
 
 	// Remove from finished jobs list
-	m_sheduler->m_lock.lock();
-	for(auto it = m_sheduler->m_finishedJobs.rbegin(); it != m_sheduler->m_finishedJobs.rend(); it++)
+	std::lock_guard<Mutex> lock(sheduler->m_finishedLock);
+	for(auto it = sheduler->m_finishedJobs.rbegin(); it != sheduler->m_finishedJobs.rend(); it++)
 	{
 		if(*it == this)
 		{
-			m_sheduler->m_finishedJobs.erase(--(it.base()));
-			m_sheduler->m_lock.unlock();
+			sheduler->m_finishedJobs.erase(--(it.base()));
+			m_sheduler = nullptr;
 			return;
 		}
 	}
-	m_sheduler->m_lock.unlock();
 }
 void JobBase::Finalize()
 {
@@ -0,0 +1,340 @@
+#include "stdafx.h"
+#include "AsyncFileReader_Impl.hpp"
+#include "List.hpp"
+#include "Log.hpp"
+#include "Math.hpp"
+#include "Thread.hpp"
+#include "Profiling.hpp"
+#include <condition_variable>
+#include <chrono>
+
+/*
+	Linux implementation
+	uses io_uring through the system calls directly, since liburing is not always installed
+*/
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+// Number of submission queue entries
+static const uint32 ringSize = 64;
+// Maximum size of a single read operation, longer reads are split
+static const size_t maxReadSize = 1 << 30;
+// Longest wait in milliseconds between io_uring_enter calls that keep failing
+static const uint32 maxEnterRetryDelay = 100;
+
+/*
+	Backend that submits reads to an io_uring from a single thread
+	the thread opens the files, submits reads and waits for them to complete
+	files are opened with blocking calls since opening through io_uring needs a newer kernel than reading
+*/
+class IoUringBackend : public AsyncFileBackend
+{
+public:
+	IoUringBackend(AsyncReadSink& sink) : m_sink(sink)
+	{
+	}
+	~IoUringBackend()
+	{
+		if(m_thread.joinable())
+		{
+			m_lock.lock();
+			m_terminate = true;
+			m_lock.unlock();
+			m_readsChanged.notify_all();
+			m_thread.join();
+		}
+		if(m_sqes)
+			munmap(m_sqes, m_sqesSize);
+		if(m_cqRing)
+			munmap(m_cqRing, m_cqRingSize);
+		if(m_sqRing)
+			munmap(m_sqRing, m_sqRingSize);
+		if(m_ring != -1)
+			close(m_ring);
+	}
+
+	// Creates the ring, fails on kernels without io_uring or when it is blocked
+	bool Init()
+	{
+		io_uring_params params;
+		memset(&params, 0, sizeof(params));
+		m_ring = (int)syscall(__NR_io_uring_setup, ringSize, &params);
+		if(m_ring < 0)
+		{
+			Logf("io_uring is not available (%d), reading files on threads", Logger::Info, errno);
+			m_ring = -1;
+			return false;
+		}
+
+		m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32);
+		m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+		m_sqRing = m_Map(m_sqRingSize, IORING_OFF_SQ_RING);
+		m_cqRing = m_Map(m_cqRingSize, IORING_OFF_CQ_RING);
+		m_sqes = (io_uring_sqe*)m_Map(m_sqesSize, IORING_OFF_SQES);
+		if(!m_sqRing || !m_cqRing || !m_sqes)
+		{
+			Logf("Failed to map io_uring (%d), reading files on threads", Logger::Warning, errno);
+			return false;
+		}
+
+		uint8* sq = (uint8*)m_sqRing;
+		m_sqHead = (uint32*)(sq + params.sq_off.head);
+		m_sqTail = (uint32*)(sq + params.sq_off.tail);
+		m_sqMask = *(uint32*)(sq + params.sq_off.ring_mask);
+		m_sqEntries = params.sq_entries;
+		m_sqArray = (uint32*)(sq + params.sq_off.array);
+		uint8* cq = (uint8*)m_cqRing;
+		m_cqHead = (uint32*)(cq + params.cq_off.head);
+		m_cqTail = (uint32*)(cq + params.cq_off.tail);
+		m_cqMask = *(uint32*)(cq + params.cq_off.ring_mask);
+		m_cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+
+		m_thread = Thread(&IoUringBackend::m_IOThread, this);
+		return true;
+	}
+
+	virtual void Submit(Vector<AsyncRead*>& reads) override
+	{
+		m_lock.lock();
+		for(AsyncRead* read : reads)
+			m_queued.AddBack(read);
+		m_lock.unlock();
+		m_readsChanged.notify_all();
+	}
+	virtual bool IsIoUring() const override
+	{
+		return true;
+	}
+
+private:
+	// State of a read that was started
+	struct Operation
+	{
+		AsyncRead* read;
+		int handle;
+		size_t offset;
+		size_t length;
+		// Number of bytes read so far
+		size_t done = 0;
+		iovec vector;
+	};
+
+	void* m_Map(size_t size, off_t offset)
+	{
+		void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, offset);
+		return ptr == MAP_FAILED ? nullptr : ptr;
+	}
+
+	void m_IOThread()
+	{
+		Profiler::SetThreadName("Async File Thread");
+		while(true)
+		{
+			List<AsyncRead*> started;
+			{
+				std::unique_lock<Mutex> lock(m_lock);
+				// Sleeps when nothing is being read, otherwise new reads are picked up after waiting for a completion below
+				m_readsChanged.wait(lock, [this]()
+				{
+					return m_terminate || !m_queued.empty() || m_numInFlight > 0 || !m_unsubmitted.empty();
+				});
+				if(m_terminate && m_queued.empty() && m_numInFlight == 0 && m_unsubmitted.empty())
+					return;
+				started = std::move(m_queued);
+				m_queued.clear();
+			}
+
+			for(AsyncRead* read : started)
+				m_Start(read);
+			m_SubmitAndWait();
+			m_Complete();
+			// Finished reads are passed on together to wake up the thread that handles them only once
+			if(!m_finished.empty())
+				m_sink.Finish(m_finished);
+		}
+	}
+
+	// Opens the file of a read and queues its first operation
+	void m_Start(AsyncRead* read)
+	{
+		AsyncReadRequest& request = read->request;
+		int handle = open(*request.path, O_RDONLY);
+		if(handle == -1)
+		{
+			m_finished.AddBack(read);
+			return;
+		}
+		struct stat sb;
+		if(fstat(handle, &sb) != 0)
+		{
+			close(handle);
+			m_finished.AddBack(read);
+			return;
+		}
+
+		size_t fileSize = (size_t)sb.st_size;
+		Operation* operation = new Operation();
+		operation->read = read;
+		operation->handle = handle;
+		operation->offset = Math::Min(request.offset, fileSize);
+		operation->length = Math::Min(request.length, fileSize - operation->offset);
+		read->result.data.resize(operation->length);
+		if(operation->length == 0)
+		{
+			m_Finish(operation, true);
+			return;
+		}
+		m_unsubmitted.AddBack(operation);
+	}
+	void m_Finish(Operation* operation, bool success)
+	{
+		close(operation->handle);
+		AsyncRead* read = operation->read;
+		read->result.data.resize(operation->done);
+		read->result.success = success;
+		delete operation;
+		m_finished.AddBack(read);
+	}
+
+	// Submits the queued operations and waits for at least one to complete
+	void m_SubmitAndWait()
+	{
+		uint32 tail = *m_sqTail;
+		uint32 head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+		uint32 numSubmitted = 0;
+		// Completions can't overflow since the number of operations in flight is limited to the submission queue size
+		while(!m_unsubmitted.empty() && tail - head < m_sqEntries && m_numInFlight + numSubmitted < m_sqEntries)
+		{
+			Operation* operation = m_unsubmitted.front();
+			m_unsubmitted.pop_front();
+			operation->vector.iov_base = operation->read->result.data.data() + operation->done;
+			operation->vector.iov_len = Math::Min(operation->length - operation->done, maxReadSize);
+
+			uint32 index = tail & m_sqMask;
+			io_uring_sqe& sqe = m_sqes[index];
+			memset(&sqe, 0, sizeof(sqe));
+			sqe.opcode = IORING_OP_READV;
+			sqe.fd = operation->handle;
+			sqe.off = operation->offset + operation->done;
+			sqe.addr = (uint64)&operation->vector;
+			sqe.len = 1;
+			sqe.user_data = (uint64)operation;
+			m_sqArray[index] = index;
+			tail++;
+			numSubmitted++;
+		}
+		__atomic_store_n(m_sqTail, tail, __ATOMIC_RELEASE);
+
+		m_numInFlight += numSubmitted;
+		uint32 minComplete = m_numInFlight > 0 ? 1 : 0;
+		ProfileZone("Async File Wait");
+		while(true)
+		{
+			// Also submits entries that the kernel did not take after a failed call
+			uint32 numEntries = tail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+			int ret = (int)syscall(__NR_io_uring_enter, m_ring, numEntries, minComplete, IORING_ENTER_GETEVENTS, nullptr, 0);
+			if(ret >= 0)
+			{
+				m_enterRetryDelay = 0;
+				break;
+			}
+			if(errno == EINTR)
+				continue;
+
+			// The operations stay in flight and the call is retried, waiting longer each time it fails in a row so the thread doesn't spin
+			if(m_enterRetryDelay == 0)
+			{
+				Logf("io_uring_enter failed: %d", Logger::Error, errno);
+				m_enterRetryDelay = 1;
+			}
+			else
+			{
+				m_enterRetryDelay = Math::Min(m_enterRetryDelay * 2, maxEnterRetryDelay);
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(m_enterRetryDelay));
+			break;
+		}
+	}
+
+	// Handles the completed operations
+	void m_Complete()
+	{
+		uint32 head = *m_cqHead;
+		uint32 tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+		for(; head != tail; head++)
+		{
+			io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+			Operation* operation = (Operation*)cqe.user_data;
+			int32 result = cqe.res;
+			m_numInFlight--;
+
+			if(result == -EINTR || result == -EAGAIN)
+			{
+				m_unsubmitted.AddBack(operation);
+			}
+			else if(result < 0)
+			{
+				m_Finish(operation, false);
+			}
+			else
+			{
+				// Short reads are continued, reading nothing means the file got shorter
+				operation->done += result;
+				if(result > 0 && operation->done < operation->length)
+					m_unsubmitted.AddBack(operation);
+				else
+					m_Finish(operation, true);
+			}
+		}
+		__atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+	}
+
+	AsyncReadSink& m_sink;
+	Thread m_thread;
+
+	List<AsyncRead*> m_queued;
+	Mutex m_lock;
+	std::condition_variable_any m_readsChanged;
+	bool m_terminate = false;
+
+	// Only used by the IO thread
+	List<Operation*> m_unsubmitted;
+	List<AsyncRead*> m_finished;
+	uint32 m_numInFlight = 0;
+	// Milliseconds to wait before calling io_uring_enter again after it failed, 0 after it succeeded
+	uint32 m_enterRetryDelay = 0;
+
+	int m_ring = -1;
+	void* m_sqRing = nullptr;
+	void* m_cqRing = nullptr;
+	io_uring_sqe* m_sqes = nullptr;
+	size_t m_sqRingSize = 0;
+	size_t m_cqRingSize = 0;
+	size_t m_sqesSize = 0;
+	uint32* m_sqHead = nullptr;
+	uint32* m_sqTail = nullptr;
+	uint32* m_sqArray = nullptr;
+	uint32 m_sqMask = 0;
+	uint32 m_sqEntries = 0;
+	uint32* m_cqHead = nullptr;
+	uint32* m_cqTail = nullptr;
+	uint32 m_cqMask = 0;
+	io_uring_cqe* m_cqes = nullptr;
+};
+
+AsyncFileBackend* CreateIoUringBackend(AsyncReadSink& sink)
+{
+	IoUringBackend* backend = new IoUringBackend(sink);
+	if(!backend->Init())
+	{
+		delete backend;
+		return nullptr;
+	}
+	return backend;
+}
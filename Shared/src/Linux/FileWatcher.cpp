@@ -0,0 +1,221 @@
+#include "stdafx.h"
+#include "FileWatcher.hpp"
+#include "Path.hpp"
+#include "Map.hpp"
+#include "Set.hpp"
+#include "Log.hpp"
+#include "Thread.hpp"
+
+#include <sys/inotify.h>
+#include <sys/types.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <errno.h>
+
+static const uint32 watchMask = IN_CREATE | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+	IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+class FileWatcher_Impl
+{
+public:
+	int m_fd = -1;
+	// Folder paths for every watch descriptor
+	Map<int, String> m_folders;
+	// Folders passed to Watch
+	Set<String> m_rootFolders;
+	// Set when a folder could not be watched
+	bool m_failed = false;
+	Mutex m_lock;
+
+	FileWatcher_Impl()
+	{
+		m_Open();
+	}
+	~FileWatcher_Impl()
+	{
+		m_Close();
+	}
+
+	void m_Open()
+	{
+		m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if(m_fd < 0)
+			Logf("Failed to initialize inotify (%d), changed files will not be detected", Logger::Warning, errno);
+	}
+	void m_Close()
+	{
+		if(m_fd >= 0)
+			close(m_fd);
+		m_fd = -1;
+		m_folders.clear();
+		m_rootFolders.clear();
+		m_failed = false;
+	}
+
+	// Adds watches for a folder and all of its subfolders
+	//	all files that are found are added to 'filesOut' if specified
+	bool m_WatchRecursive(const String& rootFolder, Set<String>* filesOut)
+	{
+		Vector<String> folderQueue;
+		folderQueue.Add(rootFolder);
+		while(!folderQueue.empty())
+		{
+			String folder = folderQueue.back();
+			folderQueue.pop_back();
+
+			int wd = inotify_add_watch(m_fd, *folder, watchMask);
+			if(wd < 0)
+			{
+				// Out of watches or the folder was removed again
+				if(errno == ENOSPC)
+				{
+					Logf("Reached the maximum number of inotify watches while watching \"%s\"", Logger::Warning, folder);
+					return false;
+				}
+				continue;
+			}
+			m_folders[wd] = folder;
+
+			DIR* dir = opendir(*folder);
+			if(!dir)
+				continue;
+			while(dirent* ent = readdir(dir))
+			{
+				String name = ent->d_name;
+				if(name == "." || name == "..")
+					continue;
+				String path = folder + Path::sep + name;
+				if(ent->d_type == DT_DIR)
+					folderQueue.Add(path);
+				else if(filesOut)
+					filesOut->Add(path);
+			}
+			closedir(dir);
+		}
+		return true;
+	}
+
+	// Removes the watches of a folder that was moved away and its subfolders
+	void m_RemoveWatches(const String& folder)
+	{
+		String prefix = folder + Path::sep;
+		for(auto it = m_folders.begin(); it != m_folders.end();)
+		{
+			if(it->second == folder || it->second.compare(0, prefix.size(), prefix) == 0)
+			{
+				inotify_rm_watch(m_fd, it->first);
+				it = m_folders.erase(it);
+				continue;
+			}
+			it++;
+		}
+	}
+};
+
+FileWatcher::FileWatcher()
+{
+	m_impl = new FileWatcher_Impl();
+}
+FileWatcher::~FileWatcher()
+{
+	delete m_impl;
+}
+bool FileWatcher::Watch(const String& folder)
+{
+	std::lock_guard<Mutex> lock(m_impl->m_lock);
+	if(m_impl->m_fd < 0 || !Path::IsDirectory(folder))
+		return false;
+
+	// Paths are reported the same way as Files::ScanFilesRecursive returns them
+	String rootFolder = Path::Normalize(folder);
+	if(m_impl->m_rootFolders.Contains(rootFolder))
+		return !m_impl->m_failed;
+
+	m_impl->m_rootFolders.Add(rootFolder);
+	if(!m_impl->m_WatchRecursive(rootFolder, nullptr))
+		m_impl->m_failed = true;
+	return !m_impl->m_failed;
+}
+void FileWatcher::Clear()
+{
+	std::lock_guard<Mutex> lock(m_impl->m_lock);
+	m_impl->m_Close();
+	m_impl->m_Open();
+}
+bool FileWatcher::IsWatching() const
+{
+	std::lock_guard<Mutex> lock(m_impl->m_lock);
+	return m_impl->m_fd >= 0 && !m_impl->m_rootFolders.empty() && !m_impl->m_failed;
+}
+Vector<String> FileWatcher::GetChanges(bool& overflow)
+{
+	std::lock_guard<Mutex> lock(m_impl->m_lock);
+	overflow = false;
+
+	Set<String> changes;
+	if(m_impl->m_fd < 0)
+		return Vector<String>();
+
+	alignas(inotify_event) char buffer[16384];
+	while(true)
+	{
+		ssize_t len = read(m_impl->m_fd, buffer, sizeof(buffer));
+		if(len <= 0)
+			break;
+
+		for(char* ptr = buffer; ptr < buffer + len;)
+		{
+			const inotify_event* evt = (const inotify_event*)ptr;
+			ptr += sizeof(inotify_event) + evt->len;
+
+			if(evt->mask & IN_Q_OVERFLOW)
+			{
+				overflow = true;
+				continue;
+			}
+			if(evt->mask & IN_IGNORED)
+			{
+				m_impl->m_folders.erase(evt->wd);
+				continue;
+			}
+
+			String* folder = m_impl->m_folders.Find(evt->wd);
+			if(!folder)
+				continue;
+
+			// The watched folder itself was removed or moved
+			if(evt->mask & (IN_DELETE_SELF | IN_MOVE_SELF))
+			{
+				if(m_impl->m_rootFolders.Contains(*folder))
+					overflow = true;
+				continue;
+			}
+
+			String path = *folder + Path::sep + evt->name;
+			if(evt->mask & IN_ISDIR)
+			{
+				if(evt->mask & (IN_CREATE | IN_MOVED_TO))
+				{
+					// Files might have been added before the watch was added, so report all of them
+					if(!m_impl->m_WatchRecursive(path, &changes))
+						m_impl->m_failed = true;
+				}
+				else if(evt->mask & IN_MOVED_FROM)
+				{
+					m_impl->m_RemoveWatches(path);
+					changes.Add(path);
+				}
+				else if(evt->mask & IN_DELETE)
+				{
+					changes.Add(path);
+				}
+			}
+			else if(evt->mask & (IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE))
+			{
+				changes.Add(path);
+			}
+		}
+	}
+
+	return Vector<String>(changes.begin(), changes.end());
+}
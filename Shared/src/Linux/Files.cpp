@@ -2,95 +2,193 @@
 #include "Files.hpp"
 #include "Path.hpp"
 #include "Log.hpp"
-#include "List.hpp"
 #include "File.hpp"
+#include "Math.hpp"
+#include "Thread.hpp"
 
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <dirent.h>
+#include <condition_variable>
 
-static Vector<FileInfo> _ScanFiles(String rootFolder, String extFilter, bool recurse, bool* interrupt)
+// Maximum number of threads used to scan subfolders
+static const uint32 maxScanThreads = 8;
+
+// State shared between the threads scanning a folder tree
+struct ScanState
 {
-	Vector<FileInfo> ret;
-	if(!Path::IsDirectory(rootFolder))
+	String extFilter;
+	bool filterByExtension;
+	bool recurse;
+	bool* interrupt;
+
+	Mutex lock;
+	std::condition_variable_any folderAdded;
+	// Folders waiting to be scanned
+	Vector<String> folderQueue;
+	// Number of folders that are either queued or being scanned
+	size_t pendingFolders = 0;
+	// Files found by each thread
+	Vector<Vector<FileInfo>> results;
+
+	bool IsInterrupted() const
 	{
-		Logf("Can't run ScanFiles, \"%s\" is not a folder", Logger::Warning, rootFolder);
-		return ret;
+		return interrupt && *interrupt;
 	}
+};
 
-	// List of paths to process, subfolders are getting added to this list
-	List<String> folderQueue;
+static uint64 GetLastWriteTime(const struct stat& sb)
+{
+	return sb.st_mtim.tv_sec * (uint64)1000000000L + sb.st_mtim.tv_nsec;
+}
 
-	// Add / to the end
-	folderQueue.AddBack(rootFolder);
+// Scans the entries of a single folder, subfolders to scan next are added to 'subFolders'
+static void ScanFolder(ScanState& state, const String& folder, Vector<FileInfo>& out, Vector<String>& subFolders)
+{
+	int dirFd = open(*folder, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if(dirFd < 0)
+		return;
+	DIR* dir = fdopendir(dirFd);
+	if(dir == nullptr)
+	{
+		close(dirFd);
+		return;
+	}
 
-	bool filterByExtension = !extFilter.empty();
-	extFilter.TrimFront('.'); // Remove possible leading dot
-							  // Recursive folder search
-	while(!folderQueue.empty() && (!interrupt || !*interrupt))
+	while(dirent* ent = readdir(dir))
 	{
-		String searchPath = folderQueue.front();
-		folderQueue.pop_front();
+		if(state.IsInterrupted())
+			break;
 
-		DIR* dir = opendir(*searchPath);
-		if(dir == nullptr)
+		const char* name = ent->d_name;
+		if(name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0)))
 			continue;
 
-		// Open first entry
-		dirent* ent = readdir(dir);
-		if(ent)
+		// The entry type is usually known without having to stat the file
+		struct stat sb;
+		bool hasStat = false;
+		uint8 type = ent->d_type;
+		if(type == DT_UNKNOWN)
+		{
+			if(fstatat(dirFd, name, &sb, AT_SYMLINK_NOFOLLOW) != 0)
+				continue;
+			hasStat = true;
+			type = S_ISDIR(sb.st_mode) ? DT_DIR : (S_ISLNK(sb.st_mode) ? DT_LNK : DT_REG);
+		}
+
+		if(type == DT_DIR)
 		{
-			// Keep scanning files in this folder
-			do
+			if(state.recurse)
 			{
-                String filename = ent->d_name;
-
-                /// TODO: Ask linux why
-                if(filename == ".")
-                    continue;
-                if(filename == "..")
-                    continue;
-
-				FileInfo info;
-                info.fullPath = Path::Normalize(searchPath + Path::sep + filename);
-				info.lastWriteTime = File::GetLastWriteTime(info.fullPath); // linux doesn't provide this timestamp in the directory entry
-				info.type = FileType::Regular;
-
-				if(ent->d_type == DT_DIR)
-				{
-					if(recurse)
-					{
-						// Visit sub-folder
-						folderQueue.AddBack(info.fullPath);
-					}
-					else if(!filterByExtension)
-					{
-                        info.type = FileType::Folder;
-                        ret.Add(info);
-					}
-				}
-				else
-				{
-					// Check file
-					if(filterByExtension)
-					{
-						String ext = Path::GetExtension(info.fullPath);
-						if(ext == extFilter)
-						{
-							ret.Add(info);
-						}
-					}
-					else
-					{
-						ret.Add(info);
-					}
-				}
-			} while((ent = readdir(dir)) && (!interrupt || !*interrupt));
+				// Visit sub-folder
+				subFolders.Add(folder + Path::sep + name);
+				continue;
+			}
+			if(state.filterByExtension)
+				continue;
+		}
+		else if(state.filterByExtension)
+		{
+			// Check the extension before anything else is done with the file
+			const char* ext = strrchr(name, '.');
+			if(ext == nullptr || state.extFilter != (ext + 1))
+				continue;
 		}
 
-		closedir(dir);
+		FileInfo& info = out.Add();
+		info.fullPath = folder + Path::sep + name;
+		info.type = (type == DT_DIR) ? FileType::Folder : FileType::Regular;
+		if(type == DT_LNK)
+		{
+			// Links are resolved to the file they point to
+			info.fullPath = Path::Normalize(info.fullPath);
+			hasStat = false;
+		}
+		if(!hasStat && fstatat(dirFd, name, &sb, 0) != 0)
+			info.lastWriteTime = 0;
+		else
+			info.lastWriteTime = GetLastWriteTime(sb);
 	}
 
-	return move(ret);
+	closedir(dir);
+}
+
+// Scans folders from the queue until all folders are scanned
+static void ScanWorker(ScanState& state, uint32 threadIndex)
+{
+	Vector<FileInfo>& out = state.results[threadIndex];
+	Vector<String> subFolders;
+
+	std::unique_lock<Mutex> lock(state.lock);
+	while(true)
+	{
+		while(state.folderQueue.empty() && state.pendingFolders > 0)
+			state.folderAdded.wait(lock);
+		if(state.folderQueue.empty())
+			break; // All folders scanned
+
+		String folder = std::move(state.folderQueue.back());
+		state.folderQueue.pop_back();
+		lock.unlock();
+
+		subFolders.clear();
+		if(!state.IsInterrupted())
+			ScanFolder(state, folder, out, subFolders);
+
+		lock.lock();
+		for(String& subFolder : subFolders)
+			state.folderQueue.Add(std::move(subFolder));
+		state.pendingFolders += subFolders.size();
+		state.pendingFolders--;
+		if(!subFolders.empty() || state.pendingFolders == 0)
+			state.folderAdded.notify_all();
+	}
+}
+
+static Vector<FileInfo> _ScanFiles(String rootFolder, String extFilter, bool recurse, bool* interrupt)
+{
+	Vector<FileInfo> ret;
+	if(!Path::IsDirectory(rootFolder))
+	{
+		Logf("Can't run ScanFiles, \"%s\" is not a folder", Logger::Warning, rootFolder);
+		return ret;
+	}
+
+	ScanState state;
+	extFilter.TrimFront('.'); // Remove possible leading dot
+	state.extFilter = extFilter;
+	state.filterByExtension = !extFilter.empty();
+	state.recurse = recurse;
+	state.interrupt = interrupt;
+
+	// Only the root folder needs to be resolved, all other paths are built from it
+	state.folderQueue.Add(Path::Normalize(rootFolder));
+	state.pendingFolders = 1;
+
+	// Subfolders are scanned in parallel
+	uint32 numThreads = 1;
+	if(recurse)
+		numThreads = Math::Clamp(std::thread::hardware_concurrency(), 1u, maxScanThreads);
+	state.results.resize(numThreads);
+
+	Vector<Thread> threads;
+	for(uint32 i = 1; i < numThreads; i++)
+		threads.emplace_back(ScanWorker, std::ref(state), i);
+	ScanWorker(state, 0);
+	for(Thread& thread : threads)
+		thread.join();
+
+	// Combine the results into a single array
+	size_t numFiles = 0;
+	for(auto& files : state.results)
+		numFiles += files.size();
+	ret.reserve(numFiles);
+	for(auto& files : state.results)
+		std::move(files.begin(), files.end(), std::back_inserter(ret));
+
+	return ret;
 }
 
 Vector<FileInfo> Files::ScanFiles(const String& folder, String extFilter, bool* interrupt)
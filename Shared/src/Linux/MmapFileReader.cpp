@@ -0,0 +1,79 @@
+#include "stdafx.h"
+#include "MmapFileReader.hpp"
+#include "Log.hpp"
+
+/*
+	Linux implementation
+*/
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+class MmapFileReader_Impl
+{
+public:
+	MmapFileReader_Impl(int h) : handle(h) {};
+	~MmapFileReader_Impl()
+	{
+		if(mapping)
+			munmap(mapping, size);
+		close(handle);
+	}
+	int handle;
+	void* mapping = nullptr;
+	size_t size = 0;
+};
+
+bool MmapFileReader::Open(const String& path)
+{
+	Close();
+
+	int handle = open(*path, O_RDONLY);
+	if(handle == -1)
+	{
+		Logf("Failed to open file for reading %s: %d", Logger::Warning, *path, errno);
+		return false;
+	}
+	MmapFileReader_Impl* impl = new MmapFileReader_Impl(handle);
+
+	struct stat sb;
+	if(fstat(handle, &sb) != 0)
+	{
+		Logf("Failed to get the size of file %s: %d", Logger::Warning, *path, errno);
+		delete impl;
+		return false;
+	}
+	impl->size = sb.st_size;
+
+	// Empty files can't be mapped
+	if(impl->size > 0)
+	{
+		void* mapping = mmap(nullptr, impl->size, PROT_READ, MAP_PRIVATE, handle, 0);
+		if(mapping == MAP_FAILED)
+		{
+			Logf("Failed to map file %s: %d", Logger::Warning, *path, errno);
+			delete impl;
+			return false;
+		}
+		impl->mapping = mapping;
+		madvise(mapping, impl->size, MADV_SEQUENTIAL);
+	}
+
+	m_impl = impl;
+	m_data = (const uint8*)impl->mapping;
+	m_size = impl->size;
+	m_position = 0;
+	return true;
+}
+void MmapFileReader::Close()
+{
+	if(m_impl)
+	{
+		delete m_impl;
+		m_impl = nullptr;
+	}
+	m_data = nullptr;
+	m_size = 0;
+	m_position = 0;
+}
@@ -4,6 +4,7 @@
 #include "File.hpp"
 #include "FileStream.hpp"
 #include "TextStream.hpp"
+#include "Thread.hpp"
 #include <ctime>
 #include <map>
 
@@ -62,6 +63,8 @@ public:
 	HANDLE consoleHandle;
 #endif
 	String moduleName;
+	// Messages can be logged from any thread, a message and its header and color are written together
+	Mutex lock;
 };
 
 Logger::Logger()
@@ -82,6 +85,11 @@ Logger& Logger::Get()
 	return logger;
 }
 void Logger::SetColor(Color color)
+{
+	std::lock_guard<Mutex> guard(m_impl->lock);
+	m_SetColor(color);
+}
+void Logger::m_SetColor(Color color)
 {
 #ifdef _WIN32
 	if(m_impl->consoleHandle)
@@ -117,19 +125,20 @@ void Logger::SetColor(Color color)
 }
 void Logger::Log(const String& msg, Logger::Severity severity)
 {
+	std::lock_guard<Mutex> guard(m_impl->lock);
 	switch(severity)
 	{
 	case Normal:
-		SetColor(White);
+		m_SetColor(White);
 		break;
 	case Info:
-		SetColor(Gray);
+		m_SetColor(Gray);
 		break;
 	case Warning:
-		SetColor(Yellow);
+		m_SetColor(Yellow);
 		break;
 	case Error:
-		SetColor(Red);
+		m_SetColor(Red);
 		break;
 	}
 
@@ -139,10 +148,12 @@ void Logger::Log(const String& msg, Logger::Severity severity)
 }
 void Logger::WriteHeader(Severity severity)
 {
+	std::lock_guard<Mutex> guard(m_impl->lock);
 	m_impl->WriteHeader(severity);
 }
 void Logger::Write(const String& msg)
 {
+	std::lock_guard<Mutex> guard(m_impl->lock);
 	m_impl->Write(msg);
 }
 void Log(const String& msg, Logger::Severity severity)
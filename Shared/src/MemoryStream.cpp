@@ -1,9 +1,9 @@
 #include "stdafx.h"
 #include "MemoryStream.hpp"
-#include <algorithm>
 
-MemoryStreamBase::MemoryStreamBase(Buffer& buffer, bool isReading) : BinaryStream(isReading), m_buffer(&buffer)
+MemoryStreamBase::MemoryStreamBase(Buffer& buffer, bool isReading) : BinaryStream(isReading)
 {
+	m_buffer = &buffer;
 }
 void MemoryStreamBase::Seek(size_t pos)
 {
@@ -28,19 +28,7 @@ MemoryReader::MemoryReader(Buffer& buffer) : MemoryStreamBase(buffer, true)
 size_t MemoryReader::Serialize(void* data, size_t len)
 {
 	assert(m_buffer);
-	size_t endPos = m_cursor + len;
-	if(endPos > m_buffer->size())
-	{
-		if(m_cursor >= m_buffer->size())
-			return 0;
-		len = m_buffer->size() - m_cursor;
-	}
-	if(len > 0)
-	{
-		memcpy(data, &(*m_buffer)[m_cursor], len);
-		m_cursor += len;
-	}
-	return len;
+	return SerializeBytes(data, len);
 }
 
 MemoryWriter::MemoryWriter(Buffer& buffer) : MemoryStreamBase(buffer, false)
@@ -48,16 +36,6 @@ MemoryWriter::MemoryWriter(Buffer& buffer) : MemoryStreamBase(buffer, false)
 }
 size_t MemoryWriter::Serialize(void* data, size_t len)
 {
-	if(len == 0)
-		return 0;
 	assert(m_buffer);
-	size_t newSize = std::max(m_buffer->size(), m_cursor + len);
-	// Reserve space for new data
-	if(newSize > m_buffer->size())
-	{
-		m_buffer->resize(newSize);
-	}
-	memcpy(&(*m_buffer)[m_cursor], data, len);
-	m_cursor += len;
-	return len;
+	return SerializeBytes(data, len);
 }
@@ -0,0 +1,42 @@
+#include "stdafx.h"
+#include "MmapFileReader.hpp"
+#include "Math.hpp"
+
+MmapFileReader::MmapFileReader() : BinaryStream(true)
+{
+}
+MmapFileReader::~MmapFileReader()
+{
+	Close();
+}
+bool MmapFileReader::IsOpen() const
+{
+	return m_impl != nullptr;
+}
+const uint8* MmapFileReader::GetData() const
+{
+	return m_data;
+}
+
+size_t MmapFileReader::Serialize(void* data, size_t len)
+{
+	if(m_position >= m_size)
+		return 0;
+	len = Math::Min(len, m_size - m_position);
+	memcpy(data, m_data + m_position, len);
+	m_position += len;
+	return len;
+}
+void MmapFileReader::Seek(size_t pos)
+{
+	assert(pos <= m_size);
+	m_position = pos;
+}
+size_t MmapFileReader::Tell() const
+{
+	return m_position;
+}
+size_t MmapFileReader::GetSize() const
+{
+	return m_size;
+}
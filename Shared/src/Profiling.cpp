@@ -0,0 +1,264 @@
+#include "stdafx.h"
+#include "Profiling.hpp"
+#include "Thread.hpp"
+#include "File.hpp"
+#include "Math.hpp"
+#include <chrono>
+
+std::atomic<bool> ProfilerInternal::enabled(false);
+
+// Number of events kept for every thread
+static const uint64 eventBufferSize = 1 << 16;
+
+// Start or end of a zone, end events have no name
+//	the fields are atomic since they are read while the thread might overwrite them
+struct ProfilerEvent
+{
+	std::atomic<const char*> name;
+	std::atomic<uint64> time;
+};
+
+struct ProfilerThread
+{
+	uint32 id;
+	std::atomic<const char*> name;
+	ProfilerEvent events[eventBufferSize];
+	// Total number of events written, the next event is written at this index in the ring buffer
+	std::atomic<uint64> numEvents;
+
+	ProfilerThread(uint32 id, const char* name) : id(id), name(name), numEvents(0)
+	{
+	}
+	void Add(const char* eventName, uint64 time)
+	{
+		uint64 index = numEvents.load(std::memory_order_relaxed);
+		ProfilerEvent& event = events[index % eventBufferSize];
+		event.name.store(eventName, std::memory_order_relaxed);
+		event.time.store(time, std::memory_order_relaxed);
+		numEvents.store(index + 1, std::memory_order_release);
+	}
+	// Copies the events that are still in the ring buffer, oldest first
+	void Read(Vector<std::pair<const char*, uint64>>& out) const
+	{
+		uint64 end = numEvents.load(std::memory_order_acquire);
+		uint64 begin = end > eventBufferSize ? end - eventBufferSize : 0;
+		out.clear();
+		out.reserve(end - begin);
+		for(uint64 i = begin; i < end; i++)
+		{
+			const ProfilerEvent& event = events[i % eventBufferSize];
+			out.emplace_back(event.name.load(std::memory_order_relaxed), event.time.load(std::memory_order_relaxed));
+		}
+
+		// Drop the events that the thread overwrote while copying
+		std::atomic_thread_fence(std::memory_order_acquire);
+		uint64 newEnd = numEvents.load(std::memory_order_relaxed);
+		if(newEnd > eventBufferSize && newEnd - eventBufferSize > begin)
+		{
+			size_t numOverwritten = (size_t)Math::Min(newEnd - eventBufferSize - begin, end - begin);
+			out.erase(out.begin(), out.begin() + numOverwritten);
+		}
+	}
+};
+
+typedef std::chrono::steady_clock ProfilerClock;
+static ProfilerClock::time_point startTime = ProfilerClock::now();
+
+// Nanoseconds since the program started
+static uint64 GetTime()
+{
+	return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(ProfilerClock::now() - startTime).count();
+}
+
+// All threads that recorded events, these are kept until the program exits so the events can still be exported
+static Mutex threadsLock;
+static Vector<ProfilerThread*> threads;
+static thread_local ProfilerThread* currentThread = nullptr;
+static thread_local const char* currentThreadName = nullptr;
+
+// Start time of the current and last frame
+static Mutex frameLock;
+static uint64 frameStart = 0;
+static uint64 lastFrameStart = 0;
+
+static ProfilerThread* GetCurrentThread()
+{
+	if(!currentThread)
+	{
+		std::lock_guard<Mutex> lock(threadsLock);
+		currentThread = threads.Add(new ProfilerThread((uint32)threads.size(), currentThreadName ? currentThreadName : "Thread"));
+	}
+	return currentThread;
+}
+
+void Profiler::SetEnabled(bool enabled)
+{
+	ProfilerInternal::enabled = enabled;
+}
+bool Profiler::IsEnabled()
+{
+	return ProfilerInternal::enabled;
+}
+void Profiler::SetThreadName(const char* name)
+{
+	currentThreadName = name;
+	if(currentThread)
+		currentThread->name = name;
+}
+
+void Profiler::BeginZone(const char* name)
+{
+	GetCurrentThread()->Add(name, GetTime());
+}
+void Profiler::EndZone()
+{
+	GetCurrentThread()->Add(nullptr, GetTime());
+}
+
+void Profiler::BeginFrame()
+{
+	std::lock_guard<Mutex> lock(frameLock);
+	lastFrameStart = frameStart;
+	frameStart = GetTime();
+}
+
+static Vector<ProfilerThread*> GetThreads()
+{
+	std::lock_guard<Mutex> lock(threadsLock);
+	return threads;
+}
+
+Profiler::FrameStats Profiler::GetLastFrame()
+{
+	FrameStats stats;
+	frameLock.lock();
+	uint64 begin = lastFrameStart;
+	uint64 end = frameStart;
+	frameLock.unlock();
+	if(begin == end)
+		return stats;
+	stats.duration = (double)(end - begin) / 1e6;
+
+	Vector<std::pair<const char*, uint64>> events;
+	Vector<std::pair<const char*, uint64>> openZones;
+	for(ProfilerThread* thread : GetThreads())
+	{
+		thread->Read(events);
+
+		// Match up zones that ended during the frame, the time before the start of the frame is not counted
+		ThreadStats threadStats;
+		threadStats.name = thread->name;
+		openZones.clear();
+		for(auto& event : events)
+		{
+			if(event.second >= end)
+				break;
+			if(event.first)
+			{
+				openZones.Add(event);
+				continue;
+			}
+			if(openZones.empty())
+				continue;
+
+			std::pair<const char*, uint64> zone = openZones.back();
+			openZones.pop_back();
+			if(event.second < begin)
+				continue;
+
+			uint32 depth = (uint32)openZones.size();
+			double time = (double)(event.second - Math::Max(zone.second, begin)) / 1e6;
+			ZoneStats* zoneStats = nullptr;
+			for(ZoneStats& existing : threadStats.zones)
+			{
+				if(existing.name == zone.first && existing.depth == depth)
+				{
+					zoneStats = &existing;
+					break;
+				}
+			}
+			if(!zoneStats)
+			{
+				zoneStats = &threadStats.zones.Add();
+				zoneStats->name = zone.first;
+				zoneStats->depth = depth;
+				zoneStats->count = 0;
+				zoneStats->time = 0.0;
+			}
+			zoneStats->count++;
+			zoneStats->time += time;
+		}
+		if(!threadStats.zones.empty())
+			stats.threads.Add(std::move(threadStats));
+	}
+	return stats;
+}
+
+// Escapes a string for use in json
+static String EscapeJson(const char* str)
+{
+	String ret;
+	for(; *str; str++)
+	{
+		if(*str == '"' || *str == '\\')
+			ret += '\\';
+		ret += *str;
+	}
+	return ret;
+}
+
+bool Profiler::ExportChromeTrace(const String& path)
+{
+	File file;
+	if(!file.OpenWrite(path))
+	{
+		Logf("Failed to open trace file for writing: %s", Logger::Error, path);
+		return false;
+	}
+
+	String json = "{\"traceEvents\":[\n";
+	bool first = true;
+	auto AddEvent = [&](const String& event)
+	{
+		if(!first)
+			json += ",\n";
+		json += event;
+		first = false;
+	};
+
+	size_t numEvents = 0;
+	Vector<std::pair<const char*, uint64>> events;
+	Vector<const char*> openZones;
+	for(ProfilerThread* thread : GetThreads())
+	{
+		AddEvent(Utility::Sprintf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+			thread->id, EscapeJson(thread->name)));
+
+		// End events of zones that started before the oldest event are skipped
+		thread->Read(events);
+		openZones.clear();
+		for(auto& event : events)
+		{
+			const char* name = event.first;
+			if(!name)
+			{
+				if(openZones.empty())
+					continue;
+				name = openZones.back();
+				openZones.pop_back();
+			}
+			else
+			{
+				openZones.Add(name);
+			}
+			AddEvent(Utility::Sprintf("{\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":0,\"tid\":%d}",
+				EscapeJson(name), event.first ? "B" : "E", (double)event.second / 1000.0, thread->id));
+			numEvents++;
+		}
+	}
+	json += "\n]}\n";
+
+	file.Write(json.data(), json.size());
+	Logf("Exported %d profiler events to %s", Logger::Info, (int32)numEvents, path);
+	return true;
+}
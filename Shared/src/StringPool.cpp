@@ -0,0 +1,105 @@
+#include "stdafx.h"
+#include "StringPool.hpp"
+#include "Math.hpp"
+
+// Size of the blocks strings are stored in, longer strings get a block of their own
+static const size_t blockSize = 64 * 1024;
+
+// FNV-1a
+static uint32 HashString(const char* str, size_t length)
+{
+	uint32 hash = 2166136261u;
+	for(size_t i = 0; i < length; i++)
+	{
+		hash ^= (uint8)str[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+StringPool::~StringPool()
+{
+	for(char* block : m_blocks)
+		delete[] block;
+}
+const char* StringPool::Add(const char* str, size_t length)
+{
+	uint32 hash = HashString(str, length);
+
+	std::lock_guard<Mutex> lock(m_lock);
+	// Keep the table at most half full
+	if((m_numStrings + 1) * 2 > m_table.size())
+		m_GrowTable();
+
+	size_t mask = m_table.size() - 1;
+	size_t slot = hash & mask;
+	while(m_table[slot].str)
+	{
+		const Entry& entry = m_table[slot];
+		if(entry.hash == hash && entry.length == length && memcmp(entry.str, str, length) == 0)
+			return entry.str;
+		slot = (slot + 1) & mask;
+	}
+
+	char* pooled = m_Allocate(length + 1);
+	memcpy(pooled, str, length);
+	pooled[length] = 0;
+
+	Entry& entry = m_table[slot];
+	entry.str = pooled;
+	entry.hash = hash;
+	entry.length = (uint32)length;
+	m_numStrings++;
+	return pooled;
+}
+const char* StringPool::Add(const String& str)
+{
+	return Add(str.c_str(), str.size());
+}
+size_t StringPool::GetNumStrings() const
+{
+	std::lock_guard<Mutex> lock(m_lock);
+	return m_numStrings;
+}
+size_t StringPool::GetMemoryUsage() const
+{
+	std::lock_guard<Mutex> lock(m_lock);
+	return m_blockMemory + m_table.capacity() * sizeof(Entry) + m_blocks.capacity() * sizeof(char*);
+}
+
+char* StringPool::m_Allocate(size_t length)
+{
+	if(length > blockSize / 4)
+	{
+		// Long strings are stored separately, placed before the current block so its remaining space can still be used
+		char* block = new char[length];
+		m_blocks.insert(m_blocks.end() - (m_blocks.empty() ? 0 : 1), block);
+		m_blockMemory += length;
+		return block;
+	}
+	if(length > m_blockSpace)
+	{
+		m_blocks.Add(new char[blockSize]);
+		m_blockSpace = blockSize;
+		m_blockMemory += blockSize;
+	}
+	char* result = m_blocks.back() + (blockSize - m_blockSpace);
+	m_blockSpace -= length;
+	return result;
+}
+void StringPool::m_GrowTable()
+{
+	Vector<Entry> oldTable = std::move(m_table);
+	m_table = Vector<Entry>(Math::Max<size_t>(oldTable.size() * 2, 256), Entry{ nullptr, 0, 0 });
+
+	size_t mask = m_table.size() - 1;
+	for(const Entry& entry : oldTable)
+	{
+		if(!entry.str)
+			continue;
+		size_t slot = entry.hash & mask;
+		while(m_table[slot].str)
+			slot = (slot + 1) & mask;
+		m_table[slot] = entry;
+	}
+}
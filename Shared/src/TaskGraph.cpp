@@ -0,0 +1,220 @@
+#include "stdafx.h"
+#include "TaskGraph.hpp"
+#include "Math.hpp"
+#include <thread>
+
+// Job that runs a single task of a task graph on a job thread
+class TaskJob : public JobBase
+{
+public:
+	TaskJob(TaskGraph* graph, TaskGraph::Task task) : m_graph(graph), m_task(task)
+	{
+	}
+	virtual bool Run()
+	{
+		m_graph->m_RunTask(m_task);
+		return true;
+	}
+
+private:
+	TaskGraph* m_graph;
+	TaskGraph::Task m_task;
+};
+
+TaskGraph::TaskGraph(JobSheduler& sheduler) : m_sheduler(sheduler)
+{
+}
+TaskGraph::~TaskGraph()
+{
+	if(m_started)
+	{
+		Cancel();
+		Wait();
+	}
+	for(TaskState* task : m_tasks)
+		delete task;
+}
+TaskGraph::Task TaskGraph::m_Add(Job function, std::initializer_list<Task> dependencies, JobPriority priority, bool mainThread)
+{
+	assert(!m_started);
+
+	Task task = (Task)m_tasks.size();
+	TaskState* state = m_tasks.Add(new TaskState());
+	state->function = function;
+	state->numWaiting = (uint32)dependencies.size();
+	state->priority = priority;
+	state->mainThread = mainThread;
+	for(Task dependency : dependencies)
+	{
+		assert(dependency < task);
+		m_tasks[dependency]->dependents.Add(task);
+	}
+	return task;
+}
+void TaskGraph::Start()
+{
+	assert(!m_started);
+	m_started = true;
+
+	m_lock.lock();
+	m_numRemaining = (uint32)m_tasks.size();
+	m_lock.unlock();
+
+	for(Task task = 0; task < m_tasks.size(); task++)
+	{
+		if(m_tasks[task]->numWaiting == 0)
+			m_Ready(task);
+	}
+}
+bool TaskGraph::Update()
+{
+	m_RunMainThreadTasks();
+	return IsFinished();
+}
+bool TaskGraph::Wait()
+{
+	while(true)
+	{
+		m_RunMainThreadTasks();
+
+		std::unique_lock<Mutex> lock(m_lock);
+		m_taskFinished.wait(lock, [&]() { return m_numRemaining == 0 || !m_mainThreadTasks.empty(); });
+		if(m_numRemaining == 0)
+			break;
+	}
+	return IsSuccessfull();
+}
+void TaskGraph::Cancel()
+{
+	m_cancellation.Cancel();
+}
+bool TaskGraph::IsFinished() const
+{
+	std::lock_guard<Mutex> lock(m_lock);
+	return m_started && m_numRemaining == 0;
+}
+bool TaskGraph::IsSuccessfull() const
+{
+	return IsFinished() && !m_cancellation.IsCancelled();
+}
+
+void TaskGraph::m_Ready(Task task)
+{
+	TaskState* state = m_tasks[task];
+	if(state->mainThread)
+	{
+		std::lock_guard<Mutex> lock(m_lock);
+		m_mainThreadTasks.Add(task);
+		m_taskFinished.notify_all();
+		return;
+	}
+
+	Job job = Job(new TaskJob(this, task));
+	job->priority = state->priority;
+	m_sheduler.Queue(job);
+}
+void TaskGraph::m_RunTask(Task task)
+{
+	TaskState* state = m_tasks[task];
+
+	// Failed tasks cancel the graph, tasks are still finished when canceled so the graph finishes
+	if(!m_cancellation.IsCancelled() && !state->function->Run())
+		Cancel();
+	state->function.Release();
+
+	for(Task dependent : state->dependents)
+	{
+		if(--m_tasks[dependent]->numWaiting == 0)
+			m_Ready(dependent);
+	}
+
+	// Notified while holding the lock, the graph can be destroyed as soon as it is released
+	std::lock_guard<Mutex> lock(m_lock);
+	m_numRemaining--;
+	m_taskFinished.notify_all();
+}
+bool TaskGraph::m_RunMainThreadTasks()
+{
+	m_lock.lock();
+	Vector<Task> tasks = std::move(m_mainThreadTasks);
+	m_mainThreadTasks.clear();
+	m_lock.unlock();
+
+	for(Task task : tasks)
+		m_RunTask(task);
+	return !tasks.empty();
+}
+
+// State shared by the threads processing the ranges of a parallel for
+struct ParallelForState
+{
+	size_t begin;
+	size_t end;
+	size_t grainSize;
+	ParallelForInternal::RangeFunction func;
+	void* context;
+	const CancellationToken* cancellation;
+	// Start of the next range that is not processed yet
+	std::atomic<size_t> next;
+	// Helper jobs that are queued or still processing ranges, the state can't be destroyed before this is 0
+	std::atomic<uint32> numHelpers;
+
+	void ProcessRanges()
+	{
+		while(!cancellation || !cancellation->IsCancelled())
+		{
+			size_t rangeBegin = next.fetch_add(grainSize);
+			if(rangeBegin >= end)
+				break;
+			func(context, rangeBegin, Math::Min(rangeBegin + grainSize, end));
+		}
+	}
+};
+
+void ParallelForInternal::Run(JobSheduler& sheduler, size_t begin, size_t end, size_t grainSize, RangeFunction func, void* context, const CancellationToken* cancellation)
+{
+	if(begin >= end)
+		return;
+	grainSize = Math::Max<size_t>(grainSize, 1);
+
+	ParallelForState state;
+	state.begin = begin;
+	state.end = end;
+	state.grainSize = grainSize;
+	state.func = func;
+	state.context = context;
+	state.cancellation = cancellation;
+	state.next = begin;
+	state.numHelpers = 0;
+
+	// One helper job per job thread, the calling thread processes ranges as well
+	size_t numRanges = (end - begin + grainSize - 1) / grainSize;
+	size_t numHelpers = Math::Min<size_t>(sheduler.GetNumThreads(), numRanges - 1);
+	Vector<Job> helpers;
+	for(size_t i = 0; i < numHelpers; i++)
+	{
+		Job helper = JobBase::CreateLambda([&state]()
+		{
+			state.ProcessRanges();
+			// Last use of the state by this helper
+			state.numHelpers--;
+			return true;
+		});
+		helper->priority = JobPriority::Interactive;
+		state.numHelpers++;
+		sheduler.Queue(helper);
+		helpers.Add(helper);
+	}
+
+	state.ProcessRanges();
+
+	// Helpers that didn't start yet are removed, this waits for the ones that are still processing a range
+	//	JobBase::Terminate can't be used since this can run on any thread while the main thread handles finished jobs
+	for(Job& helper : helpers)
+	{
+		if(sheduler.Dequeue(helper))
+			state.numHelpers--;
+	}
+	while(state.numHelpers > 0)
+		std::this_thread::yield();
+}
@@ -0,0 +1,11 @@
+#include "stdafx.h"
+#include "AsyncFileReader_Impl.hpp"
+
+/*
+	Windows implementation
+	files are always read on worker threads
+*/
+AsyncFileBackend* CreateIoUringBackend(AsyncReadSink& sink)
+{
+	return nullptr;
+}
@@ -0,0 +1,32 @@
+#include "stdafx.h"
+#include "FileWatcher.hpp"
+
+// Folder watching is not implemented on windows, users of this class fall back to polling the folders
+class FileWatcher_Impl
+{
+};
+
+FileWatcher::FileWatcher()
+{
+	m_impl = new FileWatcher_Impl();
+}
+FileWatcher::~FileWatcher()
+{
+	delete m_impl;
+}
+bool FileWatcher::Watch(const String& folder)
+{
+	return false;
+}
+void FileWatcher::Clear()
+{
+}
+bool FileWatcher::IsWatching() const
+{
+	return false;
+}
+Vector<String> FileWatcher::GetChanges(bool& overflow)
+{
+	overflow = false;
+	return Vector<String>();
+}
@@ -0,0 +1,78 @@
+#include "stdafx.h"
+#include "MmapFileReader.hpp"
+#include "Log.hpp"
+
+/*
+	Windows implementation
+*/
+class MmapFileReader_Impl
+{
+public:
+	MmapFileReader_Impl(HANDLE h) : handle(h) {};
+	~MmapFileReader_Impl()
+	{
+		if(view)
+			UnmapViewOfFile(view);
+		if(mapping)
+			CloseHandle(mapping);
+		CloseHandle(handle);
+	}
+	HANDLE handle;
+	HANDLE mapping = nullptr;
+	void* view = nullptr;
+	size_t size = 0;
+};
+
+bool MmapFileReader::Open(const String& path)
+{
+	Close();
+
+	WString wstringPath = Utility::ConvertToWString(path);
+	HANDLE h = CreateFileW(*wstringPath,
+		GENERIC_READ, // Desired Access
+		FILE_SHARE_READ,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_FLAG_SEQUENTIAL_SCAN, 0);
+	if(h == INVALID_HANDLE_VALUE)
+	{
+		Logf("Failed to open file for reading %s: %s", Logger::Warning, *path, Utility::WindowsFormatMessage(GetLastError()));
+		return false;
+	}
+	MmapFileReader_Impl* impl = new MmapFileReader_Impl(h);
+
+	LARGE_INTEGER size;
+	GetFileSizeEx(h, &size);
+	impl->size = (size_t)size.QuadPart;
+
+	// Empty files can't be mapped
+	if(impl->size > 0)
+	{
+		impl->mapping = CreateFileMappingW(h, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if(impl->mapping)
+			impl->view = MapViewOfFile(impl->mapping, FILE_MAP_READ, 0, 0, 0);
+		if(!impl->view)
+		{
+			Logf("Failed to map file %s: %s", Logger::Warning, *path, Utility::WindowsFormatMessage(GetLastError()));
+			delete impl;
+			return false;
+		}
+	}
+
+	m_impl = impl;
+	m_data = (const uint8*)impl->view;
+	m_size = impl->size;
+	m_position = 0;
+	return true;
+}
+void MmapFileReader::Close()
+{
+	if(m_impl)
+	{
+		delete m_impl;
+		m_impl = nullptr;
+	}
+	m_data = nullptr;
+	m_size = 0;
+	m_position = 0;
+}
@@ -2,6 +2,7 @@
 #include <Audio/Audio.hpp>
 #include <Beatmap/BeatmapPlayback.hpp>
 #include <Audio/DSP.hpp>
+#include <Shared/MemoryStream.hpp>
 #include "TestMusicPlayer.hpp"
 
 // Normal test map
@@ -19,6 +20,33 @@ Beatmap LoadTestBeatmap(const String& mapPath = testBeatmapPath)
 	TestEnsure(beatmap.Load(reader));
 	return std::move(beatmap);
 }
+// Loads a map through a BufferedFileReader, like the game does
+Beatmap LoadTestBeatmapBuffered(const String& mapPath = testBeatmapPath)
+{
+	Beatmap beatmap;
+	File file;
+	TestEnsure(file.OpenRead(mapPath));
+	BufferedFileReader reader(file);
+	TestEnsure(beatmap.Load(reader));
+	return std::move(beatmap);
+}
+
+// Generates a ksh map with a BPM change on every bar
+Beatmap GenerateBPMChangeBeatmap(uint32 numBPMChanges)
+{
+	String ksh = "title=BPM Changes\r\nt=120\r\no=0\r\n--\r\n";
+	for(uint32 i = 0; i < numBPMChanges; i++)
+	{
+		ksh += Utility::Sprintf("t=%d\r\n", 60 + (i * 37) % 300);
+		ksh += "1000|00|--\r\n0100|00|--\r\n0010|00|--\r\n0001|00|--\r\n--\r\n";
+	}
+
+	Beatmap beatmap;
+	Buffer buffer(*ksh);
+	MemoryReader reader(buffer);
+	TestEnsure(beatmap.Load(reader));
+	return std::move(beatmap);
+}
 
 Test("Beatmap.v160")
 {
@@ -49,6 +77,11 @@ Test("Beatmap.Loading")
 		settings.artist, settings.title, settings.effector, settings.illustrator);
 	Logf("Audio File: %s;%s(fx)", Logger::Info, settings.audioNoFX, settings.audioFX);
 	Logf("Jacket File: %s", Logger::Info, settings.jacketPath);
+
+	// Reading through a buffer gives the same map
+	Beatmap buffered = LoadTestBeatmapBuffered();
+	TestEnsure(buffered.GetLinearObjects().size() == beatmap.GetLinearObjects().size());
+	TestEnsure(buffered.GetMapSettings().title == settings.title);
 }
 
 // Test 4/4 single bpm map
@@ -338,3 +371,194 @@ Test("Beatmap.SingleFilter")
 	Player player(beatmap, mapRootPath);
 	player.Run();
 }
+
+// Time to view distance conversions on a map with many BPM changes
+Test("Beatmap.ViewDistanceBenchmark")
+{
+	Beatmap beatmap = GenerateBPMChangeBeatmap(1000);
+	const Vector<TimingPoint*>& timingPoints = beatmap.GetLinearTimingPoints();
+	const Vector<ObjectState*>& objects = beatmap.GetLinearObjects();
+	TestEnsure(timingPoints.size() == 1000);
+
+	BeatmapPlayback playback(beatmap);
+	TestEnsure(playback.Reset(0));
+
+	// Reference implementation that walks over every timing point
+	auto LinearViewDistance = [&](MapTime start, MapTime end)
+	{
+		double distance = 0.0;
+		for(size_t i = 0; i < timingPoints.size(); i++)
+		{
+			MapTime segmentStart = (i == 0) ? start : Math::Max(start, timingPoints[i]->time);
+			MapTime segmentEnd = (i + 1 == timingPoints.size()) ? end : Math::Min(end, timingPoints[i + 1]->time);
+			if(segmentEnd > segmentStart)
+				distance += (double)(segmentEnd - segmentStart) / timingPoints[i]->beatDuration;
+		}
+		return distance;
+	};
+	for(size_t i = 0; i + 7 < objects.size(); i += 97)
+	{
+		MapTime start = objects[i]->time;
+		MapTime duration = objects[i + 7]->time - start;
+		float distance = playback.DurationToViewDistanceAtTime(start, duration);
+		TestEnsure(fabs(distance - LinearViewDistance(start, start + duration)) < 0.001);
+		TestEnsure(playback.GetTimingPointAt(start)->time <= start);
+	}
+
+	// Simulate the track querying the next 100 objects every frame
+	const size_t objectsPerFrame = 100;
+	MapTime endTime = objects.back()->time;
+	size_t firstObject = 0;
+	uint32 numQueries = 0;
+	double checksum = 0.0;
+	Timer timer;
+	for(MapTime time = 0; time < endTime; time += 16)
+	{
+		playback.Update(time);
+		while(firstObject < objects.size() && objects[firstObject]->time < time)
+			firstObject++;
+		size_t lastObject = Math::Min(firstObject + objectsPerFrame, objects.size());
+		for(size_t i = firstObject; i < lastObject; i++)
+		{
+			checksum += playback.TimeToViewDistance(objects[i]->time);
+			numQueries++;
+		}
+	}
+	double elapsed = timer.SecondsAsDouble();
+	Logf("%d view distance queries over %d timing points in %.2f ms (%.1f ns/query, checksum %.1f)", Logger::Info,
+		numQueries, timingPoints.size(), elapsed * 1000.0, elapsed * 1e9 / numQueries, checksum);
+}
+
+// Seeking should result in the same active objects as playing up to the same point
+Test("Beatmap.Seek")
+{
+	// Alternating hold notes on BT-A with single notes on the other buttons
+	String ksh = "title=Seek\r\nt=120\r\no=0\r\n--\r\n";
+	for(uint32 i = 0; i < 500; i++)
+	{
+		const char* hold = (i % 3 == 2) ? "0" : "2";
+		ksh += Utility::Sprintf("%s100|00|--\r\n%s010|00|--\r\n%s001|00|--\r\n%s000|00|--\r\n--\r\n", hold, hold, hold, hold);
+	}
+	Beatmap beatmap;
+	Buffer buffer(*ksh);
+	MemoryReader reader(buffer);
+	TestEnsure(beatmap.Load(reader));
+	MapTime endTime = beatmap.GetLinearObjects().back()->time;
+
+	BeatmapPlayback playback(beatmap);
+	TestEnsure(playback.Reset(0));
+	BeatmapPlayback seekPlayback(beatmap);
+
+	uint32 numSeeks = 0;
+	double seekTime = 0.0;
+	MapTime nextSeek = 0;
+	for(MapTime time = 0; time < endTime; time += 16)
+	{
+		playback.Update(time);
+		if(time < nextSeek)
+			continue;
+		nextSeek += 997;
+
+		Timer timer;
+		TestEnsure(seekPlayback.Reset(time));
+		seekPlayback.Update(time);
+		seekTime += timer.SecondsAsDouble();
+		numSeeks++;
+
+		TestEnsure(seekPlayback.GetHittableObjects() == playback.GetHittableObjects());
+	}
+	Logf("%d seeks over %d objects, %.2f us/seek", Logger::Info,
+		numSeeks, beatmap.GetLinearObjects().size(), seekTime * 1e6 / numSeeks);
+}
+
+// Objects and events that pass during a single update are handled in chart order
+Test("Beatmap.UpdateOrder")
+{
+	// A filter gain change on every note, the gain increases with the time and starts at the initial gain of 1
+	String ksh = "title=Update Order\r\nt=120\r\no=0\r\n--\r\n";
+	for(uint32 i = 0; i < 200; i++)
+	{
+		ksh += Utility::Sprintf("pfiltergain=%d\r\n1000|00|--\r\n", 100 + i);
+		ksh += Utility::Sprintf("pfiltergain=%d\r\n0100|00|--\r\n", 101 + i);
+		ksh += "--\r\n";
+	}
+	Beatmap beatmap;
+	Buffer buffer(*ksh);
+	MemoryReader reader(buffer);
+	TestEnsure(beatmap.Load(reader));
+	MapTime endTime = beatmap.GetLinearObjects().back()->time;
+
+	BeatmapPlayback playback(beatmap);
+	TestEnsure(playback.Reset(0));
+	bool ordered = true;
+	float lastGain = -1.0f;
+	playback.OnEventChanged.AddLambda([&](EventKey key, EventData data)
+	{
+		if(key != EventKey::LaserEffectMix)
+			return;
+		ordered &= data.floatVal >= lastGain;
+		lastGain = data.floatVal;
+	});
+	MapTime lastLeaved = 0;
+	playback.OnObjectLeaved.AddLambda([&](ObjectState* obj)
+	{
+		ordered &= obj->time >= lastLeaved;
+		lastLeaved = obj->time;
+	});
+
+	// Large steps, so that many objects pass at once
+	for(MapTime time = 0; time < endTime + 5000; time += 3000)
+		playback.Update(time);
+	TestEnsure(ordered);
+	TestEnsure(lastGain == 3.0f);
+}
+
+// Saving and loading a chart with 5000 objects in the binary format
+Test("Beatmap.SerializeBenchmark")
+{
+	// Buttons, FX chips and holds on every line
+	String ksh = "title=Serialize\r\nartist=Test\r\nt=120\r\no=0\r\n--\r\n";
+	for(uint32 i = 0; i < 1000; i++)
+		ksh += "1000|00|--\r\n0100|00|--\r\n0010|10|--\r\n0002|00|--\r\n--\r\n";
+	Beatmap beatmap;
+	{
+		Buffer kshBuffer(*ksh);
+		MemoryReader reader(kshBuffer);
+		TestEnsure(beatmap.Load(reader));
+	}
+	size_t numObjects = beatmap.GetLinearObjects().size();
+	TestEnsure(numObjects >= 5000);
+
+	const int32 numIterations = 20;
+	Buffer buffer;
+	Timer timer;
+	for(int32 i = 0; i < numIterations; i++)
+	{
+		buffer.clear();
+		MemoryWriter writer(buffer);
+		TestEnsure(beatmap.Save(writer));
+	}
+	double saveTime = timer.SecondsAsDouble() * 1000.0 / numIterations;
+
+	timer.Restart();
+	for(int32 i = 0; i < numIterations; i++)
+	{
+		Beatmap loaded;
+		MemoryReader reader(buffer);
+		TestEnsure(loaded.Load(reader));
+		TestEnsure(loaded.GetLinearObjects().size() == numObjects);
+	}
+	double loadTime = timer.SecondsAsDouble() * 1000.0 / numIterations;
+
+	Logf("Binary chart with %d objects (%d bytes): save %.2f ms, load %.2f ms", Logger::Info,
+		(int32)numObjects, (int32)buffer.size(), saveTime, loadTime);
+
+	// A chart stored after other data is read from the current position of the stream
+	Buffer prefixed(16 + buffer.size());
+	memcpy(prefixed.data() + 16, buffer.data(), buffer.size());
+	MemoryReader prefixedReader(prefixed);
+	prefixedReader.Seek(16);
+	Beatmap loaded;
+	TestEnsure(loaded.Load(prefixedReader));
+	TestEnsure(loaded.GetLinearObjects().size() == numObjects);
+}
@@ -0,0 +1,484 @@
+#include "stdafx.h"
+#include <Beatmap/MapDatabase.hpp>
+#include <Beatmap/Database.hpp>
+#include <Beatmap/Beatmap.hpp>
+#include <thread>
+#include <chrono>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+// Returns the number of bytes allocated on the heap, or 0 if this is not available on the current platform
+static size_t GetHeapUsage()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+	return mallinfo2().uordblks;
+#else
+	return 0;
+#endif
+}
+
+// Creates a song folder containing the given amount of generated maps
+static void GenerateMapLibrary(const String& folder, uint32 numMaps)
+{
+	TestEnsure(Path::CreateDir(folder));
+	for(uint32 i = 0; i < numMaps; i++)
+	{
+		String mapFolder = folder + Path::sep + Utility::Sprintf("Map%d", i);
+		TestEnsure(Path::CreateDir(mapFolder));
+
+		String ksh = Utility::Sprintf("title=Generated Map %d\r\nartist=Artist %d\r\neffect=Effector\r\n"
+			"jacket=jacket.png\r\nillustrator=Illustrator\r\ndifficulty=challenge\r\nlevel=%d\r\n"
+			"t=%d\r\nm=music.ogg\r\no=0\r\n--\r\n", i, i % 100, 1 + i % 16, 100 + i % 100);
+		for(uint32 j = 0; j < 128; j++)
+		{
+			ksh += "1000|00|--\r\n0100|00|--\r\n0010|00|--\r\n0001|00|--\r\n--\r\n";
+		}
+
+		File file;
+		TestEnsure(file.OpenWrite(mapFolder + Path::sep + "chart.ksh"));
+		file.Write(*ksh, ksh.size());
+	}
+}
+
+// Measures how fast a newly generated library is added to the database
+Test("MapDatabase.ScanBenchmark")
+{
+	const uint32 numMaps = 2000;
+	String libraryPath = Path::Absolute(TestBasePath + Path::sep + "Library");
+	GenerateMapLibrary(libraryPath, numMaps);
+
+	Set<uint32> threadCounts = { 1, 4, Math::Max(1u, std::thread::hardware_concurrency()) };
+	for(uint32 numThreads : threadCounts)
+	{
+		String databasePath = TestBasePath + Path::sep + Utility::Sprintf("maps_%d.db", numThreads);
+		MapDatabase database(databasePath);
+		database.SetScanThreadCount(numThreads);
+		database.AddSearchPath(libraryPath);
+
+		size_t numAdded = 0;
+		database.OnMapsAdded.AddLambda([&](Vector<MapIndex*> maps)
+		{
+			numAdded += maps.size();
+		});
+
+		Timer timer;
+		double maxUpdateTime = 0.0;
+		database.StartSearching();
+		while(database.IsSearching())
+		{
+			// Time spent on the main thread per frame
+			Timer updateTimer;
+			database.Update();
+			maxUpdateTime = Math::Max(maxUpdateTime, updateTimer.SecondsAsDouble() * 1000.0);
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		database.Update();
+		double elapsed = timer.SecondsAsDouble();
+
+		TestEnsure(numAdded == numMaps);
+		Logf("Scanned %d maps with %d threads in %.2f s (%.0f maps/s), longest update took %.2f ms", Logger::Info,
+			numMaps, numThreads, elapsed, numMaps / elapsed, maxUpdateTime);
+	}
+}
+
+// Waits until a started search and all its changes are applied
+static double WaitForSearch(MapDatabase& database)
+{
+	Timer timer;
+	database.StartSearching();
+	while(database.IsLoading() || database.IsSearching())
+	{
+		database.Update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	database.Update();
+	return timer.SecondsAsDouble();
+}
+
+// Measures a rescan after all charts were touched, like when a library is restored from a backup
+Test("MapDatabase.TouchBenchmark")
+{
+	const uint32 numMaps = 2000;
+	String libraryPath = Path::Absolute(TestBasePath + Path::sep + "TouchedLibrary");
+	String databasePath = TestBasePath + Path::sep + "touched.db";
+	GenerateMapLibrary(libraryPath, numMaps);
+
+	Map<int32, uint64> hashes;
+	{
+		MapDatabase database(databasePath);
+		database.AddSearchPath(libraryPath);
+		double elapsed = WaitForSearch(database);
+		Logf("Scanned %d new maps in %.2f s", Logger::Info, numMaps, elapsed);
+		for(auto& map : database.GetMaps())
+		{
+			for(DifficultyIndex* diff : map.second->difficulties)
+				hashes.Add(diff->id, diff->hash);
+		}
+	}
+
+	// Write all charts again with the same contents, except for a single one
+	for(uint32 i = 0; i < numMaps; i++)
+	{
+		String chartPath = libraryPath + Path::sep + Utility::Sprintf("Map%d", i) + Path::sep + "chart.ksh";
+		File file;
+		TestEnsure(file.OpenRead(chartPath));
+		String ksh;
+		ksh.resize(file.GetSize());
+		file.Read(&ksh.front(), ksh.size());
+		file.Close();
+		if(i == 0)
+			ksh = ksh.substr(0, ksh.size() - 4) + "\r\n";
+		TestEnsure(file.OpenWrite(chartPath));
+		file.Write(*ksh, ksh.size());
+	}
+
+	MapDatabase database(databasePath);
+	database.AddSearchPath(libraryPath);
+	size_t numUpdated = 0;
+	database.OnMapsUpdated.AddLambda([&](Vector<MapIndex*> maps)
+	{
+		numUpdated += maps.size();
+	});
+	double elapsed = WaitForSearch(database);
+	Logf("Scanned %d touched maps in %.2f s", Logger::Info, numMaps, elapsed);
+
+	// Only the changed chart is read again, the others keep their hash
+	TestEnsure(numUpdated == 1);
+	size_t numChanged = 0;
+	for(auto& map : database.GetMaps())
+	{
+		for(DifficultyIndex* diff : map.second->difficulties)
+		{
+			if(diff->hash != hashes[diff->id])
+				numChanged++;
+		}
+	}
+	TestEnsure(numChanged == 1);
+}
+
+// Checks that changes to the song folder are picked up after the first scan
+Test("MapDatabase.Watch")
+{
+	String libraryPath = Path::Absolute(TestBasePath + Path::sep + "WatchedLibrary");
+	GenerateMapLibrary(libraryPath, 10);
+
+	MapDatabase database(TestBasePath + Path::sep + "watched.db");
+	database.AddSearchPath(libraryPath);
+	size_t numAdded = 0, numUpdated = 0, numRemoved = 0;
+	database.OnMapsAdded.AddLambda([&](Vector<MapIndex*> maps) { numAdded += maps.size(); });
+	database.OnMapsUpdated.AddLambda([&](Vector<MapIndex*> maps) { numUpdated += maps.size(); });
+	database.OnMapsRemoved.AddLambda([&](Vector<MapIndex*> maps) { numRemoved += maps.size(); });
+	WaitForSearch(database);
+	TestEnsure(numAdded == 10);
+	if(!database.IsWatching())
+	{
+		Logf("Song folders can't be watched on this platform", Logger::Warning);
+		return;
+	}
+
+	// Change a chart, remove one and add a new map
+	String chartPath = libraryPath + Path::sep + "Map0" + Path::sep + "chart.ksh";
+	File file;
+	TestEnsure(file.OpenRead(chartPath));
+	String ksh;
+	ksh.resize(file.GetSize());
+	file.Read(&ksh.front(), ksh.size());
+	file.Close();
+	ksh += "0000|00|--\r\n--\r\n";
+	TestEnsure(file.OpenWrite(chartPath));
+	file.Write(*ksh, ksh.size());
+	file.Close();
+	TestEnsure(Path::Delete(libraryPath + Path::sep + "Map1" + Path::sep + "chart.ksh"));
+	GenerateMapLibrary(libraryPath + Path::sep + "New", 1);
+
+	Timer timer;
+	while((numAdded < 11 || numUpdated < 1 || numRemoved < 1) && timer.SecondsAsFloat() < 10.0f)
+	{
+		database.Update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	TestEnsure(numAdded == 11 && numUpdated == 1 && numRemoved == 1);
+
+	// Removing the map that was just added needs the changes above to be known to the next check
+	TestEnsure(Path::Delete(libraryPath + Path::sep + "New" + Path::sep + "Map0" + Path::sep + "chart.ksh"));
+	timer.Restart();
+	while(numRemoved < 2 && timer.SecondsAsFloat() < 10.0f)
+	{
+		database.Update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	TestEnsure(numRemoved == 2 && database.GetMaps().size() == 9);
+}
+
+// Checks the analytics calculated while scanning and sorting by them in the database
+Test("MapDatabase.Analytics")
+{
+	const uint32 numMaps = 100;
+	String libraryPath = Path::Absolute(TestBasePath + Path::sep + "AnalyticsLibrary");
+	String databasePath = TestBasePath + Path::sep + "analytics.db";
+	GenerateMapLibrary(libraryPath, numMaps);
+	{
+		MapDatabase database(databasePath);
+		database.AddSearchPath(libraryPath);
+		WaitForSearch(database);
+
+		for(auto& map : database.GetMaps())
+		{
+			const BeatmapAnalytics& analytics = map.second->difficulties[0]->metadata.analytics;
+			TestEnsure(analytics.numButtons == 512 && analytics.GetNumNotes() == 512);
+			TestEnsure(analytics.minBPM == analytics.maxBPM && analytics.minBPM >= 100.0);
+
+			// One note per beat, with note times rounded to milliseconds
+			double beatDuration = 60000.0 / analytics.maxBPM;
+			TestEnsure(abs(analytics.maxNotesPerSecond - 1000.0 / beatDuration) <= 1.0);
+			TestEnsure(abs(analytics.duration - beatDuration * 511) <= 1.0);
+			uint32 numBinned = 0;
+			for(uint16 count : analytics.density)
+				numBinned += count;
+			TestEnsure(numBinned == 512);
+		}
+	}
+
+	// Sorting uses the index on the column
+	Database database;
+	TestEnsure(database.Open(databasePath));
+	DBStatement plan = database.Query("EXPLAIN QUERY PLAN SELECT path FROM Difficulties ORDER BY maxBPM DESC");
+	TestEnsure(plan.StepRow() && plan.StringColumn(3).find("DifficultiesByMaxBPM") != String::npos);
+	plan.Finish();
+	DBStatement fastest = database.Query("SELECT path,maxBPM FROM Difficulties WHERE numNotes >= 500 ORDER BY maxBPM DESC LIMIT 1");
+	TestEnsure(fastest.StepRow() && fastest.StringColumn(0).find("Map99") != String::npos && fastest.DoubleColumn(1) == 199.0);
+}
+
+// Creates a map database containing the given amount of maps, without any files on disk
+static void GenerateMapDatabase(const String& databasePath, int32 numMaps)
+{
+	{
+		// Creates the tables
+		MapDatabase mapDatabase(databasePath);
+	}
+
+	// Fill the database directly, scanning this many maps would take too long
+	Database database;
+	TestEnsure(database.Open(databasePath));
+	database.Exec("DROP TABLE IF EXISTS MapSearch");
+	DBStatement addMap = database.Query("INSERT INTO Maps(path,artist,title,tags,rowid) VALUES(?,?,?,?,?)");
+	DBStatement addDiff = database.Query("INSERT INTO Difficulties(path,lwt,hash,metadata,rowid,mapid) VALUES(?,?,?,?,?,?)");
+	database.Exec("BEGIN");
+	for(int32 i = 1; i <= numMaps; i++)
+	{
+		BeatmapSettings settings;
+		settings.title = Utility::Sprintf("Generated Map %d", i);
+		settings.artist = Utility::Sprintf("Artist%d", i % 1000);
+		settings.effector = Utility::Sprintf("Effector%d", i % 50);
+		settings.tags = (i % 10 == 0) ? "remix" : "original";
+
+		Buffer metadata;
+		MemoryWriter metadataWriter(metadata);
+		metadataWriter.SerializeObject(settings);
+
+		String path = Utility::Sprintf("/songs/Map%d", i);
+		addMap.BindString(1, path);
+		addMap.BindString(2, settings.artist);
+		addMap.BindString(3, settings.title);
+		addMap.BindString(4, settings.tags);
+		addMap.BindInt(5, i);
+		addMap.Step();
+		addMap.Rewind();
+
+		addDiff.BindString(1, path + "/chart.ksh");
+		addDiff.BindInt64(2, 0);
+		addDiff.BindInt64(3, i);
+		addDiff.BindBlob(4, metadata);
+		addDiff.BindInt(5, i);
+		addDiff.BindInt(6, i);
+		addDiff.Step();
+		addDiff.Rewind();
+	}
+	database.Exec("END");
+}
+
+// Measures how long it takes before the first maps and all maps are loaded from a large database
+Test("MapDatabase.LoadBenchmark")
+{
+	const int32 numMaps = 100000;
+	String databasePath = TestBasePath + Path::sep + "load.db";
+	GenerateMapDatabase(databasePath, numMaps);
+	{
+		// Builds the search index
+		MapDatabase mapDatabase(databasePath);
+	}
+
+	Timer timer;
+	MapDatabase mapDatabase(databasePath);
+	double constructed = timer.SecondsAsDouble() * 1000.0;
+
+	double firstPage = 0.0;
+	size_t numAdded = 0;
+	mapDatabase.OnMapsAdded.AddLambda([&](Vector<MapIndex*> maps)
+	{
+		if(numAdded == 0)
+			firstPage = timer.SecondsAsDouble() * 1000.0;
+		numAdded += maps.size();
+	});
+	while(mapDatabase.IsLoading())
+	{
+		mapDatabase.Update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	double loaded = timer.SecondsAsDouble() * 1000.0;
+	TestEnsure(numAdded == numMaps);
+	TestEnsure(mapDatabase.GetMapCount() == numMaps);
+
+	// Metadata is read when it is needed
+	MapIndex* map = mapDatabase.GetMap(numMaps / 2);
+	TestEnsure(map && !map->difficulties[0]->metadataLoaded);
+	mapDatabase.LoadMetadata(map);
+	TestEnsure(map->difficulties[0]->metadata.title == Utility::Sprintf("Generated Map %d", numMaps / 2));
+
+	Logf("Loading %d maps: constructed in %.1f ms, first page after %.1f ms, all maps after %.1f ms", Logger::Info,
+		numMaps, constructed, firstPage, loaded);
+}
+
+// Measures how many searches per second can be done in a large library
+Test("MapDatabase.SearchBenchmark")
+{
+	const int32 numMaps = 100000;
+	String databasePath = TestBasePath + Path::sep + "search.db";
+	GenerateMapDatabase(databasePath, numMaps);
+
+	Timer timer;
+	MapDatabase mapDatabase(databasePath);
+	while(mapDatabase.IsLoading())
+		mapDatabase.Update();
+	Logf("Loaded %d maps and built the search index in %.2f s", Logger::Info, numMaps, timer.SecondsAsDouble());
+
+	// Different searches with few and many results
+	Vector<String> searches = { "Artist999", "map 4242", "effector10 remix", "generated", "artist9 map 99" };
+	TestEnsure(mapDatabase.FindMaps("Artist999").size() == numMaps / 1000);
+	TestEnsure(mapDatabase.FindMaps("Effector10 remix").size() == numMaps / 50);
+
+	const uint32 numQueries = 20;
+	double elapsed;
+	for(const String& search : searches)
+	{
+		size_t numFound = 0;
+		timer.Restart();
+		for(uint32 i = 0; i < numQueries; i++)
+			numFound = mapDatabase.FindMaps(search).size();
+		elapsed = timer.SecondsAsDouble();
+		Logf("Full text search \"%s\" (%d results): %.0f queries/s", Logger::Info, search, (int32)numFound, numQueries / elapsed);
+	}
+
+	// Substring search, the way maps were searched before
+	{
+		Database database;
+		TestEnsure(database.Open(databasePath));
+		timer.Restart();
+		for(uint32 i = 0; i < numQueries; i++)
+		{
+			DBStatement search = database.Query("SELECT rowid FROM Maps WHERE (artist LIKE \"%Artist999%\" OR title LIKE \"%Artist999%\""
+				" OR path LIKE \"%Artist999%\" OR tags LIKE \"%Artist999%\")");
+			while(search.StepRow())
+			{
+			}
+		}
+		elapsed = timer.SecondsAsDouble();
+		Logf("LIKE search: %.0f queries/s", Logger::Info, numQueries / elapsed);
+	}
+
+	// Only the result of the last search is reported when typing quickly
+	size_t numResults = 0;
+	size_t numCallbacks = 0;
+	mapDatabase.OnFoundMaps.AddLambda([&](Map<int32, MapIndex*> maps)
+	{
+		numResults = maps.size();
+		numCallbacks++;
+	});
+	String typed = "Artist999";
+	for(size_t i = 1; i <= typed.size(); i++)
+		mapDatabase.FindMapsAsync(typed.substr(0, i));
+	while(mapDatabase.IsFindingMaps())
+	{
+		mapDatabase.Update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	TestEnsure(numCallbacks == 1);
+	TestEnsure(numResults == numMaps / 1000);
+}
+
+// Compares the memory used by the map index to storing the full metadata of every difficulty
+Test("MapDatabase.MemoryBenchmark")
+{
+	const int32 numMaps = 100000;
+	String databasePath = TestBasePath + Path::sep + "memory.db";
+	GenerateMapDatabase(databasePath, numMaps);
+	{
+		// Builds the search index
+		MapDatabase mapDatabase(databasePath);
+	}
+
+	// The way maps were stored before, every difficulty keeping its own copy of the paths and metadata
+	size_t heapStart = GetHeapUsage();
+	{
+		struct FullDifficulty
+		{
+			String path;
+			BeatmapSettings settings;
+		};
+		struct FullMap
+		{
+			String path;
+			Vector<FullDifficulty*> difficulties;
+		};
+		Map<int32, FullMap*> maps;
+		Map<int32, FullDifficulty*> difficulties;
+
+		Database database;
+		TestEnsure(database.Open(databasePath));
+		DBStatement diffScan = database.Query("SELECT rowid,path,metadata,mapid FROM Difficulties");
+		while(diffScan.StepRow())
+		{
+			FullDifficulty* diff = new FullDifficulty();
+			diff->path = diffScan.StringColumn(1);
+			Buffer metadata = diffScan.BlobColumn(2);
+			MemoryReader metadataReader(metadata);
+			metadataReader.SerializeObject(diff->settings);
+			difficulties.Add(diffScan.IntColumn(0), diff);
+
+			FullMap* map = new FullMap();
+			map->path = Path::RemoveLast(diff->path);
+			map->difficulties.Add(diff);
+			maps.Add(diffScan.IntColumn(3), map);
+		}
+		diffScan.Finish();
+		database.Close();
+
+		size_t fullSize = GetHeapUsage() - heapStart;
+		Logf("Full metadata of %d maps: %.1f MB", Logger::Info, numMaps, fullSize / (1024.0 * 1024.0));
+
+		for(auto& map : maps)
+			delete map.second;
+		for(auto& diff : difficulties)
+			delete diff.second;
+	}
+
+	heapStart = GetHeapUsage();
+	{
+		MapDatabase mapDatabase(databasePath);
+		while(mapDatabase.IsLoading())
+			mapDatabase.Update();
+		size_t indexSize = GetHeapUsage() - heapStart;
+		for(int32 i = 1; i <= numMaps; i++)
+			mapDatabase.LoadMetadata(mapDatabase.GetMap(i));
+		size_t metadataSize = GetHeapUsage() - heapStart;
+
+		MapIndex* map = mapDatabase.GetMap(numMaps);
+		TestEnsure(map->difficulties[0]->GetPath() == Utility::Sprintf("/songs/Map%d/chart.ksh", numMaps));
+		TestEnsure(map->difficulties[0]->metadata.effector == mapDatabase.GetMap(numMaps - 50)->difficulties[0]->metadata.effector);
+
+		// Besides the metadata this includes the analytics and content hash of every difficulty
+		Logf("Map index of %d maps: %.1f MB, %.1f MB with all metadata loaded (including database caches)", Logger::Info,
+			numMaps, indexSize / (1024.0 * 1024.0), metadataSize / (1024.0 * 1024.0));
+	}
+}
@@ -0,0 +1,46 @@
+#include <Shared/Shared.hpp>
+#include <Shared/AllocationTracker.hpp>
+#include <Tests/Tests.hpp>
+
+// Allocations are stored here so the compiler can't remove them
+static void* volatile allocation = nullptr;
+
+Test("AllocationTracker.Frame")
+{
+	AllocationTracker::SetEnabled(true);
+
+	// Allocations are counted for the innermost scope on this thread
+	AllocationTracker::BeginFrame();
+	{
+		AllocationScope scope(AllocationTag::Render);
+		for(int32 i = 0; i < 10; i++)
+		{
+			allocation = new int32(i);
+			delete (int32*)allocation;
+		}
+		{
+			AllocationScope inner(AllocationTag::GUI);
+			Vector<uint8> buffer(100);
+		}
+		allocation = new uint8[50];
+		delete[] (uint8*)allocation;
+	}
+	AllocationTracker::BeginFrame();
+
+	AllocationTracker::Counts render = AllocationTracker::GetLastFrame(AllocationTag::Render);
+	TestEnsure(render.numAllocations == 11 && render.numFrees == 11);
+	TestEnsure(render.bytesAllocated == 10 * sizeof(int32) + 50);
+	AllocationTracker::Counts gui = AllocationTracker::GetLastFrame(AllocationTag::GUI);
+	TestEnsure(gui.numAllocations == 1 && gui.bytesAllocated == 100);
+	TestEnsure(AllocationTracker::GetLastFrameTotal().numAllocations >= 12);
+
+	// Nothing is counted while disabled
+	AllocationTracker::SetEnabled(false);
+	{
+		AllocationScope scope(AllocationTag::Render);
+		allocation = new int32(0);
+		delete (int32*)allocation;
+	}
+	AllocationTracker::BeginFrame();
+	TestEnsure(AllocationTracker::GetLastFrame(AllocationTag::Render).numAllocations == 0);
+}
@@ -0,0 +1,174 @@
+#include <Shared/Shared.hpp>
+#include <Shared/AsyncFileReader.hpp>
+#include <Shared/File.hpp>
+#include <Shared/Thread.hpp>
+#include <Tests/Tests.hpp>
+#include <cfloat>
+
+static bool WriteTestFile(const String& path, size_t size, uint8 seed)
+{
+	File file;
+	if(!file.OpenWrite(path, false))
+		return false;
+	Buffer data;
+	data.resize(size);
+	for(size_t i = 0; i < size; i++)
+		data[i] = (uint8)(i * 7 + seed);
+	return file.Write(data.data(), data.size()) == data.size();
+}
+static bool CheckData(const Buffer& data, size_t offset, uint8 seed)
+{
+	for(size_t i = 0; i < data.size(); i++)
+	{
+		if(data[i] != (uint8)((i + offset) * 7 + seed))
+			return false;
+	}
+	return true;
+}
+
+// Reads whole files, parts of files and files that don't exist with one of the backends
+static void TestReads(TestContext& context, bool allowIoUring)
+{
+	const uint32 numFiles = 100;
+	Vector<String> paths;
+	for(uint32 i = 0; i < numFiles; i++)
+	{
+		String path = Path::Absolute(TestBasePath + Path::sep + Utility::Sprintf("async_read_%d.bin", i));
+		// Includes an empty file
+		TestEnsure(WriteTestFile(path, i * 1000, (uint8)i));
+		paths.Add(path);
+	}
+
+	AsyncFileReader reader(2, allowIoUring);
+	Logf("Async file reader using %s", Logger::Info, reader.IsUsingIoUring() ? "io_uring" : "threads");
+	std::thread::id mainThread = std::this_thread::get_id();
+	uint32 numCalled = 0;
+	bool valid = true;
+
+	Vector<AsyncReadRequest> requests;
+	for(uint32 i = 0; i < numFiles; i++)
+	{
+		requests.emplace_back(paths[i], [&, i](AsyncReadResult& result)
+		{
+			valid &= std::this_thread::get_id() == mainThread;
+			valid &= result.success && result.path == paths[i] && result.offset == 0;
+			valid &= result.data.size() == i * 1000;
+			valid &= CheckData(result.data, 0, (uint8)i);
+			numCalled++;
+		});
+	}
+	reader.Read(requests);
+	TestEnsure(requests.empty());
+
+	// Part of a file, a read past the end of the file and a file that doesn't exist
+	reader.Read(AsyncReadRequest(paths[10], [&](AsyncReadResult& result)
+	{
+		valid &= result.success && result.offset == 500 && result.data.size() == 200;
+		valid &= CheckData(result.data, 500, 10);
+		numCalled++;
+	}, 500, 200));
+	reader.Read(AsyncReadRequest(paths[10], [&](AsyncReadResult& result)
+	{
+		valid &= result.success && result.data.size() == 100;
+		valid &= CheckData(result.data, 9900, 10);
+		numCalled++;
+	}, 9900, 1000));
+	reader.Read(AsyncReadRequest(paths[0] + ".missing", [&](AsyncReadResult& result)
+	{
+		valid &= !result.success && result.data.empty();
+		numCalled++;
+	}));
+
+	reader.WaitAll();
+	TestEnsure(valid);
+	TestEnsure(numCalled == numFiles + 3);
+	TestEnsure(reader.GetNumPending() == 0);
+
+	// Reads that are still in progress when the reader is destroyed are finished without calling their callbacks
+	uint32 numCalledBefore = numCalled;
+	{
+		AsyncFileReader abandoned(1, allowIoUring);
+		for(uint32 i = 0; i < 10; i++)
+			abandoned.Read(AsyncReadRequest(paths[numFiles - 1], [&](AsyncReadResult& result) { numCalled++; }));
+	}
+	TestEnsure(numCalled == numCalledBefore);
+}
+
+Test("AsyncFileReader.Threads")
+{
+	TestReads(context, false);
+}
+
+Test("AsyncFileReader.IoUring")
+{
+	// Falls back to threads when io_uring is not available
+	TestReads(context, true);
+}
+
+// Compares reading many small files with blocking reads on the calling thread and with the async reader
+Test("AsyncFileReader.Benchmark")
+{
+	const uint32 numFiles = 200;
+	const size_t fileSize = 64 * 1024;
+	Vector<String> paths;
+	for(uint32 i = 0; i < numFiles; i++)
+	{
+		String path = Path::Absolute(TestBasePath + Path::sep + Utility::Sprintf("async_benchmark_%d.bin", i));
+		TestEnsure(WriteTestFile(path, fileSize, (uint8)i));
+		paths.Add(path);
+	}
+
+	// Each way of reading is repeated and the fastest time is used, the first reads include setting up the threads and the kernel side of io_uring
+	const uint32 numRuns = 3;
+	double blockingTime = DBL_MAX;
+	for(uint32 run = 0; run < numRuns; run++)
+	{
+		Timer timer;
+		size_t total = 0;
+		for(const String& path : paths)
+		{
+			File file;
+			file.OpenRead(path);
+			Buffer data;
+			data.resize(file.GetSize());
+			total += file.Read(data.data(), data.size());
+		}
+		blockingTime = Math::Min(blockingTime, timer.SecondsAsDouble() * 1000.0);
+		TestEnsure(total == numFiles * fileSize);
+	}
+
+	// Time spent submitting the reads on the calling thread and until all reads are finished
+	auto benchmark = [&](bool allowIoUring, double& submitTime, double& totalTime)
+	{
+		AsyncFileReader reader(2, allowIoUring);
+		submitTime = DBL_MAX;
+		totalTime = DBL_MAX;
+		for(uint32 run = 0; run < numRuns; run++)
+		{
+			size_t asyncTotal = 0;
+			Timer timer;
+			Vector<AsyncReadRequest> requests;
+			for(const String& path : paths)
+			{
+				requests.emplace_back(path, [&](AsyncReadResult& result)
+				{
+					asyncTotal += result.data.size();
+				});
+			}
+			reader.Read(requests);
+			submitTime = Math::Min(submitTime, timer.SecondsAsDouble() * 1000.0);
+			reader.WaitAll();
+			totalTime = Math::Min(totalTime, timer.SecondsAsDouble() * 1000.0);
+			TestEnsure(asyncTotal == numFiles * fileSize);
+		}
+		return reader.IsUsingIoUring();
+	};
+	double threadSubmit, threadTotal, uringSubmit, uringTotal;
+	benchmark(false, threadSubmit, threadTotal);
+	bool usedIoUring = benchmark(true, uringSubmit, uringTotal);
+
+	Logf("%d files of %d KB: blocking %.2f ms", Logger::Info, numFiles, (int32)(fileSize / 1024), blockingTime);
+	Logf("Threads: submit %.3f ms, total %.2f ms", Logger::Info, threadSubmit, threadTotal);
+	if(usedIoUring)
+		Logf("io_uring: submit %.3f ms, total %.2f ms", Logger::Info, uringSubmit, uringTotal);
+}
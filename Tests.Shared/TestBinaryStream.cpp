@@ -0,0 +1,51 @@
+#include <Shared/Shared.hpp>
+#include <Shared/MemoryStream.hpp>
+#include <Tests/Tests.hpp>
+
+struct TestPoint
+{
+	int32 time;
+	float value;
+};
+
+Test("BinaryStream.RoundTrip")
+{
+	Vector<TestPoint> points;
+	for(int32 i = 0; i < 1000; i++)
+		points.Add({ i, i * 0.5f });
+	Vector<String> names = { "a", "bc", "" };
+	Map<int32, String> map = { { 3, "three" }, { 1, "one" }, { 2, "two" } };
+	String title = "title";
+
+	Buffer buffer;
+	MemoryWriter writer(buffer);
+	writer << points << names << map << title;
+
+	Vector<TestPoint> readPoints;
+	Vector<String> readNames;
+	Map<int32, String> readMap;
+	String readTitle;
+	MemoryReader reader(buffer);
+	reader << readPoints << readNames << readMap << readTitle;
+	TestEnsure(readPoints.size() == points.size());
+	TestEnsure(memcmp(readPoints.data(), points.data(), points.size() * sizeof(TestPoint)) == 0);
+	TestEnsure(readNames == names);
+	TestEnsure(readMap == map);
+	TestEnsure(readTitle == title);
+	TestEnsure(reader.Tell() == buffer.size());
+}
+
+Test("BinaryStream.Truncated")
+{
+	// A length that is larger than the data left in the stream is rejected instead of allocated
+	Buffer buffer;
+	MemoryWriter writer(buffer);
+	uint32 length = 1000000;
+	float value = 1.0f;
+	writer << length << value;
+
+	Vector<float> values = { 2.0f };
+	MemoryReader reader(buffer);
+	TestEnsure(!reader.SerializeObject(values));
+	TestEnsure(values.empty());
+}
@@ -1,5 +1,6 @@
 #include <Shared/Shared.hpp>
 #include <Shared/Action.hpp>
+#include <Shared/AllocationTracker.hpp>
 #include <Tests/Tests.hpp>
 
 // Testing callbacks
@@ -69,6 +70,146 @@ Test("Delegate.Call")
 	TestEnsure(tc.classCallCounter == 1);
 }
 
+Test("Delegate.RemoveDuringCall")
+{
+	// Handlers that remove themselves or other handlers during a call
+	Delegate<> dv;
+	TestClass a;
+	TestClass b;
+	TestClass c;
+	int lambdaCounter = 0;
+	DelegateHandle dh = nullptr;
+	dh = dv.AddLambda([&]()
+	{
+		lambdaCounter++;
+		dv.Remove(dh);
+		dv.RemoveAll(&b);
+	});
+	dv.Add(&a, &TestClass::TestCallback);
+	dv.Add(&b, &TestClass::TestCallback);
+	dv.Add(&c, &TestClass::TestCallback);
+	dv.Call();
+	dv.Call();
+	TestEnsure(lambdaCounter == 1);
+	TestEnsure(a.classCallCounter == 2 && b.classCallCounter == 0 && c.classCallCounter == 2);
+
+	// Clearing during a call skips the remaining handlers
+	dv.AddLambda([&]()
+	{
+		dv.Clear();
+	});
+	dv.Add(&b, &TestClass::TestCallback);
+	dv.Call();
+	TestEnsure(!dv.IsHandled());
+	TestEnsure(a.classCallCounter == 3 && b.classCallCounter == 0 && c.classCallCounter == 3);
+}
+
+Test("Delegate.Allocations")
+{
+	// Two static or member handlers are stored inside of the delegate
+	TestClass tc;
+	AllocationTracker::SetEnabled(true);
+	AllocationTracker::Counts before = AllocationTracker::GetCounts(AllocationTag::General);
+	{
+		Delegate<> dv;
+		dv.Add(&TestCallback);
+		dv.Add(&tc, &TestClass::TestCallback);
+		dv.Call();
+		dv.Remove(&TestCallback);
+		dv.RemoveAll(&tc);
+	}
+	AllocationTracker::Counts after = AllocationTracker::GetCounts(AllocationTag::General);
+	AllocationTracker::SetEnabled(false);
+	TestEnsure(after.numAllocations == before.numAllocations);
+	TestEnsure(tc.classCallCounter == 1);
+
+	// More handlers move to an array on the heap
+	Delegate<> dv;
+	TestClass objects[5];
+	for(TestClass& object : objects)
+		dv.Add(&object, &TestClass::TestCallback);
+	dv.Call();
+	dv.Remove(&objects[2], &TestClass::TestCallback);
+	dv.Call();
+	for(int32 i = 0; i < 5; i++)
+		TestEnsure(objects[i].classCallCounter == (i == 2 ? 1 : 2));
+}
+
+Test("Delegate.Move")
+{
+	// Handlers are moved from inline storage and from the heap
+	TestClass objects[3];
+	Delegate<> a;
+	a.Add(&objects[0], &TestClass::TestCallback);
+	Delegate<> b = std::move(a);
+	for(TestClass& object : objects)
+		a.Add(&object, &TestClass::TestCallback);
+	b = std::move(a);
+	a.Call();
+	b.Call();
+	TestEnsure(!a.IsHandled());
+	for(TestClass& object : objects)
+		TestEnsure(object.classCallCounter == 1);
+}
+
+class BenchmarkHandler
+{
+public:
+	void OnEvent(int32 value)
+	{
+		total += value;
+	}
+	int64 total = 0;
+};
+
+// Measures calling a delegate with member function handlers, compared to the virtual bindings that delegates used to store
+Test("Delegate.Benchmark")
+{
+	const int32 numCalls = 1000000;
+	const uint32 numHandlers[] = { 1, 2, 8 };
+	for(uint32 count : numHandlers)
+	{
+		Vector<BenchmarkHandler> handlers;
+		handlers.resize(count);
+		Delegate<int32> dv;
+		Vector<IFunctionBinding<void, int32>*> bindings;
+		for(BenchmarkHandler& handler : handlers)
+		{
+			dv.Add(&handler, &BenchmarkHandler::OnEvent);
+			bindings.Add(new ObjectBinding<BenchmarkHandler, void, int32>(&handler, &BenchmarkHandler::OnEvent));
+		}
+
+		Timer timer;
+		for(int32 i = 0; i < numCalls; i++)
+			dv.Call(i);
+		double delegateTime = timer.SecondsAsDouble() * 1e9 / numCalls;
+		timer.Restart();
+		for(int32 i = 0; i < numCalls; i++)
+		{
+			for(IFunctionBinding<void, int32>* binding : bindings)
+				binding->Call(i);
+		}
+		double virtualTime = timer.SecondsAsDouble() * 1e9 / numCalls;
+
+		// Adding and removing a handler, as objects do when they are created and destroyed
+		timer.Restart();
+		BenchmarkHandler extra;
+		for(int32 i = 0; i < numCalls / 10; i++)
+		{
+			dv.Add(&extra, &BenchmarkHandler::OnEvent);
+			dv.Remove(&extra, &BenchmarkHandler::OnEvent);
+		}
+		double addRemoveTime = timer.SecondsAsDouble() * 1e9 / (numCalls / 10);
+
+		for(BenchmarkHandler& handler : handlers)
+			TestEnsure(handler.total == (int64)numCalls * (numCalls - 1));
+		for(IFunctionBinding<void, int32>* binding : bindings)
+			delete binding;
+		Logf("%d handlers: Delegate call %.1f ns, virtual bindings %.1f ns, add + remove %.1f ns", Logger::Info,
+			count, delegateTime, virtualTime, addRemoveTime);
+	}
+}
+
 Test("Action.Assignment")
 {
 	Action<> a;
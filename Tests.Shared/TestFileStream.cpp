@@ -0,0 +1,180 @@
+#include <Shared/Shared.hpp>
+#include <Shared/File.hpp>
+#include <Shared/FileStream.hpp>
+#include <Shared/MemoryStream.hpp>
+#include <Shared/MmapFileReader.hpp>
+#include <Shared/TextStream.hpp>
+#include <Tests/Tests.hpp>
+
+// Result of the benchmarks so the compiler can't remove the reads
+static volatile size_t readTotal = 0;
+
+static bool WriteTestFile(const String& path, const Buffer& data)
+{
+	File file;
+	if(!file.OpenWrite(path, false))
+		return false;
+	return file.Write(data.data(), data.size()) == data.size();
+}
+
+Test("FileStream.BufferedReader")
+{
+	String path = Path::Absolute(TestBasePath + Path::sep + "buffered_reader.bin");
+	Buffer data;
+	data.resize(10000);
+	for(size_t i = 0; i < data.size(); i++)
+		data[i] = (uint8)(i * 7);
+	TestEnsure(WriteTestFile(path, data));
+
+	File file;
+	TestEnsure(file.OpenRead(path));
+	// Small buffer so reads cross the end of the buffer
+	BufferedFileReader reader(file, 256);
+	TestEnsure(reader.GetSize() == data.size());
+
+	// Reads of random sizes, some larger than the buffer
+	Buffer read;
+	read.resize(data.size());
+	size_t position = 0;
+	while(position < data.size())
+	{
+		size_t len = Math::Min((size_t)Random::IntRange(1, 600), data.size() - position);
+		TestEnsure(reader.Serialize(read.data() + position, len) == len);
+		position += len;
+		TestEnsure(reader.Tell() == position);
+	}
+	TestEnsure(read == data);
+	uint8 value;
+	TestEnsure(reader.Serialize(&value, 1) == 0);
+
+	// Seeking inside and outside of the buffer
+	const size_t positions[] = { 9990, 9000, 9100, 10, 0, 5000 };
+	for(size_t pos : positions)
+	{
+		reader.Seek(pos);
+		TestEnsure(reader.Tell() == pos);
+		TestEnsure(reader.Serialize(&value, 1) == 1 && value == data[pos]);
+	}
+	reader.Skip(99);
+	TestEnsure(reader.Serialize(&value, 1) == 1 && value == data[5100]);
+}
+
+Test("FileStream.MmapReader")
+{
+	String path = Path::Absolute(TestBasePath + Path::sep + "mmap_reader.bin");
+	Buffer data;
+	data.resize(10000);
+	for(size_t i = 0; i < data.size(); i++)
+		data[i] = (uint8)(i * 13);
+	TestEnsure(WriteTestFile(path, data));
+
+	MmapFileReader reader;
+	TestEnsure(reader.Open(path) && reader.IsOpen());
+	TestEnsure(reader.GetSize() == data.size());
+	TestEnsure(memcmp(reader.GetData(), data.data(), data.size()) == 0);
+	reader.Seek(9995);
+	uint8 end[10];
+	TestEnsure(reader.Serialize(end, 10) == 5);
+	TestEnsure(memcmp(end, data.data() + 9995, 5) == 0);
+	reader.Close();
+	TestEnsure(!reader.IsOpen());
+
+	// Empty files are opened but not mapped
+	String emptyPath = Path::Absolute(TestBasePath + Path::sep + "mmap_reader_empty.bin");
+	TestEnsure(WriteTestFile(emptyPath, Buffer()));
+	TestEnsure(reader.Open(emptyPath));
+	TestEnsure(reader.GetSize() == 0 && reader.GetData() == nullptr);
+	TestEnsure(reader.Serialize(end, 1) == 0);
+	TestEnsure(!reader.Open(path + ".missing"));
+}
+
+// Reads every line of the stream, returns the number of lines
+static size_t ReadLines(BinaryStream& stream)
+{
+	String line;
+	size_t numLines = 0;
+	size_t total = 0;
+	while(TextStream::ReadLine(stream, line))
+	{
+		total += line.size();
+		numLines++;
+	}
+	readTotal = total;
+	return numLines;
+}
+// Reads the file as pairs of integers and floats, returns the number of pairs
+static size_t ReadFields(BinaryStream& stream)
+{
+	size_t numFields = 0;
+	uint32 total = 0;
+	while(stream.Tell() < stream.GetSize())
+	{
+		uint32 time;
+		float value;
+		stream << time << value;
+		total += time + (uint32)value;
+		numFields++;
+	}
+	readTotal = total;
+	return numFields;
+}
+
+// Compares reading text line by line and binary data field by field with the different readers
+Test("FileStream.Benchmark")
+{
+	const size_t numLines = 50000;
+	String textPath = Path::Absolute(TestBasePath + Path::sep + "benchmark_lines.txt");
+	String binaryPath = Path::Absolute(TestBasePath + Path::sep + "benchmark_fields.bin");
+	{
+		String text;
+		for(size_t i = 0; i < numLines; i++)
+			text += Utility::Sprintf("%d=value of line %d\n", (int32)i, (int32)i);
+		Buffer data;
+		data.resize(text.size());
+		memcpy(data.data(), text.data(), text.size());
+		TestEnsure(WriteTestFile(textPath, data));
+
+		data.clear();
+		MemoryWriter writer(data);
+		for(size_t i = 0; i < numLines; i++)
+		{
+			uint32 time = (uint32)i;
+			float value = i * 0.5f;
+			writer << time << value;
+		}
+		TestEnsure(WriteTestFile(binaryPath, data));
+	}
+
+	// Runs the benchmark on each reader, returns the time in ms
+	auto benchmark = [&](const String& path, size_t (*read)(BinaryStream&), double* times)
+	{
+		Timer timer;
+		File file;
+		file.OpenRead(path);
+		FileReader reader(file);
+		TestEnsure(read(reader) == numLines);
+		times[0] = timer.SecondsAsDouble() * 1000.0;
+
+		timer.Restart();
+		File bufferedFile;
+		bufferedFile.OpenRead(path);
+		BufferedFileReader bufferedReader(bufferedFile);
+		TestEnsure(read(bufferedReader) == numLines);
+		times[1] = timer.SecondsAsDouble() * 1000.0;
+
+		timer.Restart();
+		MmapFileReader mmapReader;
+		mmapReader.Open(path);
+		TestEnsure(read(mmapReader) == numLines);
+		times[2] = timer.SecondsAsDouble() * 1000.0;
+	};
+
+	double lineTimes[3];
+	double fieldTimes[3];
+	benchmark(textPath, &ReadLines, lineTimes);
+	benchmark(binaryPath, &ReadFields, fieldTimes);
+	Logf("%d lines: FileReader %.2f ms, BufferedFileReader %.2f ms, MmapFileReader %.2f ms", Logger::Info,
+		(int32)numLines, lineTimes[0], lineTimes[1], lineTimes[2]);
+	Logf("%d fields: FileReader %.2f ms, BufferedFileReader %.2f ms, MmapFileReader %.2f ms", Logger::Info,
+		(int32)numLines, fieldTimes[0], fieldTimes[1], fieldTimes[2]);
+}
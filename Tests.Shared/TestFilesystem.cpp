@@ -2,6 +2,7 @@
 #include <Shared/Enum.hpp>
 #include <Tests/Tests.hpp>
 #include <Shared/Files.hpp>
+#include <Shared/FileWatcher.hpp>
 
 void CreateDummyFile(const String& filename)
 {
@@ -92,6 +93,45 @@ Test("File.ScanFiles")
 	}
 	TestEnsure(expectedPaths.empty());
 }
+Test("File.Watcher")
+{
+	String folder = Path::Absolute(TestBasePath + Path::sep + context.GetName() + "_TestFolder");
+	TestEnsure(Path::CreateDir(folder));
+
+	FileWatcher watcher;
+	if(!watcher.Watch(folder))
+	{
+		Logf("Folder watching is not available on this platform", Logger::Warning);
+		return;
+	}
+	bool overflow = false;
+	TestEnsure(watcher.GetChanges(overflow).empty());
+
+	// Files in new folders are reported as well
+	String fileA = folder + Path::sep + "fileA";
+	String folder1 = folder + Path::sep + "Folder";
+	CreateDummyFile(fileA);
+	CreateDummyFolderWithFiles(folder1);
+	Vector<String> changes = watcher.GetChanges(overflow);
+	TestEnsure(!overflow);
+	TestEnsure(changes.size() == 4);
+	TestEnsure(changes.Contains(fileA));
+	TestEnsure(changes.Contains(folder1 + Path::sep + "fileC"));
+
+	// New folders are watched too
+	TestEnsure(Path::Delete(folder1 + Path::sep + "fileA"));
+	CreateDummyFile(folder1 + Path::sep + "fileD");
+	changes = watcher.GetChanges(overflow);
+	TestEnsure(changes.size() == 2);
+	TestEnsure(changes.Contains(folder1 + Path::sep + "fileA"));
+	TestEnsure(changes.Contains(folder1 + Path::sep + "fileD"));
+
+	// Removed folders are reported by their own path
+	TestEnsure(Path::DeleteDir(folder1));
+	changes = watcher.GetChanges(overflow);
+	TestEnsure(!overflow);
+	TestEnsure(changes.Contains(folder1));
+}
 Test("File.Dir")
 {
 	String folder = TestFilename;
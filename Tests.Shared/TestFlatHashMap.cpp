@@ -0,0 +1,155 @@
+#include <Shared/Shared.hpp>
+#include <Shared/FlatHashMap.hpp>
+#include <Shared/FlatHashSet.hpp>
+#include <Tests/Tests.hpp>
+
+// Result of the benchmarks so the compiler can't remove the lookups
+static volatile size_t found = 0;
+
+Test("FlatHashMap.Operations")
+{
+	// Random operations checked against Map, enough keys to use both the linear search and the index table
+	FlatHashMap<int32, int32> map;
+	Map<int32, int32> reference;
+	for(int32 i = 0; i < 20000; i++)
+	{
+		int32 key = Random::IntRange(0, 200);
+		int32 op = Random::IntRange(0, 2);
+		if(op == 0)
+		{
+			map.Add(key, i);
+			reference.Add(key, i);
+		}
+		else if(op == 1)
+		{
+			TestEnsure(map.erase(key) == reference.erase(key));
+		}
+		else
+		{
+			int32* value = map.Find(key);
+			int32* referenceValue = reference.Find(key);
+			TestEnsure((value == nullptr) == (referenceValue == nullptr));
+			TestEnsure(!value || *value == *referenceValue);
+		}
+		TestEnsure(map.size() == reference.size());
+	}
+	for(auto& entry : reference)
+		TestEnsure(map.Contains(entry.first) && map[entry.first] == entry.second);
+
+	// Erasing while iterating visits the entry that was moved into the erased position
+	size_t numOdd = 0;
+	for(auto& entry : map)
+		numOdd += entry.first % 2;
+	for(auto it = map.begin(); it != map.end();)
+	{
+		if(it->first % 2 == 0)
+		{
+			it = map.erase(it);
+			continue;
+		}
+		it++;
+	}
+	TestEnsure(map.size() == numOdd);
+	for(auto& entry : map)
+		TestEnsure(entry.first % 2 == 1);
+
+	map.clear();
+	TestEnsure(map.empty() && !map.Contains(1));
+	TestEnsure(map.FindOrAdd(1, 5) == 5 && map.FindOrAdd(1, 6) == 5);
+
+	FlatHashMap<String, int32> strings = { { "a", 1 }, { "b", 2 } };
+	TestEnsure(*strings.Find("b") == 2 && !strings.Find("c"));
+}
+
+Test("FlatHashSet.Operations")
+{
+	FlatHashSet<int32> a;
+	for(int32 i = 0; i < 100; i++)
+		a.Add(i);
+	a.Add(5);
+	TestEnsure(a.size() == 100);
+	TestEnsure(a.Remove(50) && !a.Remove(50));
+	TestEnsure(!a.Contains(50) && a.Contains(99));
+
+	// Equality does not depend on the order of the keys
+	FlatHashSet<int32> b;
+	for(int32 i = 99; i >= 0; i--)
+	{
+		if(i != 50)
+			b.Add(i);
+	}
+	TestEnsure(a == b);
+	b.Remove(0);
+	TestEnsure(a != b);
+}
+
+// Looks up every key in the container, returns the time per lookup in ns
+template<typename Container, typename K>
+static double BenchmarkLookup(const Container& container, const Vector<K>& keys, int32 numIterations)
+{
+	Timer timer;
+	size_t numFound = 0;
+	for(int32 i = 0; i < numIterations; i++)
+	{
+		for(const K& key : keys)
+			numFound += container.Contains(key) ? 1 : 0;
+	}
+	found = numFound;
+	return timer.SecondsAsDouble() * 1e9 / (numIterations * keys.size());
+}
+
+// Compares lookups and inserts with Map and Set
+Test("FlatHashMap.Benchmark")
+{
+	const int32 sizes[] = { 8, 64, 1000 };
+	for(int32 size : sizes)
+	{
+		int32 numIterations = 1000000 / size;
+		Vector<void*> pointers;
+		Vector<String> strings;
+		for(int32 i = 0; i < size; i++)
+		{
+			pointers.Add(new int32(i));
+			strings.Add(Utility::Sprintf("parameter%d", i));
+		}
+
+		Set<void*> pointerSet;
+		FlatHashSet<void*> flatPointerSet;
+		Map<String, int32> stringMap;
+		FlatHashMap<String, int32> flatStringMap;
+		Timer timer;
+		for(int32 i = 0; i < 100; i++)
+		{
+			pointerSet.clear();
+			for(void* pointer : pointers)
+				pointerSet.Add(pointer);
+		}
+		double setInsert = timer.SecondsAsDouble() * 1e9 / (100 * size);
+		timer.Restart();
+		for(int32 i = 0; i < 100; i++)
+		{
+			flatPointerSet.clear();
+			for(void* pointer : pointers)
+				flatPointerSet.Add(pointer);
+		}
+		double flatSetInsert = timer.SecondsAsDouble() * 1e9 / (100 * size);
+		for(int32 i = 0; i < size; i++)
+		{
+			stringMap.Add(strings[i], i);
+			flatStringMap.Add(strings[i], i);
+		}
+
+		double setLookup = BenchmarkLookup(pointerSet, pointers, numIterations);
+		double flatSetLookup = BenchmarkLookup(flatPointerSet, pointers, numIterations);
+		double mapLookup = BenchmarkLookup(stringMap, strings, numIterations);
+		double flatMapLookup = BenchmarkLookup(flatStringMap, strings, numIterations);
+		TestEnsure(found == (size_t)(numIterations * size));
+
+		Logf("%d entries: pointer insert Set %.1f ns, FlatHashSet %.1f ns", Logger::Info, size, setInsert, flatSetInsert);
+		Logf("%d entries: pointer lookup Set %.1f ns, FlatHashSet %.1f ns", Logger::Info, size, setLookup, flatSetLookup);
+		Logf("%d entries: string lookup Map %.1f ns, FlatHashMap %.1f ns", Logger::Info, size, mapLookup, flatMapLookup);
+
+		for(void* pointer : pointers)
+			delete (int32*)pointer;
+	}
+}
@@ -0,0 +1,96 @@
+#include <Shared/Shared.hpp>
+#include <Shared/FrameArena.hpp>
+#include <Tests/Tests.hpp>
+
+// Allocations are stored here so the compiler can't remove them
+static void* volatile allocation = nullptr;
+
+Test("FrameArena.Allocate")
+{
+	FrameArena arena(1024);
+	TestEnsure(arena.GetUsed() == 0 && arena.GetCapacity() == 0);
+
+	// Alignment is respected after unaligned allocations
+	arena.Allocate(3, 1);
+	void* aligned = arena.Allocate(16, 64);
+	TestEnsure(((size_t)aligned & 63) == 0);
+	Transform* tf = arena.New<Transform>();
+	TestEnsure(((size_t)tf & (alignof(Transform) - 1)) == 0);
+	TestEnsure((*tf)[0] == 1.0f && (*tf)[1] == 0.0f);
+
+	float* array = arena.NewArray<float>(10);
+	for(int32 i = 0; i < 10; i++)
+		TestEnsure(array[i] == 0.0f);
+	const char* str = arena.CopyString("mainTex", 7);
+	TestEnsure(strcmp(str, "mainTex") == 0);
+
+	// Allocations larger than a block get a block of their own
+	void* large = arena.Allocate(4000);
+	memset(large, 0, 4000);
+	TestEnsure(arena.GetCapacity() >= 5000);
+	size_t capacity = arena.GetCapacity();
+
+	// After a reset everything fits in a single block
+	arena.Reset();
+	TestEnsure(arena.GetUsed() == 0);
+	TestEnsure(arena.GetCapacity() == capacity);
+	uint8* first = (uint8*)arena.Allocate(1, 1);
+	arena.Allocate(4000);
+	TestEnsure(arena.GetCapacity() == capacity);
+	arena.Reset();
+	TestEnsure(arena.Allocate(1, 1) == first);
+}
+
+Test("FrameArena.DoubleBuffered")
+{
+	DoubleBufferedFrameArena arenas(1024);
+	int32* previous = arenas.Get().New<int32>(1);
+	arenas.Swap();
+
+	// The previous frame is kept while the next one is filled
+	int32* current = arenas.Get().New<int32>(2);
+	TestEnsure(&arenas.Get() != &arenas.GetPrevious());
+	TestEnsure(*previous == 1 && *current == 2);
+	TestEnsure(arenas.GetPrevious().GetUsed() == sizeof(int32));
+
+	// Swapping again reuses the first arena
+	arenas.Swap();
+	TestEnsure(arenas.Get().GetUsed() == 0);
+	TestEnsure(arenas.GetPrevious().GetUsed() == sizeof(int32));
+	TestEnsure(arenas.Get().New<int32>(3) == previous);
+}
+
+// Compares allocating small objects from the arena with new/delete
+Test("FrameArena.Benchmark")
+{
+	const int32 numFrames = 100;
+	const int32 numAllocations = 10000;
+	FrameArena arena;
+
+	Timer timer;
+	for(int32 frame = 0; frame < numFrames; frame++)
+	{
+		for(int32 i = 0; i < numAllocations; i++)
+			allocation = arena.New<Transform>();
+		arena.Reset();
+	}
+	double arenaTime = timer.SecondsAsDouble() * 1e9 / (numFrames * numAllocations);
+
+	Vector<Transform*> objects;
+	objects.reserve(numAllocations);
+	timer.Restart();
+	for(int32 frame = 0; frame < numFrames; frame++)
+	{
+		for(int32 i = 0; i < numAllocations; i++)
+		{
+			objects.Add(new Transform());
+			allocation = objects.back();
+		}
+		for(Transform* object : objects)
+			delete object;
+		objects.clear();
+	}
+	double heapTime = timer.SecondsAsDouble() * 1e9 / (numFrames * numAllocations);
+
+	Logf("Frame arena allocation: %.1f ns, new/delete: %.1f ns", Logger::Info, arenaTime, heapTime);
+}
@@ -0,0 +1,17 @@
+#include <Shared/Shared.hpp>
+#include <Shared/Hash.hpp>
+#include <Tests/Tests.hpp>
+
+Test("Hash.XXHash64")
+{
+	// Reference values of the xxHash implementation
+	TestEnsure(Hash::XXHash64("", 0) == 0xef46db3751d8e999ULL);
+	TestEnsure(Hash::XXHash64("abc", 3) == 0x44bc2cf5ad770999ULL);
+	String text = "Nobody inspects the spammish repetition";
+	TestEnsure(Hash::XXHash64(*text, text.size()) == 0xfbcea83c8a378bf1ULL);
+	TestEnsure(Hash::XXHash64("xxhash", 6, 20141025) == 0xb559b98d844e0635ULL);
+
+	// Unaligned input
+	String padded = "." + text;
+	TestEnsure(Hash::XXHash64(*padded + 1, text.size()) == 0xfbcea83c8a378bf1ULL);
+}
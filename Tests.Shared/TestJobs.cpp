@@ -0,0 +1,152 @@
+#include <Shared/Shared.hpp>
+#include <Shared/Jobs.hpp>
+#include <Shared/Thread.hpp>
+#include <Tests/Tests.hpp>
+#include <atomic>
+#include <chrono>
+
+typedef std::chrono::steady_clock Clock;
+
+static double MillisecondsBetween(Clock::time_point start, Clock::time_point end)
+{
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Runs the finished callbacks until the given job is finished
+static void WaitForJob(JobSheduler& sheduler, Job job)
+{
+	while(!job->IsFinished())
+	{
+		sheduler.Update();
+		std::this_thread::yield();
+	}
+}
+
+// Measures the time between queueing a job and the job starting
+Test("Jobs.Latency")
+{
+	JobSheduler sheduler;
+
+	// Jobs queued after the workers were idle for a while
+	double totalIdle = 0.0;
+	double maxIdle = 0.0;
+	const int32 numIdleJobs = 20;
+	for(int32 i = 0; i < numIdleJobs; i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		Clock::time_point queued = Clock::now();
+		Clock::time_point started;
+		Job job = JobBase::CreateLambda([&]()
+		{
+			started = Clock::now();
+			return true;
+		});
+		sheduler.Queue(job);
+		WaitForJob(sheduler, job);
+		TestEnsure(started >= queued);
+
+		double latency = MillisecondsBetween(queued, started);
+		totalIdle += latency;
+		maxIdle = Math::Max(maxIdle, latency);
+	}
+
+	// Many small jobs queued at once
+	const int32 numBurstJobs = 2000;
+	Vector<Clock::time_point> started(numBurstJobs);
+	Vector<Job> jobs;
+	Clock::time_point queued = Clock::now();
+	for(int32 i = 0; i < numBurstJobs; i++)
+	{
+		Clock::time_point* startTime = &started[i];
+		jobs.Add(JobBase::CreateLambda([=]()
+		{
+			*startTime = Clock::now();
+			return true;
+		}));
+		sheduler.Queue(jobs.back());
+	}
+	for(Job& job : jobs)
+		WaitForJob(sheduler, job);
+	double totalBurst = 0.0;
+	for(Clock::time_point& time : started)
+		totalBurst += MillisecondsBetween(queued, time);
+
+	Logf("Job latency with %d threads: %.3f ms average (%.3f ms max) after being idle, %.3f ms average for %d jobs queued at once", Logger::Info,
+		sheduler.GetNumThreads(), totalIdle / numIdleJobs, maxIdle, totalBurst / numBurstJobs, numBurstJobs);
+}
+
+Test("Jobs.Priority")
+{
+	JobSheduler sheduler(1);
+
+	// Keep the only thread busy until all jobs are queued
+	std::atomic<bool> release(false);
+	Job blocker = JobBase::CreateLambda([&]()
+	{
+		while(!release)
+			std::this_thread::yield();
+		return true;
+	});
+	sheduler.Queue(blocker);
+
+	Mutex orderLock;
+	Vector<JobPriority> order;
+	Vector<Job> jobs;
+	for(JobPriority priority : { JobPriority::Background, JobPriority::Normal, JobPriority::Interactive, JobPriority::Normal })
+	{
+		Job job = JobBase::CreateLambda([&, priority]()
+		{
+			std::lock_guard<Mutex> lock(orderLock);
+			order.Add(priority);
+			return true;
+		});
+		job->priority = priority;
+		sheduler.Queue(job);
+		jobs.Add(job);
+	}
+
+	release = true;
+	for(Job& job : jobs)
+		WaitForJob(sheduler, job);
+	TestEnsure(order.size() == 4);
+	TestEnsure(order[0] == JobPriority::Interactive && order[1] == JobPriority::Normal &&
+		order[2] == JobPriority::Normal && order[3] == JobPriority::Background);
+}
+
+Test("Jobs.Terminate")
+{
+	JobSheduler sheduler(1);
+
+	std::atomic<bool> release(false);
+	Job blocker = JobBase::CreateLambda([&]()
+	{
+		while(!release)
+			std::this_thread::yield();
+		return true;
+	});
+	sheduler.Queue(blocker);
+
+	// Queued jobs are removed without running them
+	bool ran = false;
+	Job job = JobBase::CreateLambda([&]()
+	{
+		ran = true;
+		return true;
+	});
+	sheduler.Queue(job);
+	TestEnsure(job->IsQueued());
+	job->Terminate();
+	TestEnsure(!job->IsQueued());
+
+	// Jobs can also be removed from other threads
+	sheduler.Queue(job);
+	bool dequeued = false;
+	Thread thread([&]() { dequeued = sheduler.Dequeue(job); });
+	thread.join();
+	TestEnsure(dequeued && !job->IsQueued());
+	TestEnsure(!sheduler.Dequeue(blocker));
+
+	release = true;
+	WaitForJob(sheduler, blocker);
+	TestEnsure(!ran && !job->IsFinished());
+}
@@ -0,0 +1,205 @@
+#include <Shared/Shared.hpp>
+#include <Shared/LockFreeQueue.hpp>
+#include <Shared/Thread.hpp>
+#include <Tests/Tests.hpp>
+
+Test("SPSCQueue.Operations")
+{
+	SPSCQueue<String> queue(5);
+	TestEnsure(queue.GetCapacity() == 8);
+	String item;
+	TestEnsure(!queue.TryPop(item));
+	for(int32 i = 0; i < 8; i++)
+		TestEnsure(queue.TryPush(Utility::Sprintf("item%d", i)));
+	TestEnsure(!queue.TryPush("full"));
+	TestEnsure(queue.GetSize() == 8);
+
+	// Wrapping around the end of the queue keeps the order
+	for(int32 i = 0; i < 20; i++)
+	{
+		TestEnsure(queue.TryPop(item) && item == Utility::Sprintf("item%d", i));
+		TestEnsure(queue.TryPush(Utility::Sprintf("item%d", i + 8)));
+	}
+
+	// Items left in the queue are destroyed with it
+	queue.Close();
+	TestEnsure(!queue.Push("closed"));
+	TestEnsure(queue.Pop(item) && item == "item20");
+}
+
+Test("MPSCQueue.Operations")
+{
+	MPSCQueue<String> queue(4);
+	TestEnsure(queue.GetCapacity() == 4);
+	String item;
+	TestEnsure(!queue.TryPop(item));
+	for(int32 i = 0; i < 4; i++)
+		TestEnsure(queue.TryPush(Utility::Sprintf("item%d", i)));
+	TestEnsure(!queue.TryPush("full"));
+	for(int32 i = 0; i < 10; i++)
+	{
+		TestEnsure(queue.TryPop(item) && item == Utility::Sprintf("item%d", i));
+		TestEnsure(queue.TryPush(Utility::Sprintf("item%d", i + 4)));
+	}
+
+	// Closing wakes up a waiting consumer once the queue is empty
+	Thread consumer([&]()
+	{
+		while(queue.Pop(item))
+		{
+		}
+	});
+	queue.Close();
+	consumer.join();
+	TestEnsure(!queue.TryPop(item));
+}
+
+Test("SPSCQueue.Stress")
+{
+	// Small queue so both threads often wait for each other
+	const uint32 numItems = 200000;
+	SPSCQueue<uint32> queue(16);
+	Thread producer([&]()
+	{
+		for(uint32 i = 0; i < numItems; i++)
+			queue.Push(i);
+		queue.Close();
+	});
+
+	uint32 expected = 0;
+	uint32 item;
+	bool ordered = true;
+	while(queue.Pop(item))
+	{
+		ordered &= item == expected;
+		expected++;
+	}
+	producer.join();
+	TestEnsure(ordered);
+	TestEnsure(expected == numItems);
+}
+
+Test("MPSCQueue.Stress")
+{
+	// Every producer pushes increasing values, which should arrive in order for each producer
+	const uint32 numProducers = 4;
+	const uint32 numItems = 50000;
+	MPSCQueue<uint64> queue(64);
+	Vector<Thread> producers;
+	for(uint32 p = 0; p < numProducers; p++)
+	{
+		producers.emplace_back([&queue, p]()
+		{
+			for(uint32 i = 0; i < numItems; i++)
+			{
+				uint64 item = ((uint64)p << 32) | i;
+				// Mix waiting and non-waiting pushes
+				if(i % 2 == 0 || !queue.TryPush(item))
+					queue.Push(item);
+			}
+		});
+	}
+
+	uint32 next[numProducers] = { 0 };
+	uint32 numReceived = 0;
+	bool ordered = true;
+	uint64 item;
+	while(numReceived < numProducers * numItems && queue.Pop(item))
+	{
+		uint32 p = (uint32)(item >> 32);
+		ordered &= p < numProducers && next[p] == (uint32)item;
+		if(p < numProducers)
+			next[p]++;
+		numReceived++;
+	}
+	for(Thread& producer : producers)
+		producer.join();
+	TestEnsure(ordered);
+	TestEnsure(!queue.TryPop(item));
+	for(uint32 p = 0; p < numProducers; p++)
+		TestEnsure(next[p] == numItems);
+}
+
+// Queue protected by a mutex, the way threads share data in the rest of the engine
+template<typename T>
+class MutexQueue
+{
+public:
+	void Push(const T& item)
+	{
+		m_lock.lock();
+		m_items.AddBack(item);
+		m_lock.unlock();
+	}
+	bool TryPop(T& out)
+	{
+		m_lock.lock();
+		if(m_items.empty())
+		{
+			m_lock.unlock();
+			return false;
+		}
+		out = m_items.front();
+		m_items.pop_front();
+		m_lock.unlock();
+		return true;
+	}
+
+private:
+	Mutex m_lock;
+	List<T> m_items;
+};
+
+// Sends items from the producers to the consumer, returns the number of items per second
+template<typename Push, typename Pop>
+static double BenchmarkQueue(uint32 numProducers, uint32 numItems, Push push, Pop pop)
+{
+	Timer timer;
+	Vector<Thread> producers;
+	for(uint32 p = 0; p < numProducers; p++)
+	{
+		producers.emplace_back([&]()
+		{
+			for(uint32 i = 0; i < numItems; i++)
+				push(i);
+		});
+	}
+	uint32 item;
+	for(uint32 i = 0; i < numProducers * numItems; i++)
+		pop(item);
+	for(Thread& producer : producers)
+		producer.join();
+	return numProducers * numItems / timer.SecondsAsDouble();
+}
+
+// Compares the lock free queues with a mutex and a list
+Test("LockFreeQueue.Benchmark")
+{
+	const uint32 numItems = 200000;
+	const uint32 numProducers = 4;
+
+	auto popMutex = [](MutexQueue<uint32>& queue, uint32& out)
+	{
+		while(!queue.TryPop(out))
+			std::this_thread::yield();
+	};
+
+	SPSCQueue<uint32> spsc(1024);
+	double spscRate = BenchmarkQueue(1, numItems,
+		[&](uint32 item) { spsc.Push(item); },
+		[&](uint32& out) { spsc.Pop(out); });
+	MutexQueue<uint32> mutexQueue;
+	double mutexRate = BenchmarkQueue(1, numItems,
+		[&](uint32 item) { mutexQueue.Push(item); },
+		[&](uint32& out) { popMutex(mutexQueue, out); });
+	Logf("1 producer: SPSCQueue %.2f M items/s, Mutex + List %.2f M items/s", Logger::Info, spscRate * 1e-6, mutexRate * 1e-6);
+
+	MPSCQueue<uint32> mpsc(1024);
+	double mpscRate = BenchmarkQueue(numProducers, numItems / numProducers,
+		[&](uint32 item) { mpsc.Push(item); },
+		[&](uint32& out) { mpsc.Pop(out); });
+	mutexRate = BenchmarkQueue(numProducers, numItems / numProducers,
+		[&](uint32 item) { mutexQueue.Push(item); },
+		[&](uint32& out) { popMutex(mutexQueue, out); });
+	Logf("%d producers: MPSCQueue %.2f M items/s, Mutex + List %.2f M items/s", Logger::Info, numProducers, mpscRate * 1e-6, mutexRate * 1e-6);
+}
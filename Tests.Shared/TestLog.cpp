@@ -0,0 +1,32 @@
+#include <Shared/Shared.hpp>
+#include <Shared/Thread.hpp>
+#include <Tests/Tests.hpp>
+#include <atomic>
+
+// Formats and logs messages from multiple threads at once, like the asset loader and map scan threads do
+Test("Log.Threads")
+{
+	const uint32 numThreads = 4;
+	const uint32 numMessages = 2000;
+	std::atomic<uint32> numMismatches(0);
+	Vector<Thread> threads;
+	for(uint32 t = 0; t < numThreads; t++)
+	{
+		threads.emplace_back([&, t]()
+		{
+			for(uint32 i = 0; i < numMessages; i++)
+			{
+				String msg = Utility::Sprintf("Thread %d message %d", t, i);
+				char expected[64];
+				snprintf(expected, sizeof(expected), "Thread %d message %d", t, i);
+				if(msg != expected)
+					numMismatches++;
+				if(i % 500 == 0)
+					Logf("Thread %d message %d", Logger::Info, t, i);
+			}
+		});
+	}
+	for(Thread& thread : threads)
+		thread.join();
+	TestEnsure(numMismatches == 0);
+}
@@ -0,0 +1,100 @@
+#include <Shared/Shared.hpp>
+#include <Shared/Profiling.hpp>
+#include <Shared/Thread.hpp>
+#include <Shared/File.hpp>
+#include <Tests/Tests.hpp>
+
+static bool FindZone(const Profiler::FrameStats& frame, const char* threadName, const char* zoneName, Profiler::ZoneStats& out)
+{
+	for(auto& thread : frame.threads)
+	{
+		if(strcmp(thread.name, threadName) != 0)
+			continue;
+		for(auto& zone : thread.zones)
+		{
+			if(strcmp(zone.name, zoneName) == 0)
+			{
+				out = zone;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+Test("Profiler.Frame")
+{
+	Profiler::SetEnabled(true);
+	Profiler::SetThreadName("Test Main");
+
+	Profiler::BeginFrame();
+	{
+		ProfileZone("Update");
+		for(int32 i = 0; i < 3; i++)
+		{
+			ProfileZone("Step");
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+	}
+	Thread worker([]()
+	{
+		Profiler::SetThreadName("Test Worker");
+		ProfileZone("Work");
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	});
+	worker.join();
+	Profiler::BeginFrame();
+
+	// Not recorded while disabled
+	Profiler::SetEnabled(false);
+	{
+		ProfileZone("Disabled");
+	}
+
+	Profiler::FrameStats frame = Profiler::GetLastFrame();
+	TestEnsure(frame.duration >= 7.0);
+	Profiler::ZoneStats zone;
+	TestEnsure(FindZone(frame, "Test Main", "Update", zone));
+	TestEnsure(zone.depth == 0 && zone.count == 1 && zone.time >= 6.0);
+	TestEnsure(FindZone(frame, "Test Main", "Step", zone));
+	TestEnsure(zone.depth == 1 && zone.count == 3 && zone.time >= 6.0);
+	TestEnsure(FindZone(frame, "Test Worker", "Work", zone));
+	TestEnsure(zone.count == 1 && zone.time >= 1.0);
+
+	// The trace contains the zones of all threads
+	String path = Path::Absolute(TestBasePath + Path::sep + "profile_trace.json");
+	TestEnsure(Profiler::ExportChromeTrace(path));
+	File file;
+	TestEnsure(file.OpenRead(path));
+	String json;
+	json.resize(file.GetSize());
+	file.Read(&json.front(), json.size());
+	TestEnsure(json.find("{\"traceEvents\":[") == 0);
+	TestEnsure(json.find("\"name\":\"Test Worker\"") != String::npos);
+	TestEnsure(json.find("{\"name\":\"Step\",\"ph\":\"E\"") != String::npos);
+	TestEnsure(json.find("Disabled") == String::npos);
+}
+
+// Measures the cost of recording a zone
+Test("Profiler.Overhead")
+{
+	const int32 numZones = 1000000;
+	Profiler::SetEnabled(false);
+	Timer timer;
+	for(int32 i = 0; i < numZones; i++)
+	{
+		ProfileZone("Disabled");
+	}
+	double disabledTime = timer.SecondsAsDouble() * 1e9 / numZones;
+
+	Profiler::SetEnabled(true);
+	timer.Restart();
+	for(int32 i = 0; i < numZones; i++)
+	{
+		ProfileZone("Enabled");
+	}
+	double enabledTime = timer.SecondsAsDouble() * 1e9 / numZones;
+	Profiler::SetEnabled(false);
+
+	Logf("Profiler zone overhead: %.1f ns disabled, %.1f ns enabled", Logger::Info, disabledTime, enabledTime);
+}
@@ -0,0 +1,159 @@
+#include <Shared/Shared.hpp>
+#include <Shared/Thread.hpp>
+#include <Tests/Tests.hpp>
+#include <memory>
+
+// Counts the number of living objects
+static int32 numObjects = 0;
+class TestObject
+{
+public:
+	TestObject(int32 value = 0) : value(value) { numObjects++; }
+	virtual ~TestObject() { numObjects--; }
+	int32 value;
+};
+class DerivedTestObject : public TestObject, public RefCounted<DerivedTestObject>
+{
+};
+
+Test("Ref.Counting")
+{
+	numObjects = 0;
+	{
+		Ref<TestObject> a = Utility::MakeRef(new TestObject(1));
+		Ref<TestObject> b = Utility::NewRef<TestObject>(2);
+		TestEnsure(numObjects == 2);
+		TestEnsure(a->value == 1 && b->value == 2);
+
+		Ref<TestObject> c = a;
+		TestEnsure(a.GetRefCount() == 2);
+		c = b;
+		c = c;
+		TestEnsure(a.GetRefCount() == 1 && b.GetRefCount() == 2);
+		Ref<TestObject> d = std::move(c);
+		TestEnsure(!c && b.GetRefCount() == 2);
+
+		b.Release();
+		d.Release();
+		TestEnsure(numObjects == 1);
+	}
+	TestEnsure(numObjects == 0);
+
+	// Objects that can create references to themselves share the same counter
+	DerivedTestObject* obj = new DerivedTestObject();
+	Ref<DerivedTestObject> ref = Utility::MakeRef(obj);
+	Ref<DerivedTestObject> shared = obj->MakeShared();
+	TestEnsure(ref == shared && obj->GetRefCount() == 2);
+	Ref<TestObject> base = ref.As<TestObject>();
+	TestEnsure(base.GetRefCount() == 3);
+	ref.Release();
+	shared.Release();
+	base.Release();
+	TestEnsure(numObjects == 0);
+
+	Ref<DerivedTestObject> inPlace = Utility::NewRef<DerivedTestObject>();
+	TestEnsure(inPlace->MakeShared() == inPlace);
+	inPlace.Release();
+	TestEnsure(numObjects == 0);
+}
+
+Test("Ref.Weak")
+{
+	numObjects = 0;
+	WeakRef<TestObject> weak;
+	TestEnsure(weak.IsExpired() && !weak.Lock());
+	{
+		Ref<TestObject> ref = Utility::NewRef<TestObject>(5);
+		weak = ref;
+		TestEnsure(!weak.IsExpired());
+		Ref<TestObject> locked = weak.Lock();
+		TestEnsure(locked && locked->value == 5 && ref.GetRefCount() == 2);
+	}
+	// The object is deleted, the weak reference keeps only the counter alive
+	TestEnsure(numObjects == 0);
+	TestEnsure(weak.IsExpired() && !weak.Lock());
+
+	// Destroying an object invalidates all references to it
+	Ref<TestObject> a = Utility::MakeRef(new TestObject());
+	Ref<TestObject> b = a;
+	weak = a;
+	a.Destroy();
+	TestEnsure(numObjects == 0);
+	TestEnsure(!a && !b && b.GetRefCount() == 0);
+	TestEnsure(weak.IsExpired() && !weak.Lock());
+
+	// Destroying an empty reference does nothing
+	Ref<TestObject> empty;
+	empty.Destroy();
+	TestEnsure(!empty);
+}
+
+Test("Ref.Threads")
+{
+	numObjects = 0;
+	Ref<TestObject> ref = Utility::NewRef<TestObject>();
+	WeakRef<TestObject> weak = ref;
+
+	// Copy and release references from multiple threads at the same time
+	const int32 numThreads = 4;
+	const int32 numCopies = 100000;
+	Thread threads[numThreads];
+	for(int32 i = 0; i < numThreads; i++)
+	{
+		threads[i] = Thread([&]()
+		{
+			for(int32 j = 0; j < numCopies; j++)
+			{
+				Ref<TestObject> copy = ref;
+				Ref<TestObject> locked = weak.Lock();
+				WeakRef<TestObject> weakCopy = weak;
+			}
+		});
+	}
+	for(Thread& thread : threads)
+		thread.join();
+	TestEnsure(ref.GetRefCount() == 1 && numObjects == 1);
+	ref.Release();
+	TestEnsure(numObjects == 0 && weak.IsExpired());
+}
+
+// Compares the cost of creating and copying references to std::shared_ptr
+Test("Ref.Benchmark")
+{
+	const int32 numIterations = 1000000;
+	auto measure = [&](const char* name, auto&& func)
+	{
+		Timer timer;
+		for(int32 i = 0; i < numIterations; i++)
+			func(i);
+		Logf("%s: %.1f ns", Logger::Info, name, timer.SecondsAsDouble() * 1e9 / numIterations);
+	};
+
+	measure("Ref construction (MakeRef)", [](int32 i)
+	{
+		Ref<TestObject> ref = Utility::MakeRef(new TestObject(i));
+	});
+	measure("Ref construction (NewRef)", [](int32 i)
+	{
+		Ref<TestObject> ref = Utility::NewRef<TestObject>(i);
+	});
+	measure("std::shared_ptr construction (make_shared)", [](int32 i)
+	{
+		std::shared_ptr<TestObject> ptr = std::make_shared<TestObject>(i);
+	});
+
+	Ref<TestObject> ref = Utility::NewRef<TestObject>();
+	std::shared_ptr<TestObject> ptr = std::make_shared<TestObject>();
+	int32 sum = 0;
+	measure("Ref copy", [&](int32 i)
+	{
+		Ref<TestObject> copy = ref;
+		sum += copy->value;
+	});
+	measure("std::shared_ptr copy", [&](int32 i)
+	{
+		std::shared_ptr<TestObject> copy = ptr;
+		sum += copy->value;
+	});
+	TestEnsure(sum == 0);
+}
@@ -0,0 +1,54 @@
+#include <Shared/Shared.hpp>
+#include <Shared/ResourceManager.hpp>
+#include <Tests/Tests.hpp>
+
+static int32 numResources = 0;
+class TestResource
+{
+public:
+	TestResource() { numResources++; }
+	~TestResource() { numResources--; }
+};
+
+Test("ResourceManager.Incremental")
+{
+	numResources = 0;
+	ResourceManager<TestResource> manager;
+
+	// Keep every other resource
+	const size_t numObjects = 1000;
+	Vector<Ref<TestResource>> kept;
+	for(size_t i = 0; i < numObjects; i++)
+	{
+		Ref<TestResource> resource = manager.Register(new TestResource());
+		if(i % 2 == 0)
+			kept.Add(resource);
+	}
+	TestEnsure(manager.GetNumLive() == numObjects);
+
+	// Every call only checks a limited number of objects
+	size_t numCalls = 1;
+	while(!manager.GarbageCollect(100))
+		numCalls++;
+	TestEnsure(numCalls == numObjects / 100);
+
+	// Unused objects are only destroyed when releasing them
+	TestEnsure(numResources == numObjects);
+	manager.ReleaseUnused();
+	TestEnsure(numResources == numObjects / 2);
+	TestEnsure(manager.GetNumLive() == numObjects / 2 && manager.GetNumFreed() == numObjects / 2);
+
+	// Objects that are referenced again before being released are kept
+	WeakRef<TestResource> weak = kept[0];
+	kept.erase(kept.begin());
+	while(!manager.GarbageCollect(100))
+		;
+	Ref<TestResource> locked = weak.Lock();
+	manager.ReleaseUnused();
+	TestEnsure(locked.IsValid() && numResources == numObjects / 2);
+	TestEnsure(manager.GetNumLive() == numObjects / 2);
+
+	manager.ReleaseAll();
+	TestEnsure(numResources == 0 && manager.GetNumLive() == 0);
+	TestEnsure(!locked.IsValid() && !kept[0].IsValid());
+}
@@ -0,0 +1,128 @@
+#include <Shared/Shared.hpp>
+#include <Shared/TaskGraph.hpp>
+#include <Tests/Tests.hpp>
+
+Test("TaskGraph.Dependencies")
+{
+	JobSheduler sheduler;
+	TaskGraph graph(sheduler);
+
+	// Two tasks that depend on the same task, and a task on the main thread that combines their results
+	std::atomic<int32> step(0);
+	int32 parsed = 0, left = 0, right = 0, combined = 0;
+	std::thread::id mainThread = std::this_thread::get_id();
+	bool ranOnMainThread = false;
+	TaskGraph::Task parse = graph.Add([&]()
+	{
+		parsed = ++step;
+		return true;
+	});
+	TaskGraph::Task loadLeft = graph.Add([&]()
+	{
+		left = parsed + 10;
+		step++;
+		return true;
+	}, { parse });
+	TaskGraph::Task loadRight = graph.Add([&]()
+	{
+		right = parsed + 20;
+		step++;
+		return true;
+	}, { parse }, JobPriority::Interactive);
+	graph.AddOnMainThread([&]()
+	{
+		ranOnMainThread = std::this_thread::get_id() == mainThread;
+		combined = left + right;
+		return true;
+	}, { loadLeft, loadRight });
+
+	graph.Start();
+	TestEnsure(graph.Wait());
+	TestEnsure(graph.IsFinished() && graph.IsSuccessfull());
+	TestEnsure(step == 3 && parsed == 1 && combined == 32);
+	TestEnsure(ranOnMainThread);
+}
+
+Test("TaskGraph.Failure")
+{
+	JobSheduler sheduler;
+	TaskGraph graph(sheduler);
+
+	bool ranDependent = false;
+	TaskGraph::Task failing = graph.Add([]()
+	{
+		return false;
+	});
+	graph.Add([&]()
+	{
+		ranDependent = true;
+		return true;
+	}, { failing });
+
+	// Finished tasks are polled from the main thread
+	graph.Start();
+	while(!graph.Update())
+		std::this_thread::yield();
+	TestEnsure(graph.IsFinished() && !graph.IsSuccessfull());
+	TestEnsure(graph.GetCancellationToken().IsCancelled());
+	TestEnsure(!ranDependent);
+}
+
+Test("TaskGraph.ParallelFor")
+{
+	JobSheduler sheduler;
+
+	// Every item is visited once
+	const size_t numItems = 100000;
+	Vector<uint8> visited(numItems, 0);
+	std::atomic<size_t> numRanges(0);
+	ParallelFor(sheduler, 0, numItems, 1000, [&](size_t begin, size_t end)
+	{
+		TestEnsure(end - begin <= 1000);
+		for(size_t i = begin; i < end; i++)
+			visited[i]++;
+		numRanges++;
+	});
+	TestEnsure(numRanges == 100);
+	for(uint8 count : visited)
+		TestEnsure(count == 1);
+
+	// Remaining ranges are skipped after cancelling
+	CancellationToken cancellation;
+	std::atomic<size_t> numProcessed(0);
+	ParallelFor(sheduler, 0, numItems, 10, [&](size_t begin, size_t end)
+	{
+		numProcessed += end - begin;
+		cancellation.Cancel();
+	}, &cancellation);
+	TestEnsure(numProcessed > 0 && numProcessed < numItems);
+
+	// Empty ranges don't call the function
+	bool called = false;
+	ParallelFor(sheduler, 5, 5, 1, [&](size_t begin, size_t end)
+	{
+		called = true;
+	});
+	TestEnsure(!called);
+
+	// Called from a job while the main thread handles finished jobs, like the asset loader does
+	std::atomic<size_t> numNested(0);
+	Job outer = JobBase::CreateLambda([&]()
+	{
+		for(uint32 i = 0; i < 100; i++)
+		{
+			ParallelFor(sheduler, 0, 64, 1, [&](size_t begin, size_t end)
+			{
+				numNested += end - begin;
+			});
+		}
+		return true;
+	});
+	sheduler.Queue(outer);
+	while(!outer->IsFinished())
+	{
+		sheduler.Update();
+		std::this_thread::yield();
+	}
+	TestEnsure(numNested == 6400);
+}